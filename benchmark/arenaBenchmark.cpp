@@ -0,0 +1,172 @@
+/**
+ * @file
+ * @author Pavel Siska <siska@cesnet.cz>
+ * @brief Microbenchmark of reading aggregated files with and without the read arena
+ *
+ * Counts heap allocations of a read of an aggregated file (reading of source files,
+ * aggregation and conversion to text) with contents allocated from the heap and from
+ * a temporary arena.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <telemetry.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+// NOLINTBEGIN(misc-new-delete-overloads)
+static std::atomic<size_t> g_allocations = 0;
+
+void* operator new(size_t size)
+{
+	g_allocations.fetch_add(1, std::memory_order_relaxed);
+	if (void* ptr = std::malloc(size)) {
+		return ptr;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t /*size*/) noexcept
+{
+	std::free(ptr);
+}
+
+// Used by std::pmr::new_delete_resource()
+void* operator new(size_t size, std::align_val_t alignment)
+{
+	g_allocations.fetch_add(1, std::memory_order_relaxed);
+	const auto align = static_cast<size_t>(alignment);
+	if (void* ptr = std::aligned_alloc(align, (size + align - 1) / align * align)) {
+		return ptr;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void* ptr, std::align_val_t /*alignment*/) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t /*size*/, std::align_val_t /*alignment*/) noexcept
+{
+	std::free(ptr);
+}
+// NOLINTEND(misc-new-delete-overloads)
+
+using namespace telemetry;
+
+static constexpr size_t SOURCE_FILES = 16;
+static constexpr size_t DICT_KEYS = 100;
+
+static std::vector<AggOperation> createAggOperations()
+{
+	std::vector<AggOperation> ops;
+	for (size_t idx = 0; idx < DICT_KEYS; idx++) {
+		const std::string key = "counter_" + std::to_string(idx);
+		ops.push_back({AggMethodType::SUM, key, key});
+	}
+	return ops;
+}
+
+/**
+ * @brief Source files and a file aggregating them (directories keep only weak references).
+ */
+struct Tree {
+	std::shared_ptr<Directory> root;
+	std::shared_ptr<Directory> sources;
+	std::vector<std::shared_ptr<File>> files;
+	std::shared_ptr<AggregatedFile> aggregated;
+};
+
+static Tree createTree(const std::vector<DictKey>& keys, bool arena)
+{
+	Tree tree;
+	tree.root = Directory::create();
+	tree.sources = tree.root->addDir("sources");
+
+	for (size_t fileIdx = 0; fileIdx < SOURCE_FILES; fileIdx++) {
+		FileOps ops;
+		ops.readArena = arena;
+		ops.read = [&keys, fileIdx]() {
+			Dict dict;
+			dict.reserve(keys.size());
+			for (size_t idx = 0; idx < keys.size(); idx++) {
+				dict[keys[idx]] = Scalar {uint64_t {fileIdx * idx}};
+			}
+			return dict;
+		};
+		tree.files.push_back(tree.sources->addFile("file_" + std::to_string(fileIdx), ops));
+	}
+
+	tree.aggregated = tree.root->addAggFile("aggregated", "sources/file_.*", createAggOperations());
+	return tree;
+}
+
+template <typename Function>
+static void measure(const std::string& name, size_t iterations, Function&& function)
+{
+	const size_t allocationsBefore = g_allocations.load();
+	const auto start = std::chrono::steady_clock::now();
+
+	for (size_t idx = 0; idx < iterations; idx++) {
+		function();
+	}
+
+	const auto end = std::chrono::steady_clock::now();
+	const size_t allocations = g_allocations.load() - allocationsBefore;
+	const std::chrono::duration<double, std::micro> elapsed = end - start;
+
+	std::cout << std::fixed << std::setprecision(1);
+	std::cout << name << ": " << static_cast<double>(allocations) / static_cast<double>(iterations)
+			  << " allocations/read, " << elapsed.count() / static_cast<double>(iterations)
+			  << " us/read\n";
+}
+
+int main(int argc, char** argv)
+{
+	const size_t defaultIterations = 500;
+	const size_t iterations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : defaultIterations;
+
+	std::vector<DictKey> keys;
+	for (size_t idx = 0; idx < DICT_KEYS; idx++) {
+		keys.emplace_back("counter_" + std::to_string(idx));
+	}
+
+	const Tree heapTree = createTree(keys, false);
+	const Tree arenaTree = createTree(keys, true);
+
+	TextContentWriter writer;
+	std::string heapOutput;
+
+	// Without the arena, the content is read as an object allocated from the heap
+	measure("heap ", iterations, [&]() {
+		writer.clear();
+		writeContent(writer, heapTree.aggregated->read());
+	});
+	heapOutput = writer.str();
+
+	measure("arena", iterations, [&]() {
+		writer.clear();
+		arenaTree.aggregated->readTo(writer);
+	});
+
+	if (heapOutput.empty() || heapOutput != writer.str()) {
+		std::cerr << "Outputs of reads differ\n";
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
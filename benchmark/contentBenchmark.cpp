@@ -0,0 +1,235 @@
+/**
+ * @file
+ * @author Pavel Siska <siska@cesnet.cz>
+ * @brief Microbenchmark of conversion of telemetry content to string
+ *
+ * Compares the current formatter with the previous implementation based on string streams.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <telemetry.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace legacy {
+
+using namespace telemetry;
+
+template <typename... T>
+constexpr bool g_AlwaysFalse = false;
+
+static std::string scalarToString(const Scalar& scalar)
+{
+	auto converter = [](auto&& arg) -> std::string {
+		using T = std::decay_t<decltype(arg)>;
+
+		if constexpr (std::is_same_v<T, std::monostate>) {
+			return "<N/A>";
+		} else if constexpr (std::is_same_v<T, bool>) {
+			return arg ? "true" : "false";
+		} else if constexpr (std::is_same_v<T, uint64_t> || std::is_same_v<T, int64_t>) {
+			return std::to_string(arg);
+		} else if constexpr (std::is_same_v<T, double>) {
+			std::stringstream stream;
+			stream << std::fixed << std::setprecision(2) << arg;
+			return stream.str();
+		} else if constexpr (std::is_same_v<T, std::string>) {
+			return arg;
+		} else {
+			static_assert(g_AlwaysFalse<T>, "non-exhaustive visitor");
+		}
+	};
+
+	return std::visit(converter, scalar);
+}
+
+static std::string scalarWithUnitToString(const ScalarWithUnit& scalar)
+{
+	const auto& [value, unit] = scalar;
+	return scalarToString(value) + " (" + unit.str() + ")";
+}
+
+static std::string arrayToString(const Array& array)
+{
+	std::string result;
+	size_t cnt = 0;
+
+	result += '[';
+
+	for (const auto& elem : array) {
+		if (cnt > 0) {
+			result += ", ";
+		}
+
+		result += scalarToString(elem);
+		cnt++;
+	}
+
+	result += ']';
+	return result;
+}
+
+static std::string dictValueToString(const DictValue& value)
+{
+	auto converter = [](auto&& arg) -> std::string {
+		using T = std::decay_t<decltype(arg)>;
+
+		if constexpr (std::is_same_v<T, std::monostate>) {
+			return "<N/A>";
+		} else if constexpr (std::is_same_v<T, Scalar>) {
+			return scalarToString(arg);
+		} else if constexpr (std::is_same_v<T, ScalarWithUnit>) {
+			return scalarWithUnitToString(arg);
+		} else if constexpr (std::is_same_v<T, Array>) {
+			return arrayToString(arg);
+		} else {
+			static_assert(g_AlwaysFalse<T>, "non-exhaustive visitor");
+		}
+	};
+
+	return std::visit(converter, value);
+}
+
+static std::string dictToString(const Dict& dict)
+{
+	std::stringstream result;
+	size_t maxKeyLen = 0;
+	size_t cnt = 0;
+
+	for (const auto& [key, _] : dict) {
+		maxKeyLen = std::max(maxKeyLen, key.length());
+	}
+
+	for (const auto& [key, value] : dict) {
+		const int extraSpaces = static_cast<int>(maxKeyLen - key.length());
+
+		if (cnt > 0) {
+			result << '\n';
+		}
+
+		result << key;
+		result << std::left << std::setw(2 + extraSpaces) << ':';
+		result << dictValueToString(value);
+
+		cnt++;
+	}
+
+	return result.str();
+}
+
+static std::string contentToString(const Content& content)
+{
+	auto converter = [](auto&& arg) -> std::string {
+		using T = std::decay_t<decltype(arg)>;
+
+		if constexpr (std::is_same_v<T, Scalar>) {
+			return scalarToString(arg);
+		} else if constexpr (std::is_same_v<T, ScalarWithUnit>) {
+			return scalarWithUnitToString(arg);
+		} else if constexpr (std::is_same_v<T, Array>) {
+			return arrayToString(arg);
+		} else if constexpr (std::is_same_v<T, Dict>) {
+			return dictToString(arg);
+		} else {
+			// Content types added later had no legacy formatting
+			return telemetry::contentToString(arg);
+		}
+	};
+
+	return std::visit(converter, content);
+}
+
+} // namespace legacy
+
+using namespace telemetry;
+
+static Content createStatsDict()
+{
+	Dict dict;
+
+	for (uint64_t idx = 0; idx < 16; idx++) {
+		const std::string prefix = "queue_" + std::to_string(idx);
+		dict[prefix + "_packets"] = Scalar {idx * 123456789};
+		dict[prefix + "_bytes"] = ScalarWithUnit {Scalar {idx * 987654321}, "B"};
+		dict[prefix + "_load"] = ScalarWithUnit {Scalar {static_cast<double>(idx) * 1.337}, "%"};
+	}
+
+	dict["state"] = Scalar {std::string("running")};
+	dict["enabled"] = Scalar {true};
+	dict["unknown"] = std::monostate {};
+	return dict;
+}
+
+static Content createDoubleArray()
+{
+	Array array;
+
+	for (int idx = 0; idx < 256; idx++) {
+		array.emplace_back(static_cast<double>(idx) * 3.14159 - 100.0);
+	}
+
+	return array;
+}
+
+template <typename Function>
+static double measure(size_t iterations, Function&& function)
+{
+	const auto start = std::chrono::steady_clock::now();
+	for (size_t idx = 0; idx < iterations; idx++) {
+		function();
+	}
+	const auto end = std::chrono::steady_clock::now();
+
+	const std::chrono::duration<double, std::nano> elapsed = end - start;
+	return elapsed.count() / static_cast<double>(iterations);
+}
+
+static bool benchmark(const std::string& name, const Content& content, size_t iterations)
+{
+	if (legacy::contentToString(content) != contentToString(content)) {
+		std::cerr << name << ": output differs from the legacy implementation\n";
+		return false;
+	}
+
+	size_t checksum = 0;
+	std::string buffer;
+
+	const double legacyTime
+		= measure(iterations, [&]() { checksum += legacy::contentToString(content).size(); });
+	const double currentTime
+		= measure(iterations, [&]() { checksum += contentToString(content).size(); });
+	const double appendTime = measure(iterations, [&]() {
+		buffer.clear();
+		appendContentToString(buffer, content);
+		checksum += buffer.size();
+	});
+
+	std::cout << std::fixed << std::setprecision(1);
+	std::cout << name << " (checksum " << checksum << ")\n";
+	std::cout << "  legacy contentToString:        " << legacyTime << " ns/op\n";
+	std::cout << "  contentToString:               " << currentTime << " ns/op\n";
+	std::cout << "  appendContentToString (reuse): " << appendTime << " ns/op\n";
+	return true;
+}
+
+int main(int argc, char** argv)
+{
+	const size_t defaultIterations = 20000;
+	const size_t iterations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : defaultIterations;
+
+	bool success = true;
+	success &= benchmark("dict", createStatsDict(), iterations);
+	success &= benchmark("array of doubles", createDoubleArray(), iterations);
+	success &= benchmark("scalar with unit", ScalarWithUnit {Scalar {42.4242}, "ms"}, iterations);
+
+	return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
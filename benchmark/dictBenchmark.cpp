@@ -0,0 +1,100 @@
+/**
+ * @file
+ * @author Pavel Siska <siska@cesnet.cz>
+ * @brief Microbenchmark of building and lookup of telemetry dictionaries
+ *
+ * Compares the telemetry dictionary with std::map, which was used as the dictionary before.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <telemetry.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace telemetry;
+
+template <typename Function>
+static double measure(size_t iterations, Function&& function)
+{
+	const auto start = std::chrono::steady_clock::now();
+	for (size_t idx = 0; idx < iterations; idx++) {
+		function();
+	}
+	const auto end = std::chrono::steady_clock::now();
+
+	const std::chrono::duration<double, std::nano> elapsed = end - start;
+	return elapsed.count() / static_cast<double>(iterations);
+}
+
+template <typename DictType>
+static DictType buildDict(const std::vector<std::string>& keys)
+{
+	DictType dict;
+
+	uint64_t value = 0;
+	for (const auto& key : keys) {
+		dict[key] = Scalar {value++};
+	}
+
+	return dict;
+}
+
+template <typename DictType>
+static size_t lookupDict(const DictType& dict, const std::vector<std::string>& keys)
+{
+	size_t found = 0;
+	for (const auto& key : keys) {
+		found += dict.count(key);
+	}
+	return found;
+}
+
+static void benchmark(size_t keyCount, size_t iterations)
+{
+	std::vector<std::string> keys;
+	for (size_t idx = 0; idx < keyCount; idx++) {
+		keys.push_back("statistics_counter_" + std::to_string(idx));
+	}
+
+	using MapDict = std::map<DictKey, DictValue>;
+	size_t checksum = 0;
+
+	const double mapBuild
+		= measure(iterations, [&]() { checksum += buildDict<MapDict>(keys).size(); });
+	const double flatBuild
+		= measure(iterations, [&]() { checksum += buildDict<Dict>(keys).size(); });
+
+	const auto mapDict = buildDict<MapDict>(keys);
+	const auto flatDict = buildDict<Dict>(keys);
+	const double mapLookup
+		= measure(iterations, [&]() { checksum += lookupDict(mapDict, keys); });
+	const double flatLookup
+		= measure(iterations, [&]() { checksum += lookupDict(flatDict, keys); });
+
+	std::cout << std::fixed << std::setprecision(1);
+	std::cout << keyCount << " keys (checksum " << checksum << ")\n";
+	std::cout << "  std::map build and destroy: " << mapBuild << " ns/op\n";
+	std::cout << "  Dict build and destroy:     " << flatBuild << " ns/op\n";
+	std::cout << "  std::map lookup of all:     " << mapLookup << " ns/op\n";
+	std::cout << "  Dict lookup of all:         " << flatLookup << " ns/op\n";
+}
+
+int main(int argc, char** argv)
+{
+	const size_t defaultIterations = 2000;
+	const size_t iterations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : defaultIterations;
+
+	for (const size_t keyCount : {size_t {50}, size_t {300}}) {
+		benchmark(keyCount, iterations);
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -63,6 +63,13 @@ void DataCenter::addServer(Server server)
 	m_servers.emplace_back(std::move(server));
 }
 
+void DataCenter::updateServers()
+{
+	for (auto& server : m_servers) {
+		server.updateTelemetry();
+	}
+}
+
 /**
  * @brief Sets up telemetry reporting for the data center.
  *
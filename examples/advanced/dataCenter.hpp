@@ -56,6 +56,11 @@ public:
 	 */
 	void addServer(Server server);
 
+	/**
+	 * @brief Updates telemetry data of all servers in the data center.
+	 */
+	void updateServers();
+
 private:
 	/**
 	 * @brief Sets up telemetry reporting for the data center.
@@ -150,6 +150,9 @@ int main(int argc, char** argv)
 		appFs->start();
 
 		while (!g_stopFlag.load()) {
+			for (auto& dataCenter : dataCenters) {
+				dataCenter.updateServers();
+			}
 			std::this_thread::sleep_for(std::chrono::seconds(1));
 		}
 
@@ -10,7 +10,7 @@
  *
  * The `Server` class allows tracking of various performance metrics such as CPU usage, memory
  * usage, latency, and disk usage. It utilizes the `ServerTelemetry` struct to hold the telemetry
- * data and interacts with the telemetry system to store and update this information.
+ * data and publishes its snapshots to the telemetry system, so reads never block updates.
  *
  * @copyright Copyright (c) 2024 CESNET, z.s.p.o.
  */
@@ -78,12 +78,21 @@ static ServerTelemetry generateServerTelemetry()
  */
 static telemetry::Dict getServerTelemetry(const ServerTelemetry& telemetry)
 {
+	// Keys and units are interned only once, the function then just copies the handles
+	static const telemetry::DictKey cpuUsageKey("cpu_usage");
+	static const telemetry::DictKey memoryUsageKey("memory_usage");
+	static const telemetry::DictKey latencyKey("latency");
+	static const telemetry::DictKey diskUsageKey("disk_usage");
+	static const telemetry::DictKey timestampKey("timestamp");
+	static const telemetry::Unit percentUnit("%");
+	static const telemetry::Unit millisecondsUnit("ms");
+
 	telemetry::Dict dict;
-	dict["cpu_usage"] = telemetry::ScalarWithUnit {telemetry.cpuUsage, "%"};
-	dict["memory_usage"] = telemetry::ScalarWithUnit {telemetry.memoryUsage, "%"};
-	dict["latency"] = telemetry::ScalarWithUnit {telemetry.latency, "ms"};
-	dict["disk_usage"] = telemetry::ScalarWithUnit {telemetry.diskUsage, "%"};
-	dict["timestamp"] = timePointToString(telemetry.timestamp);
+	dict[cpuUsageKey] = telemetry::ScalarWithUnit {telemetry.cpuUsage, percentUnit};
+	dict[memoryUsageKey] = telemetry::ScalarWithUnit {telemetry.memoryUsage, percentUnit};
+	dict[latencyKey] = telemetry::ScalarWithUnit {telemetry.latency, millisecondsUnit};
+	dict[diskUsageKey] = telemetry::ScalarWithUnit {telemetry.diskUsage, percentUnit};
+	dict[timestampKey] = timePointToString(telemetry.timestamp);
 	return dict;
 }
 
@@ -100,25 +109,23 @@ std::string Server::getId() const
 /**
  * @brief Sets up telemetry for the server and adds a telemetry file to the directory.
  *
- * This function generates random telemetry data and sets up a file in the provided directory
- * to report the telemetry stats.
+ * This function sets up a file in the provided directory to report the telemetry stats. The file
+ * reads snapshots of the data published by `updateTelemetry()`.
  *
  * @param serverDir A shared pointer to a telemetry directory where the telemetry data will be
  * stored.
  */
 void Server::setupTelemetry(std::shared_ptr<telemetry::Directory>& serverDir)
 {
-	const auto statsFile = serverDir->addFile(
-		"stats",
-		{
-			[this]() {
-				m_telemetry = generateServerTelemetry();
-				return getServerTelemetry(m_telemetry);
-			},
-			nullptr,
-		});
+	const auto statsFile
+		= serverDir->addFile("stats", telemetry::snapshotFileOps(m_telemetry, getServerTelemetry));
 
 	m_holder.add(statsFile);
 }
 
+void Server::updateTelemetry()
+{
+	m_telemetry->publish(generateServerTelemetry());
+}
+
 } // namespace telemetry::example
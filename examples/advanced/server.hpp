@@ -62,6 +62,13 @@ public:
 	 */
 	void setupTelemetry(std::shared_ptr<telemetry::Directory>& serverDir);
 
+	/**
+	 * @brief Collects new telemetry data and publishes it to telemetry reads.
+	 *
+	 * Reads of the telemetry file never block the update, they return the last published data.
+	 */
+	void updateTelemetry();
+
 	/**
 	 * @brief Gets the server's unique identifier.
 	 *
@@ -71,7 +78,8 @@ public:
 
 private:
 	std::string m_serverId; //< Unique identifier for the server.
-	ServerTelemetry m_telemetry = {}; //< Holds the server's telemetry data.
+	std::shared_ptr<telemetry::SnapshotPublisher<ServerTelemetry>> m_telemetry
+		= std::make_shared<telemetry::SnapshotPublisher<ServerTelemetry>>(); //< Published data.
 	telemetry::Holder m_holder; //< Telemetry holder for managing telemetry data files.
 };
 
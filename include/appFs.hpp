@@ -8,14 +8,57 @@
 
 #pragma once
 
+#include <cstdint>
 #include <fuse3/fuse.h>
+#include <fuse3/fuse_lowlevel.h>
 #include <memory>
 #include <string>
 #include <telemetry.hpp>
 #include <thread>
+#include <vector>
 
 namespace telemetry::appFs {
 
+/**
+ * @brief Strategy used to report the size of telemetry files.
+ *
+ * The size of a telemetry file is not known until its content is rendered. Since getattr is
+ * called very often (e.g. by `ls -l`, `stat` or before each `open`), rendering the content there
+ * executes the read callback of the file more often than necessary.
+ */
+enum class FileSizeMode : uint8_t {
+	/**
+	 * The content of the file is rendered to estimate its size. The reported size is accurate,
+	 * but the read callback is executed on every getattr.
+	 */
+	RENDER,
+	/**
+	 * The size is reported as zero and files are opened in direct I/O mode, so the content is
+	 * read until EOF regardless of the reported size. The read callback is never executed by
+	 * getattr.
+	 */
+	DIRECT_IO,
+};
+
+/**
+ * @brief FUSE API used to serve the filesystem.
+ */
+enum class FuseBackend : uint8_t {
+	/**
+	 * High-level FUSE API. Every request contains a path of the node, which is resolved by
+	 * walking the telemetry tree from the root directory.
+	 */
+	PATH,
+	/**
+	 * Low-level FUSE API. Nodes are identified by inode numbers assigned on lookup, so all
+	 * following requests resolve the node in constant time. Recommended for deep trees that
+	 * are accessed very often.
+	 */
+	INODE,
+};
+
+struct AppFsContext;
+
 /**
  * @brief The AppFsFuse class for managing FUSE filesystem.
  */
@@ -31,27 +74,35 @@ public:
 	 * @param tryToUnmountOnStart Whether to attempt unmounting the mount point if it's already
 	 * mounted.
 	 * @param createMountPoint Whether to create the mount point directory if it doesn't exist.
+	 * @param fileSizeMode Strategy used to report the size of telemetry files.
+	 * @param threadCount Number of threads processing FUSE requests. Requests are served
+	 * concurrently, so a slow read callback of one file doesn't block readers of other files.
+	 * @param backend FUSE API used to serve the filesystem.
 	 *
 	 * @throws std::runtime_error if rootDirectory is nullptr.
+	 * @throws std::runtime_error if threadCount is zero.
 	 * @throws std::runtime_error if setup and mount process fails.
 	 */
 	AppFsFuse(
 		std::shared_ptr<Directory> rootDirectory,
 		const std::string& mountPoint,
 		bool tryToUnmountOnStart = true,
-		bool createMountPoint = false);
+		bool createMountPoint = false,
+		FileSizeMode fileSizeMode = FileSizeMode::RENDER,
+		size_t threadCount = 1,
+		FuseBackend backend = FuseBackend::PATH);
 
 	/**
-	 * @brief Creates a new thread to run the FUSE event loop.
+	 * @brief Creates new threads to run the FUSE event loop.
 	 *
-	 * After the thread is created, you can access the FUSE filesystem through the mount point.
+	 * After the threads are created, you can access the FUSE filesystem through the mount point.
 	 *
-	 * @throws std::runtime_error if the FUSE thread is already running.
+	 * @throws std::runtime_error if the FUSE threads are already running.
 	 */
 	void start();
 
 	/**
-	 * @brief Unmount the FUSE filesystem and join the FUSE thread.
+	 * @brief Unmount the FUSE filesystem and join the FUSE threads.
 	 *
 	 * @note It's not possible to start the FUSE filesystem again after calling this method.
 	 * If needed, a new instance of the class must be created.
@@ -65,11 +116,16 @@ public:
 
 private:
 	void unmount();
+	struct fuse_session* getSession();
 
+	std::unique_ptr<AppFsContext> m_context;
 	std::unique_ptr<struct fuse, decltype(&fuse_destroy)> m_fuse {nullptr, &fuse_destroy};
-	std::shared_ptr<Directory> m_rootDirectory;
+	std::unique_ptr<struct fuse_session, decltype(&fuse_session_destroy)> m_session {
+		nullptr,
+		&fuse_session_destroy};
+	size_t m_threadCount;
 	bool m_isStarted = false;
-	std::thread m_fuseThread;
+	std::vector<std::thread> m_fuseThreads;
 };
 
 } // namespace telemetry::appFs
@@ -11,8 +11,25 @@
 #include <telemetry/aggFile.hpp>
 #include <telemetry/aggMethod.hpp>
 #include <telemetry/content.hpp>
+#include <telemetry/contentAllocator.hpp>
+#include <telemetry/contentCodec.hpp>
+#include <telemetry/contentDelta.hpp>
+#include <telemetry/contentHash.hpp>
+#include <telemetry/contentWriter.hpp>
 #include <telemetry/directory.hpp>
 #include <telemetry/file.hpp>
+#include <telemetry/flatDict.hpp>
+#include <telemetry/histogram.hpp>
 #include <telemetry/holder.hpp>
+#include <telemetry/hyperLogLog.hpp>
+#include <telemetry/influxExporter.hpp>
+#include <telemetry/jsonExporter.hpp>
 #include <telemetry/node.hpp>
+#include <telemetry/openMetricsExporter.hpp>
+#include <telemetry/quantileSketch.hpp>
+#include <telemetry/shardedCounter.hpp>
+#include <telemetry/snapshotPublisher.hpp>
+#include <telemetry/symbol.hpp>
+#include <telemetry/table.hpp>
+#include <telemetry/topK.hpp>
 #include <telemetry/utility.hpp>
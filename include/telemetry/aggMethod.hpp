@@ -19,14 +19,24 @@ namespace telemetry {
  * @brief Supported aggregation methods.
  *
  * Supported methods and types:
- * - @p AVG: Scalar(WithUnit) value, [uint64_t, int64_t, double] -> result double
- * - @p SUM: Scalar(WithUnit) value, [uint64_t, int64_t, double]
- * - @p MIN: Scalar(WithUnit) value, [uint64_t, int64_t, double]
- * - @p MAX: Scalar(WithUnit) value, [uint64_t, int64_t, double]
+ * - @p AVG: Scalar(WithUnit) or Array value, [uint64_t, int64_t, double] -> result double
+ * - @p SUM: Scalar(WithUnit) or Array value, [uint64_t, int64_t, double]
+ * - @p MIN: Scalar(WithUnit) or Array value, [uint64_t, int64_t, double]
+ * - @p MAX: Scalar(WithUnit) or Array value, [uint64_t, int64_t, double]
  * - @p JOIN: Scalar value (array included), [bool, uint64_t, int64_t, double, string,
  * std::monostate()]
+ * - @p MERGE: Histogram of the same unit and precision -> bucket-wise merged histogram,
+ *   QuantileSketch of the same unit and relative accuracy -> merged sketch,
+ *   HyperLogLog of the same precision -> union of registers,
+ *   TopK of the same capacity -> top-K summary of keys of all summaries
+ * - @p QUANTILES: Histogram or QuantileSketch as for MERGE -> Dict of values at quantiles
+ *   of the merged histogram or sketch (see AggOperation::quantiles)
+ *
+ * Arrays are aggregated over all their elements (e.g. SUM of arrays is the sum of all elements
+ * of all arrays). A column of a table is aggregated as an array of its values, the name
+ * of the column is given as the dictionary field name (units of columns are not kept).
  */
-enum class AggMethodType : uint8_t { AVG, SUM, MIN, MAX, JOIN };
+enum class AggMethodType : uint8_t { AVG, SUM, MIN, MAX, JOIN, MERGE, QUANTILES };
 
 /**
  * @brief Structure representing an aggregation operation
@@ -42,6 +52,9 @@ struct AggOperation {
 	std::string dictFieldName = ""; ///< Name of the field in the dictionary
 	// NOLINTNEXTLINE(readability-redundant-string-init)
 	std::string dictResultName = ""; ///< Name of the field in the aggregated dictionary
+	/// Quantiles reported by the QUANTILES method, e.g. 0.99 is reported as "p99"
+	/// (p50, p99 and p999 if empty)
+	std::vector<double> quantiles = {};
 };
 
 /** @brief Value used as a aggregationFile content. */
@@ -82,11 +95,12 @@ public:
 protected:
 	AggContent getAggContent(const Content& content, bool useDictResultName = false);
 
-	[[nodiscard]] std::string getDictResultName() const { return m_dictResultname; }
+	[[nodiscard]] const DictKey& getDictResultName() const { return m_dictResultname; }
 
 private:
-	std::string m_dictFieldName;
-	std::string m_dictResultname;
+	// Interned once, so lookups in aggregated dictionaries compare symbols
+	DictKey m_dictFieldName;
+	DictKey m_dictResultname;
 };
 
 } // namespace telemetry
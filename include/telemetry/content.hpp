@@ -8,8 +8,16 @@
 
 #pragma once
 
+#include "contentAllocator.hpp"
+#include "flatDict.hpp"
+#include "histogram.hpp"
+#include "hyperLogLog.hpp"
+#include "quantileSketch.hpp"
+#include "symbol.hpp"
+#include "table.hpp"
+#include "topK.hpp"
+
 #include <cstdint>
-#include <map>
 #include <string>
 #include <utility>
 #include <variant>
@@ -19,18 +27,41 @@ namespace telemetry {
 
 /** @brief Scalar type returned by file read operations. */
 using Scalar = std::variant<std::monostate, bool, uint64_t, int64_t, double, std::string>;
+/** @brief Unit of a scalar value (interned string). */
+using Unit = Symbol;
 /** @brief Scalar type with unit (useful for numeric types). */
-using ScalarWithUnit = std::pair<Scalar, std::string>;
-/** @brief Array type returned by file read operations. */
-using Array = std::vector<Scalar>;
-/** @brief Dictionary key used as a part of file read operations. */
-using DictKey = std::string;
+using ScalarWithUnit = std::pair<Scalar, Unit>;
+/**
+ * @brief Array type returned by file read operations.
+ *
+ * Allocates from the content memory resource of the creating thread (see ContentResourceScope).
+ */
+using Array = std::vector<Scalar, ContentAllocator<Scalar>>;
+/** @brief Dictionary key (interned string) used as a part of file read operations. */
+using DictKey = Symbol;
 /** @brief Dictionary value used as a part of file read operations. */
 using DictValue = std::variant<std::monostate, Scalar, ScalarWithUnit, Array>;
-/** @brief Dictionary type used by file read operations. */
-using Dict = std::map<DictKey, DictValue>;
-/** @brief Output of file read operation can be a scalar, an array, or a dictionary. */
-using Content = std::variant<Scalar, ScalarWithUnit, Array, Dict>;
+/**
+ * @brief Dictionary type (sorted by keys) used by file read operations.
+ *
+ * Allocates from the content memory resource of the creating thread (see ContentResourceScope).
+ */
+using Dict
+	= FlatDict<DictKey, DictValue, std::less<>, ContentAllocator<std::pair<DictKey, DictValue>>>;
+/**
+ * @brief Output of file read operation can be a scalar, an array, a dictionary, a table,
+ * a histogram, a quantile sketch, a HyperLogLog or a top-K summary.
+ */
+using Content = std::variant<
+	Scalar,
+	ScalarWithUnit,
+	Array,
+	Dict,
+	Table,
+	Histogram,
+	QuantileSketch,
+	HyperLogLog,
+	TopK>;
 
 /**
  * @brief Convert telemetry @p content to human readable string.
@@ -40,4 +71,15 @@ using Content = std::variant<Scalar, ScalarWithUnit, Array, Dict>;
  */
 std::string contentToString(const Content& content);
 
+/**
+ * @brief Append human readable string of telemetry @p content to the @p output.
+ *
+ * The output is the same as the output of contentToString(). Existing capacity of the
+ * output buffer is reused, so a buffer reserved or reused by the caller avoids allocations.
+ *
+ * @param output Output buffer
+ * @param content Telemetry content
+ */
+void appendContentToString(std::string& output, const Content& content);
+
 } // namespace telemetry
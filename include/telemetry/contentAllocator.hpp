@@ -0,0 +1,113 @@
+/**
+ * @file
+ * @author Pavel Siska <siska@cesnet.cz>
+ * @brief Memory resource used by telemetry content containers
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <memory_resource>
+#include <new>
+#include <type_traits>
+
+namespace telemetry {
+
+/**
+ * @brief Get the memory resource used by content containers created by the calling thread.
+ *
+ * It is the resource of the innermost ContentResourceScope of the thread, or the default
+ * memory resource (std::pmr::get_default_resource()) if there is no scope.
+ */
+std::pmr::memory_resource* getContentResource() noexcept;
+
+/**
+ * @brief Scope in which new content containers of the calling thread allocate from a resource.
+ *
+ * Dictionaries and arrays (Dict, Array) created within the scope allocate their memory from
+ * the given resource, e.g. from a std::pmr::monotonic_buffer_resource that is released at once
+ * when the content is no longer needed. Scopes can be nested, the previous resource is
+ * restored when the scope is destroyed.
+ *
+ * @warning Content created within the scope must not outlive the resource. Content copied
+ *   outside of any scope allocates from the default resource and is always safe to keep.
+ */
+class ContentResourceScope {
+public:
+	/**
+	 * @brief Use the @p resource for content containers created by the calling thread.
+	 * @param resource Memory resource (nullptr for the default resource)
+	 */
+	explicit ContentResourceScope(std::pmr::memory_resource* resource) noexcept;
+	~ContentResourceScope();
+
+	ContentResourceScope(const ContentResourceScope& other) = delete;
+	ContentResourceScope& operator=(const ContentResourceScope& other) = delete;
+	ContentResourceScope(ContentResourceScope&& other) = delete;
+	ContentResourceScope& operator=(ContentResourceScope&& other) = delete;
+
+private:
+	std::pmr::memory_resource* m_previous;
+};
+
+/**
+ * @brief Allocator of content containers.
+ *
+ * The allocator uses the memory resource of the calling thread at the time of its creation
+ * (see ContentResourceScope). A copy of a container uses the resource of the thread that makes
+ * the copy, and the resource is never propagated by copy or move assignment, so storing
+ * content in an existing container never makes it depend on a temporary resource.
+ *
+ * @tparam T Allocated type
+ */
+template <typename T>
+class ContentAllocator {
+public:
+	using value_type = T;
+	using propagate_on_container_copy_assignment = std::false_type;
+	using propagate_on_container_move_assignment = std::false_type;
+	using propagate_on_container_swap = std::true_type;
+	using is_always_equal = std::false_type;
+
+	ContentAllocator() noexcept
+		: m_resource(getContentResource())
+	{
+	}
+
+	template <typename U>
+	ContentAllocator(const ContentAllocator<U>& other) noexcept
+		: m_resource(other.resource())
+	{
+	}
+
+	T* allocate(size_t count)
+	{
+		if (count > std::numeric_limits<size_t>::max() / sizeof(T)) {
+			throw std::bad_array_new_length();
+		}
+		return static_cast<T*>(m_resource->allocate(count * sizeof(T), alignof(T)));
+	}
+
+	void deallocate(T* ptr, size_t count) noexcept
+	{
+		m_resource->deallocate(ptr, count * sizeof(T), alignof(T));
+	}
+
+	ContentAllocator select_on_container_copy_construction() const noexcept { return {}; }
+
+	[[nodiscard]] std::pmr::memory_resource* resource() const noexcept { return m_resource; }
+
+	template <typename U>
+	friend bool operator==(const ContentAllocator& lhs, const ContentAllocator<U>& rhs) noexcept
+	{
+		return lhs.resource() == rhs.resource() || lhs.resource()->is_equal(*rhs.resource());
+	}
+
+private:
+	std::pmr::memory_resource* m_resource;
+};
+
+} // namespace telemetry
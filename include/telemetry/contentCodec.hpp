@@ -0,0 +1,106 @@
+/**
+ * @file
+ * @author Pavel Siska <siska@cesnet.cz>
+ * @brief Compact binary encoding of telemetry content
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#pragma once
+
+#include "content.hpp"
+#include "contentWriter.hpp"
+
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace telemetry {
+
+/** @brief Version of the binary encoding produced by the encoder. */
+inline constexpr uint8_t CONTENT_CODEC_VERSION = 1;
+
+/**
+ * @brief Writer that encodes content to the compact binary format.
+ *
+ * The encoding starts with a header (magic bytes and the version) followed by a stream
+ * of tagged items in the order of writer calls. Integers are stored as variable length
+ * integers, floating point numbers as little-endian IEEE 754 doubles and strings with their
+ * length, so the encoding doesn't depend on the platform.
+ *
+ * The writer doesn't validate the shape of the content, the producer must follow the rules
+ * of ContentWriter. The buffer keeps its capacity between uses.
+ */
+class BinaryContentWriter : public ContentWriter {
+public:
+	using ContentWriter::value;
+
+	BinaryContentWriter();
+
+	void beginDict() override;
+	void key(std::string_view key) override;
+	void endDict() override;
+	void beginArray() override;
+	void endArray() override;
+	void unit(std::string_view unit) override;
+	void value(std::monostate) override;
+	void value(bool value) override;
+	void value(uint64_t value) override;
+	void value(int64_t value) override;
+	void value(double value) override;
+	void value(std::string_view value) override;
+	void table(const Table& table) override;
+	void histogram(const Histogram& histogram) override;
+	void quantileSketch(const QuantileSketch& sketch) override;
+	void hyperLogLog(const HyperLogLog& hyperLogLog) override;
+	void topK(const TopK& topK) override;
+
+	/**
+	 * @brief Get the encoded content.
+	 * @return Encoded content (valid until the writer is modified).
+	 */
+	[[nodiscard]] const std::vector<uint8_t>& data() const noexcept { return m_data; }
+
+	/** @brief Discard the encoded content (capacity is kept). */
+	void clear();
+
+private:
+	std::vector<uint8_t> m_data;
+};
+
+/**
+ * @brief Encode telemetry @p content to the compact binary format.
+ *
+ * @param content Telemetry content
+ * @return Encoded content
+ */
+std::vector<uint8_t> encodeContent(const Content& content);
+
+/**
+ * @brief Decode telemetry content from the compact binary format.
+ *
+ * Unknown values (N/A) of dictionaries are decoded as unknown scalars. Keys and units are
+ * interned (see Symbol), so only data from trusted producers should be decoded.
+ *
+ * @param data Encoded content
+ * @return Decoded content
+ * @throw TelemetryException if the data are not a valid encoding of content.
+ */
+Content decodeContent(std::span<const uint8_t> data);
+
+/**
+ * @brief Walk the encoded content without materializing it.
+ *
+ * The content is written piece by piece to the @p writer. String views passed to the writer
+ * (keys, units and string values) point directly into the @p data. The encoding is validated
+ * while walking, so the writer might receive a part of the content before an error is found.
+ * Only tables are materialized, each table is decoded as a whole and passed to the writer.
+ *
+ * @param data Encoded content
+ * @param writer Content writer
+ * @throw TelemetryException if the data are not a valid encoding of content.
+ */
+void decodeContent(std::span<const uint8_t> data, ContentWriter& writer);
+
+} // namespace telemetry
@@ -0,0 +1,61 @@
+/**
+ * @file
+ * @author Pavel Siska <siska@cesnet.cz>
+ * @brief Delta encoding of successive snapshots of telemetry content
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#pragma once
+
+#include "content.hpp"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace telemetry {
+
+/** @brief Version of the delta encoding produced by the encoder. */
+inline constexpr uint8_t CONTENT_DELTA_VERSION = 1;
+
+/**
+ * @brief Encode changes between two snapshots of telemetry content.
+ *
+ * The delta contains only what is needed to rebuild the @p current content from the
+ * @p previous one:
+ * - only added, removed and changed keys of dictionaries,
+ * - only changed and added elements of arrays (and the new size of the array),
+ * - differences of numbers of the same type (differences of integers and XOR of binary
+ *   representations of doubles stored as variable length integers), so values that change
+ *   little take only a few bytes,
+ * - values whose type has changed are stored in full (as in the binary content encoding).
+ *
+ * @param previous Previous snapshot of the content
+ * @param current Current snapshot of the content
+ * @return Encoded delta
+ */
+std::vector<uint8_t> encodeContentDelta(const Content& previous, const Content& current);
+
+/**
+ * @brief Encode changes between an encoded snapshot and the current content.
+ *
+ * @param previous Previous snapshot encoded by encodeContent()
+ * @param current Current snapshot of the content
+ * @return Encoded delta
+ * @throw TelemetryException if the @p previous is not a valid encoding of content.
+ */
+std::vector<uint8_t>
+encodeContentDelta(std::span<const uint8_t> previous, const Content& current);
+
+/**
+ * @brief Rebuild the current content from the previous one and the delta.
+ *
+ * @param previous Previous snapshot of the content (the same as used for the encoding)
+ * @param delta Delta produced by encodeContentDelta()
+ * @return Current snapshot of the content
+ * @throw TelemetryException if the delta is not valid or doesn't match the @p previous.
+ */
+Content applyContentDelta(const Content& previous, std::span<const uint8_t> delta);
+
+} // namespace telemetry
@@ -0,0 +1,91 @@
+/**
+ * @file
+ * @author Pavel Siska <siska@cesnet.cz>
+ * @brief Hashing of telemetry content
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#pragma once
+
+#include "content.hpp"
+#include "contentWriter.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace telemetry {
+
+/**
+ * @brief Writer that computes a hash of the written content.
+ *
+ * The hash is the XXH64 hash (with seed 0) of the binary encoding of the content
+ * (see encodeContent()), computed in a streaming fashion without building the encoding.
+ * It is stable across processes, platforms and versions of the library that use the same
+ * version of the binary encoding, so it can be stored or sent to detect changes of content.
+ */
+class ContentHasher : public ContentWriter {
+public:
+	using ContentWriter::value;
+
+	ContentHasher();
+
+	void beginDict() override;
+	void key(std::string_view key) override;
+	void endDict() override;
+	void beginArray() override;
+	void endArray() override;
+	void unit(std::string_view unit) override;
+	void value(std::monostate) override;
+	void value(bool value) override;
+	void value(uint64_t value) override;
+	void value(int64_t value) override;
+	void value(double value) override;
+	void value(std::string_view value) override;
+	void table(const Table& table) override;
+	void histogram(const Histogram& histogram) override;
+	void quantileSketch(const QuantileSketch& sketch) override;
+	void hyperLogLog(const HyperLogLog& hyperLogLog) override;
+	void topK(const TopK& topK) override;
+
+	/**
+	 * @brief Get the hash of the content written so far.
+	 * @return 64-bit hash
+	 */
+	[[nodiscard]] uint64_t digest() const noexcept;
+
+	/** @brief Reset the hasher to hash a new content. */
+	void reset() noexcept;
+
+private:
+	static constexpr size_t STRIPE_SIZE = 32;
+
+	void update(std::span<const uint8_t> data) noexcept;
+	void updateTag(uint8_t tag) noexcept;
+	void updateVarint(uint8_t tag, uint64_t value) noexcept;
+	void updateString(uint8_t tag, std::string_view str) noexcept;
+	void consumeStripe(const uint8_t* stripe) noexcept;
+
+	std::array<uint64_t, 4> m_accumulators {};
+	std::array<uint8_t, STRIPE_SIZE> m_buffer {};
+	size_t m_bufferSize = 0;
+	uint64_t m_totalLength = 0;
+	// Encoding of a table or a summary of values (hashed in a single update)
+	std::vector<uint8_t> m_encoded;
+};
+
+/**
+ * @brief Compute a hash of telemetry @p content.
+ *
+ * Equal contents have equal hashes. See ContentHasher for the details of the hash.
+ *
+ * @param content Telemetry content
+ * @return 64-bit hash
+ */
+uint64_t hashContent(const Content& content);
+
+} // namespace telemetry
@@ -0,0 +1,255 @@
+/**
+ * @file
+ * @author Pavel Siska <siska@cesnet.cz>
+ * @brief Streaming writer of telemetry content
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#pragma once
+
+#include "content.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+namespace telemetry {
+
+/**
+ * @brief Sink of telemetry content produced piece by piece.
+ *
+ * Instead of building a Content object, a producer can describe the content by a sequence
+ * of calls. The writer must be used in the same shape as Content:
+ * - a single scalar: value(), optionally preceded by unit(),
+ * - an array: beginArray(), value() for each element, endArray(),
+ * - a dictionary: beginDict(), pairs of key() followed by a dictionary value (a scalar with an
+ *   optional unit or an array), endDict(),
+ * - a table: table(),
+ * - a histogram: histogram(),
+ * - a quantile sketch: quantileSketch(),
+ * - a HyperLogLog: hyperLogLog(),
+ * - a top-K summary: topK().
+ *
+ * String views passed to the writer are valid only during the call, the writer must copy
+ * them if it needs them later.
+ */
+class ContentWriter {
+public:
+	virtual ~ContentWriter() = default;
+
+	/** @brief Begin a dictionary. */
+	virtual void beginDict() = 0;
+	/**
+	 * @brief Set the key of the following dictionary value.
+	 * @param key Dictionary key
+	 */
+	virtual void key(std::string_view key) = 0;
+	/** @brief End the dictionary. */
+	virtual void endDict() = 0;
+
+	/** @brief Begin an array of scalars. */
+	virtual void beginArray() = 0;
+	/** @brief End the array. */
+	virtual void endArray() = 0;
+
+	/**
+	 * @brief Set the unit of the following scalar value.
+	 * @param unit Unit of the value (e.g. "ms")
+	 */
+	virtual void unit(std::string_view unit) = 0;
+
+	/** @brief Write an unknown (N/A) value. */
+	virtual void value(std::monostate) = 0;
+	/** @brief Write a boolean value. */
+	virtual void value(bool value) = 0;
+	/** @brief Write an unsigned integer value. */
+	virtual void value(uint64_t value) = 0;
+	/** @brief Write a signed integer value. */
+	virtual void value(int64_t value) = 0;
+	/** @brief Write a floating point value. */
+	virtual void value(double value) = 0;
+	/** @brief Write a string value. */
+	virtual void value(std::string_view value) = 0;
+
+	/**
+	 * @brief Write a table.
+	 *
+	 * Writers that don't support tables don't have to override the method, the table is then
+	 * written as a dictionary of arrays (columns) and units of columns are lost.
+	 *
+	 * @param table Table to write
+	 */
+	virtual void table(const Table& table);
+
+	/**
+	 * @brief Write a histogram.
+	 *
+	 * Writers that don't support histograms don't have to override the method, the histogram
+	 * is then written as a dictionary of its summary: the count, the sum, the minimum,
+	 * the maximum, the mean and values at quantiles p50, p90, p99 and p999 (values other than
+	 * the count have the unit of the histogram and they are unknown if it is empty).
+	 *
+	 * @param histogram Histogram to write
+	 */
+	virtual void histogram(const Histogram& histogram);
+
+	/**
+	 * @brief Write a quantile sketch.
+	 *
+	 * Writers that don't support sketches don't have to override the method, the sketch
+	 * is then written as a dictionary of the same summary as a histogram (see histogram()).
+	 *
+	 * @param sketch Quantile sketch to write
+	 */
+	virtual void quantileSketch(const QuantileSketch& sketch);
+
+	/**
+	 * @brief Write a HyperLogLog.
+	 *
+	 * Writers that don't support HyperLogLogs don't have to override the method,
+	 * the HyperLogLog is then written as the estimated number of distinct values.
+	 *
+	 * @param hyperLogLog HyperLogLog to write
+	 */
+	virtual void hyperLogLog(const HyperLogLog& hyperLogLog);
+
+	/**
+	 * @brief Write a top-K summary.
+	 *
+	 * Writers that don't support top-K summaries don't have to override the method,
+	 * the summary is then written as a dictionary of monitored keys and their counts.
+	 *
+	 * @param topK Top-K summary to write
+	 */
+	virtual void topK(const TopK& topK);
+
+	/**
+	 * @brief Write a string value.
+	 *
+	 * Prevents conversion of string literals to the boolean overload.
+	 */
+	void value(const char* value) { this->value(std::string_view(value)); }
+
+	/**
+	 * @brief Write a scalar value.
+	 * @param scalar Scalar to write
+	 */
+	void value(const Scalar& scalar);
+};
+
+/**
+ * @brief Write telemetry @p content to the @p writer.
+ *
+ * @param writer Content writer
+ * @param content Telemetry content
+ */
+void writeContent(ContentWriter& writer, const Content& content);
+
+/**
+ * @brief Writer that renders content to the human readable string.
+ *
+ * The output is the same as the output of contentToString(). The content is rendered in one
+ * pass and all internal buffers keep their capacity between uses, so a writer that is reused
+ * for similar contents doesn't allocate any memory.
+ */
+class TextContentWriter : public ContentWriter {
+public:
+	using ContentWriter::value;
+
+	void beginDict() override;
+	void key(std::string_view key) override;
+	void endDict() override;
+	void beginArray() override;
+	void endArray() override;
+	void unit(std::string_view unit) override;
+	void value(std::monostate) override;
+	void value(bool value) override;
+	void value(uint64_t value) override;
+	void value(int64_t value) override;
+	void value(double value) override;
+	void value(std::string_view value) override;
+	void table(const Table& table) override;
+
+	/**
+	 * @brief Get the rendered content.
+	 * @return Rendered content (valid until the writer is modified).
+	 */
+	[[nodiscard]] const std::string& str() const noexcept { return m_output; }
+
+	/** @brief Reset the writer and discard the rendered content (capacity is kept). */
+	void clear() noexcept;
+
+private:
+	struct DictEntry {
+		size_t keyOffset;
+		size_t keyLength;
+		size_t valueOffset;
+		size_t valueLength;
+	};
+
+	void beginValue();
+	void endValue();
+
+	std::string m_output;
+	// Dictionary is rendered after its end as keys must be aligned by the longest one
+	std::string m_dictKeys;
+	std::string m_dictValues;
+	std::vector<DictEntry> m_dictEntries;
+	std::string* m_target = &m_output;
+
+	std::string m_unit;
+	bool m_hasUnit = false;
+	bool m_inArray = false;
+	size_t m_arraySize = 0;
+};
+
+/**
+ * @brief Writer that builds a Content object.
+ *
+ * Useful when a streaming producer must provide the content as an object.
+ */
+class ContentBuilder : public ContentWriter {
+public:
+	using ContentWriter::value;
+
+	void beginDict() override;
+	void key(std::string_view key) override;
+	void endDict() override;
+	void beginArray() override;
+	void endArray() override;
+	void unit(std::string_view unit) override;
+	void value(std::monostate) override;
+	void value(bool value) override;
+	void value(uint64_t value) override;
+	void value(int64_t value) override;
+	void value(double value) override;
+	void value(std::string_view value) override;
+	void table(const Table& table) override;
+	void histogram(const Histogram& histogram) override;
+	void quantileSketch(const QuantileSketch& sketch) override;
+	void hyperLogLog(const HyperLogLog& hyperLogLog) override;
+	void topK(const TopK& topK) override;
+
+	/**
+	 * @brief Take the built content and reset the builder.
+	 * @return Built content (an unknown scalar if nothing has been written).
+	 * @throw TelemetryException if a dictionary or an array has not been ended.
+	 */
+	Content takeContent();
+
+private:
+	void addScalar(Scalar scalar);
+	void addDictValue(DictValue value);
+
+	std::optional<Content> m_content;
+	std::optional<Dict> m_dict;
+	std::optional<Array> m_array;
+	std::optional<DictKey> m_key;
+	std::optional<Unit> m_unit;
+};
+
+} // namespace telemetry
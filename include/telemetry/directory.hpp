@@ -12,8 +12,11 @@
 #include "aggFile.hpp"
 #include "file.hpp"
 #include "node.hpp"
+#include "shardedCounter.hpp"
 #include "symlink.hpp"
 
+#include <atomic>
+#include <cstdint>
 #include <map>
 #include <memory>
 #include <string>
@@ -107,6 +110,53 @@ public:
 	 */
 	[[nodiscard]] std::shared_ptr<File> addFile(std::string_view name, FileOps ops);
 
+	/**
+	 * @brief Add a new file with the value of the @p counter.
+	 *
+	 * The file supports read operations (the value of the counter as an unsigned integer)
+	 * and the clear operation (reset of the counter, see ShardedCounter::reset()). The file
+	 * shares the ownership of the counter, so the counter is valid as long as the file is.
+	 *
+	 * @param name Name of the file
+	 * @param counter Counter read by the file
+	 * @return Shared pointer to the newly created file
+	 * @throw TelemetryException if there is already a file or directory with the same name.
+	 */
+	[[nodiscard]] std::shared_ptr<File>
+	addCounterFile(std::string_view name, std::shared_ptr<ShardedCounter> counter);
+
+	/**
+	 * @brief Add a new file with the value of the @p counter variable.
+	 *
+	 * The file is read by a relaxed load of the variable, without calling any read operation
+	 * (see FileVariable). The file doesn't support the clear operation.
+	 *
+	 * @warning The counter is referenced, it must outlive the file (see File).
+	 *
+	 * @param name Name of the file
+	 * @param counter Counter read by the file
+	 * @return Shared pointer to the newly created file
+	 * @throw TelemetryException if there is already a file or directory with the same name.
+	 */
+	[[nodiscard]] std::shared_ptr<File>
+	addCounterFile(std::string_view name, const std::atomic<uint64_t>& counter);
+
+	/**
+	 * @brief Add a new file with the value of the @p gauge variable.
+	 *
+	 * Same as addCounterFile() for a signed integer variable.
+	 */
+	[[nodiscard]] std::shared_ptr<File>
+	addGaugeFile(std::string_view name, const std::atomic<int64_t>& gauge);
+
+	/**
+	 * @brief Add a new file with the value of the @p gauge variable.
+	 *
+	 * Same as addCounterFile() for a floating point variable.
+	 */
+	[[nodiscard]] std::shared_ptr<File>
+	addGaugeFile(std::string_view name, const std::atomic<double>& gauge);
+
 	/**
 	 * @brief Add an aggregated file to the directory
 	 *
@@ -9,16 +9,80 @@
 #pragma once
 
 #include "content.hpp"
+#include "contentWriter.hpp"
 #include "node.hpp"
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <functional>
+#include <future>
 #include <memory>
+#include <optional>
 #include <string_view>
 
 namespace telemetry {
 
 class Directory;
 
+/**
+ * @brief Variable whose value is the content of a file.
+ *
+ * The variable is read by a relaxed atomic load, so files that only expose a variable don't
+ * need any read operation and their reads don't lock, allocate or build a Content object
+ * (when written to a content writer by File::readTo()). Producers update the variable by
+ * relaxed atomic operations, which cost the same as plain accesses on common platforms.
+ *
+ * The variable is referenced, not owned, see the warning of File about its lifetime.
+ */
+class FileVariable {
+public:
+	/** @brief Create an unset variable. */
+	FileVariable() noexcept = default;
+
+	/** @brief Bind an unsigned integer @p variable (e.g. a counter). */
+	explicit FileVariable(const std::atomic<uint64_t>& variable) noexcept
+		: m_type(Type::UINT64)
+		, m_variable(&variable)
+	{
+	}
+
+	/** @brief Bind a signed integer @p variable. */
+	explicit FileVariable(const std::atomic<int64_t>& variable) noexcept
+		: m_type(Type::INT64)
+		, m_variable(&variable)
+	{
+	}
+
+	/** @brief Bind a floating point @p variable (e.g. a gauge). */
+	explicit FileVariable(const std::atomic<double>& variable) noexcept
+		: m_type(Type::DOUBLE)
+		, m_variable(&variable)
+	{
+	}
+
+	/** @brief Test whether a variable is bound. */
+	explicit operator bool() const noexcept { return m_type != Type::NONE; }
+
+	/** @brief Load the value of the variable (unknown if no variable is bound). */
+	[[nodiscard]] Scalar load() const;
+
+	/** @brief Write the value of the variable to the @p writer. */
+	void writeTo(ContentWriter& writer) const;
+
+private:
+	enum class Type : uint8_t { NONE, UINT64, INT64, DOUBLE };
+
+	template <typename T>
+	T loadAs() const noexcept
+	{
+		return static_cast<const std::atomic<T>*>(m_variable)->load(std::memory_order_relaxed);
+	}
+
+	Type m_type = Type::NONE;
+	const void* m_variable = nullptr;
+};
+
 /**
  * @brief File I/O operations.
  *
@@ -26,7 +90,44 @@ class Directory;
  */
 struct FileOps {
 	std::function<Content()> read = nullptr; ///< Read operation
+	/**
+	 * Streaming read operation. Writes the content directly to the provided writer instead
+	 * of building a Content object, which avoids allocations of intermediate containers.
+	 * If both read operations are set, each one is used by the matching File method.
+	 */
+	std::function<void(ContentWriter&)> streamRead = nullptr;
 	std::function<void()> clear = nullptr; ///< Clear operation
+	/**
+	 * Variable read instead of calling a read operation (if both are set, the variable
+	 * is used). See FileVariable.
+	 */
+	FileVariable variable = {};
+	/**
+	 * Concurrent reads share the result of a single read operation. A read that starts
+	 * while another read is in progress waits for it and returns its content (or exception)
+	 * instead of calling the read operation again.
+	 */
+	bool coalesceReads = false;
+	/**
+	 * Period of time for which the last read content is reused. Reads within this period
+	 * (measured from the start of the read operation that produced the content) return the
+	 * cached content without calling the read operation. Zero disables the cache. The cache
+	 * is invalidated by the clear operation.
+	 */
+	std::chrono::milliseconds cacheDuration = std::chrono::milliseconds::zero();
+	/**
+	 * Content produced by the read operation when called by File::readTo() (e.g. by AppFs)
+	 * is allocated from a temporary arena released at once after the content is written.
+	 * Enable only if the read operation doesn't keep any copy of the produced content (or of its
+	 * dictionaries and arrays), as such copies would refer to the released arena.
+	 */
+	bool readArena = false;
+	/**
+	 * Hash of the content produced by each read operation is computed and kept by the file
+	 * (see File::getContentHash()), so consumers can detect that the content has not changed
+	 * and skip rendering or sending it.
+	 */
+	bool trackContentHash = false;
 };
 
 /**
@@ -36,6 +137,9 @@ struct FileOps {
  * with the application component in some other way. The class provides a number of optional
  * I/O operations (callbacks) that can be implemented and the visitor can use.
  *
+ * I/O operations are dispatched without any lock, so multiple visitors can execute them
+ * concurrently. If the callbacks access shared data, they must synchronize on their own.
+ *
  * @warning
  *   If an object is referenced within I/O operations (callbacks), it must be released or
  *   otherwise destroyed after this file instance. There is a risk that, in the case of
@@ -70,12 +174,33 @@ public:
 	 * @throw TelemetryException if the operation is not supported.
 	 */
 	Content read();
+	/**
+	 * @brief Execute read operation and write the content to the @p writer.
+	 *
+	 * The streaming read operation is used if it is available and neither the cache nor
+	 * read coalescing is enabled. Otherwise, the content is read as an object and written
+	 * to the writer afterwards (allocated from a temporary arena if enabled by FileOps).
+	 *
+	 * @param writer Content writer
+	 * @throw TelemetryException if the operation is not supported.
+	 */
+	void readTo(ContentWriter& writer);
 	/**
 	 * @brief Execute clear operation.
 	 * @throw TelemetryException if the operation is not supported.
 	 */
 	void clear();
 
+	/**
+	 * @brief Get the hash of the content produced by the last read operation.
+	 *
+	 * The hash is computed by hashContent() only if enabled by FileOps::trackContentHash.
+	 * Reads served from the cache don't change the hash.
+	 *
+	 * @return Hash of the last read content or std::nullopt if it is not known.
+	 */
+	std::optional<uint64_t> getContentHash();
+
 	/**
 	 * @brief Disable all I/O operations (callbacks).
 	 *
@@ -83,11 +208,38 @@ public:
 	 * any callback is about to be destroyed. There is always a small chance that
 	 * there might be an asynchronous visitor that is able to obtain shared
 	 * pointer reference to this file and try to call any callback.
+	 *
+	 * When the function returns, no callback is running and no callback will be called
+	 * anymore.
+	 *
+	 * @warning The function must not be called from a callback of the same file, as it would
+	 *   wait for its own completion.
 	 */
 	void disable();
 
 private:
+	class CallGuard;
+
 	FileOps m_ops;
+	// Operations available for new calls (points to m_ops or nullptr if disabled)
+	std::atomic<const FileOps*> m_activeOps;
+	// Number of calls that might be using the operations pointed by m_activeOps
+	std::atomic<uint32_t> m_activeCalls = 0;
+	// Read in progress shared by concurrent readers (protected by the node mutex)
+	std::shared_future<Content> m_pendingRead;
+	// Last read content and the start time of its read (protected by the node mutex)
+	std::optional<Content> m_cachedContent;
+	std::chrono::steady_clock::time_point m_cachedTime;
+	// Hash of the last read content (protected by the node mutex)
+	std::optional<uint64_t> m_contentHash;
+
+	static void streamContent(const FileOps& ops, ContentWriter& writer);
+	Content readContent(const FileOps& ops);
+	Content readCoalesced(const FileOps& ops);
+	std::optional<Content> getCachedContent(const FileOps& ops);
+	void setCachedContent(const Content& content, std::chrono::steady_clock::time_point time);
+	void resetCachedContent();
+	void setContentHash(uint64_t hash);
 
 	// Allow directory to call File constructor
 	friend class Directory;
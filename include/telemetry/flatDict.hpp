@@ -0,0 +1,406 @@
+/**
+ * @file
+ * @author Pavel Siska <siska@cesnet.cz>
+ * @brief Dictionary stored in contiguous arrays
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace telemetry {
+
+/**
+ * @brief Associative container with unique keys stored in contiguous arrays.
+ *
+ * The container provides a subset of the std::map interface with the same semantics
+ * (e.g. insert() never overwrites an existing key, iteration is in the ascending order
+ * of keys). Elements are stored in a single vector in the order of insertion and a separate
+ * vector of 32-bit indices keeps them sorted by keys. Building a dictionary doesn't allocate
+ * a node per key, an insertion in the middle moves only indices and lookups are binary
+ * searches over contiguous memory.
+ *
+ * Unlike std::map, insertion and removal of elements invalidate all iterators and references.
+ *
+ * @tparam Key Key type
+ * @tparam Value Mapped type
+ * @tparam Compare Comparison of keys (transparent comparators enable heterogeneous lookup)
+ * @tparam Allocator Allocator of elements (rebound for the index array)
+ */
+template <
+	typename Key,
+	typename Value,
+	typename Compare = std::less<>,
+	typename Allocator = std::allocator<std::pair<Key, Value>>>
+class FlatDict {
+	using Index = uint32_t;
+	using IndexAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Index>;
+
+	template <bool IsConst>
+	class Iterator;
+
+public:
+	using key_type = Key;
+	using mapped_type = Value;
+	using value_type = std::pair<Key, Value>;
+	using key_compare = Compare;
+	using allocator_type = Allocator;
+	using size_type = std::size_t;
+	using difference_type = std::ptrdiff_t;
+	using reference = value_type&;
+	using const_reference = const value_type&;
+	using iterator = Iterator<false>;
+	using const_iterator = Iterator<true>;
+
+	FlatDict() = default;
+
+	/**
+	 * @brief Create a dictionary from a list of elements.
+	 *
+	 * If the list contains multiple elements with the same key, the first one is used.
+	 */
+	FlatDict(std::initializer_list<value_type> init) { insert(init.begin(), init.end()); }
+
+	/**
+	 * @brief Create a dictionary from a range of elements.
+	 *
+	 * If the range contains multiple elements with the same key, the first one is used.
+	 */
+	template <typename InputIt>
+	FlatDict(InputIt first, InputIt last)
+	{
+		insert(first, last);
+	}
+
+	iterator begin() noexcept { return {this, 0}; }
+	const_iterator begin() const noexcept { return {this, 0}; }
+	const_iterator cbegin() const noexcept { return begin(); }
+	iterator end() noexcept { return {this, size()}; }
+	const_iterator end() const noexcept { return {this, size()}; }
+	const_iterator cend() const noexcept { return end(); }
+
+	[[nodiscard]] bool empty() const noexcept { return m_entries.empty(); }
+	size_type size() const noexcept { return m_entries.size(); }
+	size_type capacity() const noexcept { return m_entries.capacity(); }
+
+	/** @brief Reserve space for at least @p count elements. */
+	void reserve(size_type count)
+	{
+		m_entries.reserve(count);
+		m_order.reserve(count);
+	}
+
+	/** @brief Remove all elements (capacity is kept). */
+	void clear() noexcept
+	{
+		m_entries.clear();
+		m_order.clear();
+	}
+
+	template <typename K>
+	iterator lower_bound(const K& key)
+	{
+		return {this, lowerBoundPosition(key)};
+	}
+
+	template <typename K>
+	const_iterator lower_bound(const K& key) const
+	{
+		return {this, lowerBoundPosition(key)};
+	}
+
+	template <typename K>
+	iterator find(const K& key)
+	{
+		return {this, findPosition(key)};
+	}
+
+	template <typename K>
+	const_iterator find(const K& key) const
+	{
+		return {this, findPosition(key)};
+	}
+
+	template <typename K>
+	bool contains(const K& key) const
+	{
+		return findPosition(key) != size();
+	}
+
+	template <typename K>
+	size_type count(const K& key) const
+	{
+		return contains(key) ? 1 : 0;
+	}
+
+	/**
+	 * @brief Access the value of the element with the @p key.
+	 * @throw std::out_of_range if there is no such element.
+	 */
+	template <typename K>
+	Value& at(const K& key)
+	{
+		return const_cast<Value&>(std::as_const(*this).at(key));
+	}
+
+	template <typename K>
+	const Value& at(const K& key) const
+	{
+		const size_type pos = findPosition(key);
+		if (pos == size()) {
+			throw std::out_of_range("FlatDict::at(): key not found");
+		}
+		return entryAt(pos).second;
+	}
+
+	/** @brief Access the value of the @p key, a default value is inserted if it is missing. */
+	Value& operator[](const Key& key) { return try_emplace(key).first->second; }
+	Value& operator[](Key&& key) { return try_emplace(std::move(key)).first->second; }
+
+	/**
+	 * @brief Insert a value of the @p key if the key doesn't exist.
+	 * @return Iterator to the element with the key and true if the value has been inserted.
+	 */
+	template <typename K, typename... Args>
+	std::pair<iterator, bool> try_emplace(K&& key, Args&&... args)
+	{
+		const size_type pos = lowerBoundPosition(key);
+		if (pos != size() && !Compare {}(key, entryAt(pos).first)) {
+			return {iterator {this, pos}, false};
+		}
+
+		if (size() >= std::numeric_limits<Index>::max()) {
+			throw std::length_error("FlatDict: too many elements");
+		}
+
+		m_entries.emplace_back(
+			std::piecewise_construct,
+			std::forward_as_tuple(std::forward<K>(key)),
+			std::forward_as_tuple(std::forward<Args>(args)...));
+		try {
+			m_order.insert(
+				m_order.begin() + static_cast<difference_type>(pos),
+				static_cast<Index>(m_entries.size() - 1));
+		} catch (...) {
+			m_entries.pop_back();
+			throw;
+		}
+
+		return {iterator {this, pos}, true};
+	}
+
+	/**
+	 * @brief Insert or overwrite a value of the @p key.
+	 * @return Iterator to the element with the key and true if the value has been inserted.
+	 */
+	template <typename K, typename V>
+	std::pair<iterator, bool> insert_or_assign(K&& key, V&& value)
+	{
+		const size_type pos = findPosition(key);
+		if (pos != size()) {
+			entryAt(pos).second = std::forward<V>(value);
+			return {iterator {this, pos}, false};
+		}
+
+		return try_emplace(std::forward<K>(key), std::forward<V>(value));
+	}
+
+	/**
+	 * @brief Insert the element if its key doesn't exist.
+	 * @return Iterator to the element with the key and true if the element has been inserted.
+	 */
+	std::pair<iterator, bool> insert(const value_type& value)
+	{
+		return try_emplace(value.first, value.second);
+	}
+
+	std::pair<iterator, bool> insert(value_type&& value)
+	{
+		return try_emplace(std::move(value.first), std::move(value.second));
+	}
+
+	template <typename... Args>
+	std::pair<iterator, bool> emplace(Args&&... args)
+	{
+		return insert(value_type(std::forward<Args>(args)...));
+	}
+
+	/**
+	 * @brief Insert elements of the range whose keys don't exist yet.
+	 *
+	 * Existing elements are never overwritten. If the range contains multiple elements with
+	 * the same key, the first one is inserted.
+	 */
+	template <typename InputIt>
+	void insert(InputIt first, InputIt last)
+	{
+		for (; first != last; ++first) {
+			insert(*first);
+		}
+	}
+
+	void insert(std::initializer_list<value_type> init) { insert(init.begin(), init.end()); }
+
+	/**
+	 * @brief Remove the element at @p pos.
+	 * @return Iterator to the element following the removed one.
+	 */
+	iterator erase(const_iterator pos)
+	{
+		const size_type orderPos = pos.m_pos;
+		const Index removed = m_order[orderPos];
+		const auto last = static_cast<Index>(m_entries.size() - 1);
+
+		m_order.erase(m_order.begin() + static_cast<difference_type>(orderPos));
+
+		// Keep entries contiguous by moving the last entry into the released slot
+		if (removed != last) {
+			m_entries[removed] = std::move(m_entries[last]);
+			*std::find(m_order.begin(), m_order.end(), last) = removed;
+		}
+		m_entries.pop_back();
+
+		return {this, orderPos};
+	}
+
+	template <typename K>
+	size_type erase(const K& key)
+	{
+		const size_type pos = findPosition(key);
+		if (pos == size()) {
+			return 0;
+		}
+
+		erase(const_iterator {this, pos});
+		return 1;
+	}
+
+	void swap(FlatDict& other) noexcept
+	{
+		m_entries.swap(other.m_entries);
+		m_order.swap(other.m_order);
+	}
+
+	friend bool operator==(const FlatDict& lhs, const FlatDict& rhs)
+	{
+		return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+	}
+
+private:
+	value_type& entryAt(size_type pos) { return m_entries[m_order[pos]]; }
+	const value_type& entryAt(size_type pos) const { return m_entries[m_order[pos]]; }
+
+	template <typename K>
+	size_type lowerBoundPosition(const K& key) const
+	{
+		auto less = [entries = m_entries.data()](Index index, const K& value) {
+			return Compare {}(entries[index].first, value);
+		};
+
+		auto iter = std::lower_bound(m_order.begin(), m_order.end(), key, less);
+		return static_cast<size_type>(iter - m_order.begin());
+	}
+
+	template <typename K>
+	size_type findPosition(const K& key) const
+	{
+		const size_type pos = lowerBoundPosition(key);
+		if (pos != size() && !Compare {}(key, entryAt(pos).first)) {
+			return pos;
+		}
+		return size();
+	}
+
+	// Elements in the order of insertion
+	std::vector<value_type, Allocator> m_entries;
+	// Indices of elements in the ascending order of their keys
+	std::vector<Index, IndexAllocator> m_order;
+};
+
+/**
+ * @brief Bidirectional iterator over elements in the ascending order of keys.
+ */
+template <typename Key, typename Value, typename Compare, typename Allocator>
+template <bool IsConst>
+class FlatDict<Key, Value, Compare, Allocator>::Iterator {
+	using Dict = std::conditional_t<IsConst, const FlatDict, FlatDict>;
+
+public:
+	using iterator_category = std::bidirectional_iterator_tag;
+	using value_type = typename FlatDict::value_type;
+	using difference_type = std::ptrdiff_t;
+	using pointer = std::conditional_t<IsConst, const value_type*, value_type*>;
+	using reference = std::conditional_t<IsConst, const value_type&, value_type&>;
+
+	Iterator() = default;
+
+	Iterator(Dict* dict, size_type pos)
+		: m_dict(dict)
+		, m_pos(pos)
+	{
+	}
+
+	// Conversion of an iterator to a const iterator
+	template <bool OtherConst, typename = std::enable_if_t<IsConst && !OtherConst>>
+	Iterator(const Iterator<OtherConst>& other)
+		: m_dict(other.m_dict)
+		, m_pos(other.m_pos)
+	{
+	}
+
+	reference operator*() const { return m_dict->entryAt(m_pos); }
+	pointer operator->() const { return &m_dict->entryAt(m_pos); }
+
+	Iterator& operator++()
+	{
+		++m_pos;
+		return *this;
+	}
+
+	Iterator operator++(int)
+	{
+		Iterator tmp = *this;
+		++m_pos;
+		return tmp;
+	}
+
+	Iterator& operator--()
+	{
+		--m_pos;
+		return *this;
+	}
+
+	Iterator operator--(int)
+	{
+		Iterator tmp = *this;
+		--m_pos;
+		return tmp;
+	}
+
+	friend bool operator==(const Iterator& lhs, const Iterator& rhs)
+	{
+		return lhs.m_dict == rhs.m_dict && lhs.m_pos == rhs.m_pos;
+	}
+
+private:
+	Dict* m_dict = nullptr;
+	size_type m_pos = 0;
+
+	friend class FlatDict;
+	friend class Iterator<!IsConst>;
+};
+
+} // namespace telemetry
@@ -0,0 +1,247 @@
+/**
+ * @file
+ * @author Pavel Siska <siska@cesnet.cz>
+ * @brief Mergeable histogram of telemetry values
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#pragma once
+
+#include "contentAllocator.hpp"
+#include "symbol.hpp"
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace telemetry {
+
+/**
+ * @brief Histogram of unsigned integer values (e.g. latencies) with log-linear buckets.
+ *
+ * Each power of two range of values is split into 2^precision buckets of the same width
+ * (values lower than 2^precision have a bucket each), so the relative error of any value
+ * derived from the buckets is at most 2^-precision (e.g. 6.25 % for the default precision)
+ * for the whole range of 64-bit values. Only non-empty buckets are stored.
+ *
+ * Besides buckets, the histogram keeps the exact sum, minimum and maximum of all recorded
+ * values. Histograms of the same unit and precision can be merged without any loss,
+ * e.g. histograms of several workers are merged by the MERGE aggregation method.
+ *
+ * The histogram is a snapshot of values, it is not thread-safe. Producers that record values
+ * from several threads should use HistogramRecorder and provide its snapshots.
+ *
+ * Allocates from the content memory resource of the creating thread (see ContentResourceScope).
+ */
+class Histogram {
+public:
+	/** @brief Default number of bits of precision. */
+	static constexpr unsigned DEFAULT_PRECISION = 4;
+	/** @brief Maximal number of bits of precision. */
+	static constexpr unsigned MAX_PRECISION = 10;
+
+	/** @brief Non-empty bucket of the histogram. */
+	struct Bucket {
+		uint32_t index; ///< Index of the bucket (see bucketIndex())
+		uint64_t count; ///< Number of values in the bucket
+
+		bool operator==(const Bucket& other) const = default;
+	};
+
+	/** @brief Non-empty buckets sorted by their index. */
+	using Buckets = std::vector<Bucket, ContentAllocator<Bucket>>;
+
+	/**
+	 * @brief Create an empty histogram.
+	 * @param unit Unit of values (empty if there is no unit)
+	 * @param precision Number of bits of precision (see Histogram)
+	 * @throw TelemetryException if the precision is greater than MAX_PRECISION.
+	 */
+	explicit Histogram(std::string_view unit = {}, unsigned precision = DEFAULT_PRECISION);
+
+	/**
+	 * @brief Create a histogram from its parts (e.g. when it is decoded).
+	 *
+	 * @param unit Unit of values (empty if there is no unit)
+	 * @param precision Number of bits of precision
+	 * @param buckets Non-empty buckets sorted by their index
+	 * @param sum Sum of all values
+	 * @param min Minimal value (ignored if there are no buckets)
+	 * @param max Maximal value (ignored if there are no buckets)
+	 * @throw TelemetryException if the parts are not consistent.
+	 */
+	static Histogram fromParts(
+		std::string_view unit,
+		unsigned precision,
+		Buckets buckets,
+		uint64_t sum,
+		uint64_t min,
+		uint64_t max);
+
+	/**
+	 * @brief Record a value.
+	 * @param value Recorded value
+	 * @param count Number of occurrences of the value
+	 */
+	void record(uint64_t value, uint64_t count = 1);
+
+	/**
+	 * @brief Add all values of the @p other histogram.
+	 * @throw TelemetryException if the histograms differ in the unit or the precision.
+	 */
+	void merge(const Histogram& other);
+
+	/** @brief Get the unit of values. */
+	[[nodiscard]] const Symbol& unit() const noexcept { return m_unit; }
+	/** @brief Get the number of bits of precision. */
+	[[nodiscard]] unsigned precision() const noexcept { return m_precision; }
+	/** @brief Get the non-empty buckets sorted by their index. */
+	[[nodiscard]] const Buckets& buckets() const noexcept { return m_buckets; }
+	/** @brief Get the number of recorded values. */
+	[[nodiscard]] uint64_t count() const noexcept { return m_count; }
+	/** @brief Get the sum of recorded values (wraps around on overflow). */
+	[[nodiscard]] uint64_t sum() const noexcept { return m_sum; }
+	/** @brief Get the minimal recorded value (0 if the histogram is empty). */
+	[[nodiscard]] uint64_t min() const noexcept { return m_count > 0 ? m_min : 0; }
+	/** @brief Get the maximal recorded value (0 if the histogram is empty). */
+	[[nodiscard]] uint64_t max() const noexcept { return m_max; }
+	/** @brief Get the mean of recorded values (0 if the histogram is empty). */
+	[[nodiscard]] double mean() const noexcept;
+
+	/**
+	 * @brief Get the value at the @p quantile.
+	 *
+	 * The value is the upper bound of the bucket of the value limited by the minimal and
+	 * the maximal value, so it is never lower than the exact value.
+	 *
+	 * @param quantile Quantile in the range [0, 1] (e.g. 0.99 for the 99th percentile)
+	 * @return Value at the quantile (0 if the histogram is empty)
+	 */
+	[[nodiscard]] uint64_t valueAtQuantile(double quantile) const noexcept;
+
+	/**
+	 * @brief Get the index of the bucket of the @p value.
+	 * @param value Value
+	 * @param precision Number of bits of precision
+	 */
+	static constexpr uint32_t bucketIndex(uint64_t value, unsigned precision) noexcept
+	{
+		const uint64_t subBuckets = uint64_t {1} << precision;
+		if (value < subBuckets) {
+			return static_cast<uint32_t>(value);
+		}
+
+		const auto shift = static_cast<unsigned>(std::bit_width(value)) - 1 - precision;
+		return static_cast<uint32_t>(((shift + 1ULL) << precision) + (value >> shift) - subBuckets);
+	}
+
+	/** @brief Get the lowest value of the bucket with the @p index. */
+	static constexpr uint64_t bucketLowerBound(uint32_t index, unsigned precision) noexcept
+	{
+		const uint64_t subBuckets = uint64_t {1} << precision;
+		if (index < subBuckets) {
+			return index;
+		}
+
+		const unsigned shift = (index >> precision) - 1;
+		return (subBuckets + (index & (subBuckets - 1))) << shift;
+	}
+
+	/** @brief Get the highest value of the bucket with the @p index. */
+	static constexpr uint64_t bucketUpperBound(uint32_t index, unsigned precision) noexcept
+	{
+		const uint64_t subBuckets = uint64_t {1} << precision;
+		if (index < subBuckets) {
+			return index;
+		}
+
+		const unsigned shift = (index >> precision) - 1;
+		return bucketLowerBound(index, precision) + ((uint64_t {1} << shift) - 1);
+	}
+
+	/** @brief Get the number of buckets covering all 64-bit values. */
+	static constexpr size_t bucketCount(unsigned precision) noexcept
+	{
+		return (std::numeric_limits<uint64_t>::digits + 1 - precision) << precision;
+	}
+
+	bool operator==(const Histogram& other) const = default;
+
+private:
+	Symbol m_unit;
+	unsigned m_precision;
+	Buckets m_buckets;
+	uint64_t m_count = 0;
+	uint64_t m_sum = 0;
+	uint64_t m_min = std::numeric_limits<uint64_t>::max();
+	uint64_t m_max = 0;
+};
+
+/**
+ * @brief Recorder of values to a histogram from any number of threads.
+ *
+ * Values are recorded lock-free by atomic increments of preallocated buckets (all buckets
+ * covering 64-bit values are allocated, e.g. 976 counters for the default precision).
+ * Snapshots can be taken at any time, e.g. by a file read operation:
+ *
+ * @code
+ * HistogramRecorder latency("us");
+ * // worker threads
+ * latency.record(elapsedUs);
+ * // telemetry file
+ * ops.read = [&]() { return latency.snapshot(); };
+ * @endcode
+ */
+class HistogramRecorder {
+public:
+	/**
+	 * @brief Create a recorder.
+	 * @param unit Unit of values (empty if there is no unit)
+	 * @param precision Number of bits of precision (see Histogram)
+	 * @throw TelemetryException if the precision is greater than Histogram::MAX_PRECISION.
+	 */
+	explicit HistogramRecorder(
+		std::string_view unit = {},
+		unsigned precision = Histogram::DEFAULT_PRECISION);
+
+	/**
+	 * @brief Record a value (thread-safe and lock-free).
+	 * @param value Recorded value
+	 * @param count Number of occurrences of the value
+	 */
+	void record(uint64_t value, uint64_t count = 1) noexcept;
+
+	/**
+	 * @brief Take a snapshot of recorded values.
+	 *
+	 * Values recorded concurrently with the snapshot might be included only partially
+	 * (e.g. in buckets but not in the sum).
+	 *
+	 * @return Histogram of recorded values
+	 */
+	[[nodiscard]] Histogram snapshot() const;
+
+	/**
+	 * @brief Discard all recorded values.
+	 *
+	 * Values recorded concurrently with the reset might be discarded only partially.
+	 */
+	void reset() noexcept;
+
+private:
+	Symbol m_unit;
+	unsigned m_precision;
+	size_t m_bucketCount;
+	std::unique_ptr<std::atomic<uint64_t>[]> m_buckets;
+	std::atomic<uint64_t> m_sum = 0;
+	std::atomic<uint64_t> m_min = std::numeric_limits<uint64_t>::max();
+	std::atomic<uint64_t> m_max = 0;
+};
+
+} // namespace telemetry
@@ -0,0 +1,188 @@
+/**
+ * @file
+ * @author Pavel Siska <siska@cesnet.cz>
+ * @brief Mergeable HyperLogLog estimate of the number of distinct values
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#pragma once
+
+#include "contentAllocator.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace telemetry {
+
+/**
+ * @brief HyperLogLog estimate of the number of distinct values (e.g. source IP addresses).
+ *
+ * Values are hashed to 64 bits, the highest @p precision bits of the hash select one
+ * of 2^precision registers and the register keeps the maximal position of the first one bit
+ * of the remaining bits. The standard error of the estimate is about 1.04 / sqrt(2^precision)
+ * (e.g. 1.6 % for the default precision with 4 KiB of registers).
+ *
+ * HyperLogLogs of the same precision can be merged (a union of sets of values), e.g. counts
+ * of distinct values of several workers are merged by the MERGE aggregation method. Unlike
+ * a sum of counts, the merged estimate doesn't count values seen by several workers twice.
+ *
+ * The HyperLogLog is a snapshot of registers, it is not thread-safe. Producers that add values
+ * from several threads should use HyperLogLogRecorder and provide its snapshots.
+ *
+ * Allocates from the content memory resource of the creating thread (see ContentResourceScope).
+ */
+class HyperLogLog {
+public:
+	/** @brief Minimal number of bits of precision. */
+	static constexpr unsigned MIN_PRECISION = 4;
+	/** @brief Default number of bits of precision. */
+	static constexpr unsigned DEFAULT_PRECISION = 12;
+	/** @brief Maximal number of bits of precision. */
+	static constexpr unsigned MAX_PRECISION = 18;
+
+	/** @brief Registers of the HyperLogLog. */
+	using Registers = std::vector<uint8_t, ContentAllocator<uint8_t>>;
+
+	/**
+	 * @brief Create an empty HyperLogLog.
+	 * @param precision Number of bits of precision in the range [MIN_PRECISION, MAX_PRECISION]
+	 * @throw TelemetryException if the precision is out of the range.
+	 */
+	explicit HyperLogLog(unsigned precision = DEFAULT_PRECISION);
+
+	/**
+	 * @brief Create a HyperLogLog from its registers (e.g. when it is decoded).
+	 * @param precision Number of bits of precision
+	 * @param registers 2^precision registers
+	 * @throw TelemetryException if registers don't match the precision.
+	 */
+	static HyperLogLog fromRegisters(unsigned precision, Registers registers);
+
+	/** @brief Add a value. */
+	void add(uint64_t value) noexcept { addHash(hash(value)); }
+	/** @brief Add a value given by its bytes (e.g. an IPv6 address or a string). */
+	void add(std::string_view value) noexcept { addHash(hash(value)); }
+
+	/**
+	 * @brief Add a value by its hash.
+	 *
+	 * All bits of the hash must be uniformly distributed, e.g. hashes returned by hash().
+	 *
+	 * @param hash 64-bit hash of the value
+	 */
+	void addHash(uint64_t hash) noexcept
+	{
+		uint8_t& reg = m_registers[registerIndex(hash, m_precision)];
+		reg = std::max(reg, registerValue(hash, m_precision));
+	}
+
+	/**
+	 * @brief Add all values of the @p other HyperLogLog.
+	 * @throw TelemetryException if the HyperLogLogs differ in the precision.
+	 */
+	void merge(const HyperLogLog& other);
+
+	/** @brief Get the number of bits of precision. */
+	[[nodiscard]] unsigned precision() const noexcept { return m_precision; }
+	/** @brief Get registers. */
+	[[nodiscard]] const Registers& registers() const noexcept { return m_registers; }
+
+	/**
+	 * @brief Get the estimated number of distinct values.
+	 *
+	 * Low numbers (up to 2.5 * 2^precision) are estimated from the number of empty registers
+	 * (linear counting), which is more accurate for them.
+	 */
+	[[nodiscard]] uint64_t estimate() const noexcept;
+
+	/** @brief Hash a value to 64 bits. */
+	static constexpr uint64_t hash(uint64_t value) noexcept
+	{
+		// Finalizer of MurmurHash3
+		value ^= value >> 33U;
+		value *= 0xFF51AFD7ED558CCDULL;
+		value ^= value >> 33U;
+		value *= 0xC4CEB9FE1A85EC53ULL;
+		value ^= value >> 33U;
+		return value;
+	}
+
+	/** @brief Hash bytes of a value to 64 bits. */
+	static uint64_t hash(std::string_view value) noexcept;
+
+	/** @brief Get the index of the register of the @p hash. */
+	static constexpr size_t registerIndex(uint64_t hash, unsigned precision) noexcept
+	{
+		return static_cast<size_t>(hash >> (std::numeric_limits<uint64_t>::digits - precision));
+	}
+
+	/** @brief Get the value of the register of the @p hash (the position of the first 1). */
+	static constexpr uint8_t registerValue(uint64_t hash, unsigned precision) noexcept
+	{
+		// The sentinel bit limits the value if the remaining bits are zeros
+		const uint64_t remaining = (hash << precision) | (uint64_t {1} << (precision - 1));
+		return static_cast<uint8_t>(std::countl_zero(remaining) + 1);
+	}
+
+	bool operator==(const HyperLogLog& other) const = default;
+
+private:
+	unsigned m_precision;
+	Registers m_registers;
+};
+
+/**
+ * @brief Recorder of distinct values to a HyperLogLog from any number of threads.
+ *
+ * Values are added lock-free by atomic updates of registers. Snapshots can be taken at any
+ * time, e.g. by a file read operation:
+ *
+ * @code
+ * HyperLogLogRecorder sources;
+ * // worker threads
+ * sources.add(flow.srcIp);
+ * // telemetry file
+ * ops.read = [&]() { return sources.snapshot(); };
+ * @endcode
+ */
+class HyperLogLogRecorder {
+public:
+	/**
+	 * @brief Create a recorder.
+	 * @param precision Number of bits of precision (see HyperLogLog)
+	 * @throw TelemetryException if the precision is out of the range.
+	 */
+	explicit HyperLogLogRecorder(unsigned precision = HyperLogLog::DEFAULT_PRECISION);
+
+	/** @brief Add a value (thread-safe and lock-free). */
+	void add(uint64_t value) noexcept { addHash(HyperLogLog::hash(value)); }
+	/** @brief Add a value given by its bytes (thread-safe and lock-free). */
+	void add(std::string_view value) noexcept { addHash(HyperLogLog::hash(value)); }
+	/** @brief Add a value by its hash (thread-safe and lock-free, see HyperLogLog::addHash()). */
+	void addHash(uint64_t hash) noexcept;
+
+	/** @brief Take a snapshot of added values. */
+	[[nodiscard]] HyperLogLog snapshot() const;
+
+	/**
+	 * @brief Discard all added values.
+	 *
+	 * Values added concurrently with the reset might be discarded or kept.
+	 */
+	void reset() noexcept;
+
+private:
+	unsigned m_precision;
+	size_t m_registerCount;
+	std::unique_ptr<std::atomic<uint8_t>[]> m_registers;
+};
+
+} // namespace telemetry
@@ -0,0 +1,154 @@
+/**
+ * @file
+ * @author Pavel Siska <siska@cesnet.cz>
+ * @brief Export of telemetry directories in the InfluxDB line protocol
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#pragma once
+
+#include "contentWriter.hpp"
+#include "directory.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace telemetry {
+
+/**
+ * @brief Exporter of a directory tree in the InfluxDB line protocol.
+ *
+ * Each file is exported as a single line (a point). The measurement is the path of the file
+ * (names of directories and the file joined by '/', optionally preceded by a prefix) and
+ * all points of a batch share the same timestamp. Fields of the point are:
+ * - entries of a dictionary (keyed by dictionary keys),
+ * - the "value" field for a scalar,
+ * - fields "<key>_<index>" for elements of arrays ("value_<index>" for an array file).
+ *
+ * Unsigned and signed integers are written as "u" and "i" suffixed integers, floating point
+ * numbers, booleans and strings as the corresponding field types. Units are not exported.
+ * Unknown values and non-finite numbers are skipped, as are files without any field.
+ *
+ * Names of selected directories can be turned into tags by setTagDirectory(). For example,
+ * if entries of the "queues" directory are tag directories with the tag "queue", the file
+ * "queues/0/stats" is exported as the measurement "queues/stats" with the tag `queue=0`.
+ *
+ * The output is written to a buffer supplied by the caller. Whenever the buffer is full,
+ * its content is passed to the sink and the buffer is reused, so memory usage doesn't depend
+ * on the size of the tree. Lines are never split between chunks unless a line is longer
+ * than the buffer. Internal buffers keep their capacity between exports.
+ *
+ * The exporter is not thread-safe, use a separate instance for each thread.
+ */
+class InfluxExporter : private ContentWriter {
+public:
+	/** @brief Consumer of chunks of the output (e.g. a write to a pipe). */
+	using Sink = std::function<void(std::string_view chunk)>;
+
+	/**
+	 * @brief Create an exporter.
+	 * @param prefix Prefix of all measurements (e.g. the name of the application)
+	 */
+	explicit InfluxExporter(std::string_view prefix = {});
+
+	/**
+	 * @brief Export names of entries of a directory as values of a tag.
+	 *
+	 * Entries of each directory with the @p directoryName are not added to measurements,
+	 * their names are used as values of the tag @p tagName instead.
+	 *
+	 * @param directoryName Name of the directory whose entries are turned into tags
+	 * @param tagName Name of the tag
+	 */
+	void setTagDirectory(std::string_view directoryName, std::string_view tagName);
+
+	/**
+	 * @brief Export a directory tree as a single batch.
+	 *
+	 * Files whose read operation fails are skipped.
+	 *
+	 * @param dir Root directory of the exported tree (its name is not a part of measurements)
+	 * @param buffer Output buffer
+	 * @param sink Consumer of filled parts of the buffer
+	 * @param timestamp Timestamp of all points of the batch
+	 * @throw TelemetryException if the buffer is empty.
+	 */
+	void exportDirectory(
+		const std::shared_ptr<Directory>& dir,
+		std::span<char> buffer,
+		const Sink& sink,
+		std::chrono::system_clock::time_point timestamp = std::chrono::system_clock::now());
+
+	/**
+	 * @brief Export a directory tree as a single batch to a string.
+	 *
+	 * @param dir Root directory of the exported tree
+	 * @param timestamp Timestamp of all points of the batch
+	 * @return Lines of the exported points
+	 */
+	std::string exportDirectory(
+		const std::shared_ptr<Directory>& dir,
+		std::chrono::system_clock::time_point timestamp = std::chrono::system_clock::now());
+
+private:
+	struct Level {
+		size_t measurementLength;
+		size_t tagsLength;
+		// Tag of entries of the directory (empty if they are not turned into tags)
+		std::string_view entryTag;
+	};
+
+	void beginDict() override;
+	void key(std::string_view key) override;
+	void endDict() override;
+	void beginArray() override;
+	void endArray() override;
+	void unit(std::string_view unit) override;
+	void value(std::monostate) override;
+	void value(bool value) override;
+	void value(uint64_t value) override;
+	void value(int64_t value) override;
+	void value(double value) override;
+	void value(std::string_view value) override;
+
+	friend class InfluxVisitor;
+
+	void enterEntry(std::string_view name);
+	void leaveEntry();
+	void visitFile(File& file);
+
+	void beginField();
+	void write(std::string_view data);
+	void flush();
+
+	std::string m_prefix;
+	std::vector<std::pair<std::string, std::string>> m_tagDirectories;
+
+	// Measurement and tags of the currently visited entry (escaped)
+	std::string m_measurement;
+	std::string m_tags;
+	std::vector<Level> m_levels;
+
+	// Line of the currently read file
+	std::string m_line;
+	size_t m_fieldsOffset = 0;
+	std::string m_key;
+	bool m_inArray = false;
+	uint64_t m_arrayIndex = 0;
+	std::string m_timestamp;
+
+	// Output of the current export
+	std::span<char> m_buffer;
+	size_t m_bufferUsed = 0;
+	const Sink* m_sink = nullptr;
+};
+
+} // namespace telemetry
@@ -0,0 +1,133 @@
+/**
+ * @file
+ * @author Pavel Siska <siska@cesnet.cz>
+ * @brief Export of telemetry content and directories to JSON
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#pragma once
+
+#include "content.hpp"
+#include "contentWriter.hpp"
+#include "directory.hpp"
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace telemetry {
+
+/**
+ * @brief Writer that renders content to JSON.
+ *
+ * Types of values are preserved:
+ * - unsigned and signed integers are written as integer numbers,
+ * - floating point numbers always contain a decimal point or an exponent (non-finite values
+ *   are written as null as JSON doesn't support them),
+ * - booleans as true/false, unknown (N/A) values as null and strings as JSON strings,
+ * - arrays as JSON arrays and dictionaries as JSON objects,
+ * - tables as JSON objects whose keys are names of columns and values are JSON arrays,
+ * - histograms as JSON objects with the count, the sum, the minimum, the maximum, the unit
+ *   (if any) and non-empty buckets as `[lower, upper, count]` arrays,
+ * - quantile sketches as JSON objects with the same fields as histograms, the relative
+ *   accuracy and the number of zeros (bounds of buckets are doubles, lower bounds are
+ *   exclusive),
+ * - HyperLogLogs as the estimated number of distinct values (an unsigned integer),
+ * - top-K summaries as JSON objects with the count, the capacity and monitored keys
+ *   as `[key, count, error]` arrays.
+ *
+ * A value with a unit is written as an object with the value and the unit as sibling fields,
+ * e.g. `{"value": 10, "unit": "ms"}`. The same applies to table columns with a unit, e.g.
+ * `{"value": [10, 20], "unit": "ms"}`.
+ *
+ * Unlike other writers, dictionaries can be nested (a dictionary value can be a dictionary),
+ * which allows to export a whole directory tree as a single JSON object. The output is
+ * compact (without whitespaces) and all internal buffers keep their capacity between uses.
+ */
+class JsonContentWriter : public ContentWriter {
+public:
+	using ContentWriter::value;
+
+	void beginDict() override;
+	void key(std::string_view key) override;
+	void endDict() override;
+	void beginArray() override;
+	void endArray() override;
+	void unit(std::string_view unit) override;
+	void value(std::monostate) override;
+	void value(bool value) override;
+	void value(uint64_t value) override;
+	void value(int64_t value) override;
+	void value(double value) override;
+	void value(std::string_view value) override;
+	void table(const Table& table) override;
+	void histogram(const Histogram& histogram) override;
+	void quantileSketch(const QuantileSketch& sketch) override;
+	void topK(const TopK& topK) override;
+
+	/**
+	 * @brief Append already rendered JSON value (e.g. by another JSON writer).
+	 * @param json Valid JSON value
+	 */
+	void rawValue(std::string_view json);
+
+	/**
+	 * @brief Get the rendered JSON.
+	 * @return Rendered JSON (valid until the writer is modified).
+	 */
+	[[nodiscard]] const std::string& str() const noexcept { return m_output; }
+
+	/** @brief Reset the writer and discard the rendered JSON (capacity is kept). */
+	void clear() noexcept;
+
+private:
+	struct Level {
+		bool isArray;
+		bool isEmpty;
+	};
+
+	void beginValue();
+	void endValue();
+
+	std::string m_output;
+	// Open arrays and dictionaries
+	std::vector<Level> m_levels;
+	std::string m_unit;
+	bool m_hasUnit = false;
+};
+
+/**
+ * @brief Convert telemetry @p content to JSON.
+ *
+ * @param content Telemetry content
+ * @return JSON representation of the content (see JsonContentWriter)
+ */
+std::string contentToJson(const Content& content);
+
+/**
+ * @brief Write a directory tree to the JSON @p writer.
+ *
+ * The directory is written as a JSON object whose keys are names of its entries. Files are
+ * written as JSON representations of their content and subdirectories as nested objects.
+ * Files without read operation and symbolic links are skipped. If a read of a file fails,
+ * the file is written as null and the export continues.
+ *
+ * All files are read in a single pass, so the whole subtree is exported by one call instead
+ * of reading each file separately.
+ *
+ * @param writer JSON writer
+ * @param dir Root directory of the exported tree
+ */
+void writeDirectoryJson(JsonContentWriter& writer, const std::shared_ptr<Directory>& dir);
+
+/**
+ * @brief Export a directory tree to JSON.
+ *
+ * @param dir Root directory of the exported tree
+ * @return JSON object representing the tree (see writeDirectoryJson())
+ */
+std::string directoryToJson(const std::shared_ptr<Directory>& dir);
+
+} // namespace telemetry
@@ -0,0 +1,161 @@
+/**
+ * @file
+ * @author Pavel Siska <siska@cesnet.cz>
+ * @brief Export of telemetry directories in the OpenMetrics text format
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#pragma once
+
+#include "contentWriter.hpp"
+#include "directory.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace telemetry {
+
+/**
+ * @brief Exporter of a directory tree in the OpenMetrics (Prometheus) text exposition format.
+ *
+ * Each numeric value of a file becomes a sample of a gauge. The metric name is composed of
+ * the prefix, names of directories on the path, the file name, the dictionary key (for
+ * dictionaries) and the unit (for values with a unit), joined by underscores. Characters
+ * not allowed in metric names are replaced by underscores. Elements of arrays are
+ * distinguished by the "index" label. Booleans are exported as 1 and 0, strings and unknown
+ * values are skipped.
+ *
+ * A file with a histogram is exported as a metric family of the histogram type, i.e. with
+ * cumulative `_bucket` samples of non-empty buckets (the "le" label is the upper bound
+ * of the bucket) followed by the `+Inf` bucket, `_count` and `_sum` samples. A file with
+ * a quantile sketch is exported as a metric family of the summary type, i.e. with samples
+ * of values at quantiles 0.5, 0.9, 0.99 and 0.999 (the "quantile" label, omitted if the sketch
+ * is empty) followed by `_count` and `_sum` samples. A file with a top-K summary is exported
+ * as a gauge with a sample of each monitored key (the "key" label) and its count.
+ *
+ * Names of selected directories can be turned into labels by setLabelDirectory(). For
+ * example, if entries of the "queues" directory are label directories with the label
+ * "queue", the file "queues/0/packets" is exported as `queues_packets{queue="0"}`.
+ *
+ * Samples are grouped into metric families sorted by names as required by the format.
+ * All buffers are owned by the exporter and keep their capacity between exports, so
+ * periodic exports of the same tree don't allocate memory per metric.
+ *
+ * The exporter is not thread-safe, use a separate instance for each thread.
+ */
+class OpenMetricsExporter : private ContentWriter {
+public:
+	/**
+	 * @brief Create an exporter.
+	 * @param prefix Prefix of all metric names (e.g. the name of the application)
+	 */
+	explicit OpenMetricsExporter(std::string_view prefix = {});
+
+	/**
+	 * @brief Export names of entries of a directory as values of a label.
+	 *
+	 * Entries of each directory with the @p directoryName are not added to metric names,
+	 * their names are used as values of the label @p labelName instead.
+	 *
+	 * @param directoryName Name of the directory whose entries are turned into labels
+	 * @param labelName Name of the label
+	 */
+	void setLabelDirectory(std::string_view directoryName, std::string_view labelName);
+
+	/**
+	 * @brief Export a directory tree.
+	 *
+	 * Files whose read operation fails are skipped.
+	 *
+	 * @param dir Root directory of the exported tree (its name is not a part of metric names)
+	 * @return Exported metrics terminated by "# EOF" (valid until the next export).
+	 */
+	const std::string& exportDirectory(const std::shared_ptr<Directory>& dir);
+
+	/**
+	 * @brief Get the output of the last export.
+	 * @return Exported metrics (valid until the next export).
+	 */
+	[[nodiscard]] const std::string& str() const noexcept { return m_output; }
+
+private:
+	enum class MetricType : uint8_t { GAUGE, HISTOGRAM, SUMMARY };
+
+	// Sample stored in the scratch buffer as the family name, the suffix of the sample name,
+	// labels and the value. Only samples of histograms and summaries have a suffix.
+	struct Sample {
+		MetricType type;
+		size_t offset;
+		size_t familyLength;
+		size_t suffixLength;
+		size_t unitLength;
+		size_t labelsLength;
+		size_t valueLength;
+	};
+
+	struct Level {
+		size_t nameLength;
+		size_t labelsLength;
+		// Label of entries of the directory (empty if they are not turned into labels)
+		std::string_view entryLabel;
+	};
+
+	void beginDict() override;
+	void key(std::string_view key) override;
+	void endDict() override;
+	void beginArray() override;
+	void endArray() override;
+	void unit(std::string_view unit) override;
+	void value(std::monostate) override;
+	void value(bool value) override;
+	void value(uint64_t value) override;
+	void value(int64_t value) override;
+	void value(double value) override;
+	void value(std::string_view value) override;
+	void histogram(const Histogram& histogram) override;
+	void quantileSketch(const QuantileSketch& sketch) override;
+	void topK(const TopK& topK) override;
+
+	friend class OpenMetricsVisitor;
+
+	void enterEntry(std::string_view name);
+	void leaveEntry();
+	void visitFile(File& file);
+
+	template <typename T>
+	void addSample(
+		T value,
+		MetricType type = MetricType::GAUGE,
+		std::string_view suffix = {},
+		std::string_view labelName = {},
+		std::string_view labelValue = {});
+	void render();
+
+	[[nodiscard]] std::string_view family(const Sample& sample) const;
+
+	std::string m_prefix;
+	std::vector<std::pair<std::string, std::string>> m_labelDirectories;
+
+	// Name and labels of the currently visited entry
+	std::string m_name;
+	std::string m_labels;
+	std::vector<Level> m_levels;
+
+	// State of the currently read file
+	std::string m_key;
+	std::string m_unit;
+	bool m_inArray = false;
+	uint64_t m_arrayIndex = 0;
+
+	std::string m_scratch;
+	std::vector<Sample> m_samples;
+	std::string m_output;
+};
+
+} // namespace telemetry
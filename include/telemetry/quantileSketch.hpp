@@ -0,0 +1,168 @@
+/**
+ * @file
+ * @author Pavel Siska <siska@cesnet.cz>
+ * @brief Mergeable quantile sketch of telemetry values
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#pragma once
+
+#include "contentAllocator.hpp"
+#include "symbol.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string_view>
+#include <vector>
+
+namespace telemetry {
+
+/**
+ * @brief Quantile sketch of non-negative values with a relative error guarantee (DDSketch).
+ *
+ * A positive value @p v belongs to the bucket with the index `ceil(log_gamma(v))` where
+ * `gamma = (1 + a) / (1 - a)` and @p a is the relative accuracy, so any value at a quantile
+ * differs from the exact value by at most a * 100 % (e.g. 1 % for the default accuracy).
+ * Zeros are counted separately.
+ *
+ * Unlike Histogram, values are doubles and buckets are created only for the range of recorded
+ * values. The number of buckets is limited, when the limit is exceeded, the lowest buckets are
+ * collapsed into one, so the sketch stays bounded in memory regardless of the number of values
+ * and only the accuracy of the lowest quantiles is lost.
+ *
+ * Besides buckets, the sketch keeps the exact sum, minimum and maximum of all recorded values.
+ * Sketches of the same unit and relative accuracy can be merged, e.g. sketches of several
+ * files are merged by the MERGE aggregation method and their quantiles are reported by
+ * the QUANTILES aggregation method.
+ *
+ * The sketch is not thread-safe.
+ *
+ * Allocates from the content memory resource of the creating thread (see ContentResourceScope).
+ */
+class QuantileSketch {
+public:
+	/** @brief Default relative accuracy. */
+	static constexpr double DEFAULT_RELATIVE_ACCURACY = 0.01;
+	/** @brief Minimal relative accuracy (indices of all doubles must fit into int32_t). */
+	static constexpr double MIN_RELATIVE_ACCURACY = 1e-6;
+	/** @brief Default maximal number of buckets (17 orders of magnitude at 1 %). */
+	static constexpr uint32_t DEFAULT_MAX_BUCKETS = 2048;
+
+	/** @brief Counts of consecutive buckets. */
+	using Counts = std::vector<uint64_t, ContentAllocator<uint64_t>>;
+
+	/**
+	 * @brief Create an empty sketch.
+	 * @param unit Unit of values (empty if there is no unit)
+	 * @param relativeAccuracy Relative accuracy in the range [MIN_RELATIVE_ACCURACY, 1)
+	 * @param maxBuckets Maximal number of buckets (at least 1)
+	 * @throw TelemetryException if the relative accuracy or the number of buckets is invalid.
+	 */
+	explicit QuantileSketch(
+		std::string_view unit = {},
+		double relativeAccuracy = DEFAULT_RELATIVE_ACCURACY,
+		uint32_t maxBuckets = DEFAULT_MAX_BUCKETS);
+
+	/**
+	 * @brief Create a sketch from its parts (e.g. when it is decoded).
+	 *
+	 * @param unit Unit of values (empty if there is no unit)
+	 * @param relativeAccuracy Relative accuracy
+	 * @param maxBuckets Maximal number of buckets
+	 * @param offset Index of the first bucket
+	 * @param counts Counts of consecutive buckets (the first and the last are non-zero)
+	 * @param zeroCount Number of zero values
+	 * @param sum Sum of all values
+	 * @param min Minimal value (ignored if the sketch is empty)
+	 * @param max Maximal value (ignored if the sketch is empty)
+	 * @throw TelemetryException if the parts are not consistent.
+	 */
+	static QuantileSketch fromParts(
+		std::string_view unit,
+		double relativeAccuracy,
+		uint32_t maxBuckets,
+		int32_t offset,
+		Counts counts,
+		uint64_t zeroCount,
+		double sum,
+		double min,
+		double max);
+
+	/**
+	 * @brief Record a value.
+	 * @param value Recorded value
+	 * @param count Number of occurrences of the value
+	 * @throw TelemetryException if the value is negative or not finite.
+	 */
+	void record(double value, uint64_t count = 1);
+
+	/**
+	 * @brief Add all values of the @p other sketch.
+	 * @throw TelemetryException if the sketches differ in the unit or the relative accuracy.
+	 */
+	void merge(const QuantileSketch& other);
+
+	/** @brief Get the unit of values. */
+	[[nodiscard]] const Symbol& unit() const noexcept { return m_unit; }
+	/** @brief Get the relative accuracy. */
+	[[nodiscard]] double relativeAccuracy() const noexcept { return m_relativeAccuracy; }
+	/** @brief Get the maximal number of buckets. */
+	[[nodiscard]] uint32_t maxBuckets() const noexcept { return m_maxBuckets; }
+	/** @brief Get the index of the first bucket. */
+	[[nodiscard]] int32_t offset() const noexcept { return m_offset; }
+	/** @brief Get counts of consecutive buckets starting by the bucket offset(). */
+	[[nodiscard]] const Counts& counts() const noexcept { return m_counts; }
+	/** @brief Get the number of zero values. */
+	[[nodiscard]] uint64_t zeroCount() const noexcept { return m_zeroCount; }
+	/** @brief Get the number of recorded values. */
+	[[nodiscard]] uint64_t count() const noexcept { return m_count; }
+	/** @brief Get the sum of recorded values. */
+	[[nodiscard]] double sum() const noexcept { return m_sum; }
+	/** @brief Get the minimal recorded value (0 if the sketch is empty). */
+	[[nodiscard]] double min() const noexcept { return m_count > 0 ? m_min : 0; }
+	/** @brief Get the maximal recorded value (0 if the sketch is empty). */
+	[[nodiscard]] double max() const noexcept { return m_max; }
+	/** @brief Get the mean of recorded values (0 if the sketch is empty). */
+	[[nodiscard]] double mean() const noexcept;
+
+	/**
+	 * @brief Get the value at the @p quantile.
+	 *
+	 * The value is the representative value of the bucket of the value limited by the minimal
+	 * and the maximal value.
+	 *
+	 * @param quantile Quantile in the range [0, 1] (e.g. 0.99 for the 99th percentile)
+	 * @return Value at the quantile (0 if the sketch is empty)
+	 */
+	[[nodiscard]] double valueAtQuantile(double quantile) const noexcept;
+
+	/** @brief Get the index of the bucket of the positive @p value. */
+	[[nodiscard]] int32_t bucketIndex(double value) const noexcept;
+	/** @brief Get the lowest value of the bucket with the @p index (exclusive). */
+	[[nodiscard]] double bucketLowerBound(int32_t index) const noexcept;
+	/** @brief Get the highest value of the bucket with the @p index. */
+	[[nodiscard]] double bucketUpperBound(int32_t index) const noexcept;
+
+	bool operator==(const QuantileSketch& other) const = default;
+
+private:
+	void reshape(int64_t first, int64_t last);
+	[[nodiscard]] double bucketValue(int32_t index) const noexcept;
+
+	Symbol m_unit;
+	double m_relativeAccuracy;
+	uint32_t m_maxBuckets;
+	double m_gamma;
+	double m_logGamma;
+	int32_t m_offset = 0;
+	Counts m_counts;
+	uint64_t m_zeroCount = 0;
+	uint64_t m_count = 0;
+	double m_sum = 0;
+	double m_min = std::numeric_limits<double>::infinity();
+	double m_max = 0;
+};
+
+} // namespace telemetry
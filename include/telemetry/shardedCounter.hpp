@@ -0,0 +1,89 @@
+/**
+ * @file
+ * @author Pavel Siska <siska@cesnet.cz>
+ * @brief Counter sharded across threads
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+namespace telemetry {
+
+/**
+ * @brief Counter incremented by many threads without sharing a cache line between them.
+ *
+ * The counter consists of shards, each one padded to its own cache line. Each thread adds
+ * to the shard given by the order in which the thread first used any sharded counter, so
+ * threads don't contend on the same cache line as long as there are at most as many of them
+ * as shards (e.g. worker threads created at startup). The value of the counter is the sum
+ * of all shards, so reads are more expensive than additions.
+ *
+ * The counter can be registered as a telemetry file by Directory::addCounterFile().
+ */
+class ShardedCounter {
+public:
+	/** @brief Size of the cache line each shard is padded to. */
+	static constexpr size_t CACHE_LINE_SIZE = 64;
+
+	/**
+	 * @brief Create a counter with the value 0.
+	 * @param shardCount Minimal number of shards (rounded up to a power of two), the number
+	 *   of hardware threads if zero
+	 */
+	explicit ShardedCounter(size_t shardCount = 0);
+
+	/**
+	 * @brief Add the @p value to the counter (thread-safe and lock-free).
+	 * @param value Added value
+	 */
+	void add(uint64_t value = 1) noexcept
+	{
+		m_shards[threadIndex() & m_shardMask].value.fetch_add(value, std::memory_order_relaxed);
+	}
+
+	/**
+	 * @brief Get the value of the counter.
+	 *
+	 * Additions concurrent with the read might not be included.
+	 */
+	[[nodiscard]] uint64_t value() const noexcept;
+
+	/**
+	 * @brief Reset the counter to 0.
+	 *
+	 * Shards are reset by atomic exchanges, so each concurrent addition is either included
+	 * in the returned value or kept in the counter, it is never lost. Reads and resets are
+	 * serialized, a read never observes a partially reset counter.
+	 *
+	 * @return Value of the counter before the reset
+	 */
+	uint64_t reset() noexcept;
+
+	/** @brief Get the number of shards. */
+	[[nodiscard]] size_t shardCount() const noexcept { return m_shardMask + 1; }
+
+private:
+	struct alignas(CACHE_LINE_SIZE) Shard {
+		std::atomic<uint64_t> value = 0;
+	};
+
+	static size_t threadIndex() noexcept
+	{
+		static std::atomic<size_t> nextIndex = 0;
+		thread_local const size_t index = nextIndex.fetch_add(1, std::memory_order_relaxed);
+		return index;
+	}
+
+	size_t m_shardMask;
+	std::unique_ptr<Shard[]> m_shards;
+	mutable std::mutex m_mutex;
+};
+
+} // namespace telemetry
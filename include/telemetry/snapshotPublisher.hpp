@@ -0,0 +1,164 @@
+/**
+ * @file
+ * @author Pavel Siska <siska@cesnet.cz>
+ * @brief Consistent snapshots of a structure published by a producer thread
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#pragma once
+
+#include "content.hpp"
+#include "file.hpp"
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace telemetry {
+
+/**
+ * @brief Buffer of bytes written by a single writer and read by any number of readers
+ *   without locks (sequence lock).
+ *
+ * The writer increments a sequence number before and after it copies the bytes into the buffer,
+ * so the sequence number is odd while the buffer is written. A reader copies the bytes out of
+ * the buffer and retries if the sequence number was odd or changed during the copy. The bytes
+ * are stored as atomic words, so concurrent copies are not data races.
+ *
+ * Stores are wait-free, a reader never blocks the writer. A load is retried only while a store
+ * is in progress. Stores must not be concurrent, i.e. there must be a single writer (or the
+ * writers must be serialized).
+ *
+ * Type-safe interface is provided by SnapshotPublisher.
+ */
+class SnapshotBuffer {
+public:
+	/**
+	 * @brief Create a buffer filled by zero bytes.
+	 * @param size Size of the buffer in bytes
+	 */
+	explicit SnapshotBuffer(size_t size);
+
+	/**
+	 * @brief Copy bytes into the buffer (wait-free, single writer).
+	 * @param data Bytes of the size of the buffer
+	 */
+	void store(const void* data) noexcept;
+
+	/**
+	 * @brief Copy bytes of the last completed store out of the buffer (lock-free).
+	 * @param data Destination of the size of the buffer
+	 */
+	void load(void* data) const noexcept;
+
+	/** @brief Get the size of the buffer in bytes. */
+	[[nodiscard]] size_t size() const noexcept { return m_size; }
+
+	/** @brief Get the number of completed stores. */
+	[[nodiscard]] uint64_t version() const noexcept
+	{
+		return m_sequence.load(std::memory_order_acquire) / 2;
+	}
+
+private:
+	size_t m_size;
+	std::unique_ptr<std::atomic<uint64_t>[]> m_words;
+	std::atomic<uint64_t> m_sequence = 0;
+};
+
+/**
+ * @brief Structure published by a producer thread and read consistently by telemetry reads.
+ *
+ * Producers often keep several related values in a structure, which must be read together
+ * (e.g. a sum and a count). A read operation that copies the structure directly races with
+ * the producer, a mutex makes the producer wait for reads. The producer instead publishes
+ * a copy of the structure and reads take a snapshot of the last published copy:
+ *
+ * @code
+ * auto stats = std::make_shared<SnapshotPublisher<Stats>>();
+ * // producer thread
+ * stats->publish(localStats);
+ * // telemetry file
+ * dir->addFile("stats", snapshotFileOps(stats, [](const Stats& stats) { ... return dict; }));
+ * @endcode
+ *
+ * Publication is wait-free, a snapshot is retried only while a publication is in progress
+ * (see SnapshotBuffer). Publications must not be concurrent. The structure must be trivially
+ * copyable, it is copied byte by byte.
+ *
+ * @tparam T Published structure
+ */
+template <typename T>
+class SnapshotPublisher {
+	static_assert(
+		std::is_trivially_copyable_v<T>,
+		"SnapshotPublisher: published structure must be trivially copyable");
+
+public:
+	/** @brief Create a publisher of a value-initialized structure. */
+	SnapshotPublisher()
+		: SnapshotPublisher(T {})
+	{
+	}
+
+	/**
+	 * @brief Create a publisher of the @p value.
+	 * @param value Initially published structure
+	 */
+	explicit SnapshotPublisher(const T& value)
+		: m_buffer(sizeof(T))
+	{
+		m_buffer.store(&value);
+	}
+
+	/**
+	 * @brief Publish a copy of the @p value (wait-free, single producer).
+	 * @param value Published structure
+	 */
+	void publish(const T& value) noexcept { m_buffer.store(&value); }
+
+	/** @brief Get a copy of the last published structure (thread-safe, lock-free). */
+	[[nodiscard]] T snapshot() const noexcept
+	{
+		std::array<std::byte, sizeof(T)> bytes;
+		m_buffer.load(bytes.data());
+		return std::bit_cast<T>(bytes);
+	}
+
+	/** @brief Get the number of publications (including the initial one). */
+	[[nodiscard]] uint64_t version() const noexcept { return m_buffer.version(); }
+
+private:
+	SnapshotBuffer m_buffer;
+};
+
+/**
+ * @brief Create file operations that read snapshots of a published structure.
+ *
+ * The read operation takes a snapshot and converts it by the @p mapping to the content
+ * (typically a Dict), so a read never blocks the producer. The file keeps the publisher alive.
+ *
+ * @param publisher Publisher of the structure
+ * @param mapping Callable converting `const T&` to a value convertible to Content
+ * @return File operations with the read operation set
+ */
+template <typename T, typename Mapping>
+	requires std::invocable<const Mapping&, const T&>
+	&& std::convertible_to<std::invoke_result_t<const Mapping&, const T&>, Content>
+FileOps snapshotFileOps(std::shared_ptr<SnapshotPublisher<T>> publisher, Mapping mapping)
+{
+	FileOps ops;
+	ops.read = [publisher = std::move(publisher), mapping = std::move(mapping)]() {
+		return Content {mapping(publisher->snapshot())};
+	};
+	return ops;
+}
+
+} // namespace telemetry
@@ -0,0 +1,125 @@
+/**
+ * @file
+ * @author Pavel Siska <siska@cesnet.cz>
+ * @brief Interned string
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#pragma once
+
+#include <compare>
+#include <cstddef>
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace telemetry {
+
+class Symbol;
+
+/** @brief Types (other than Symbol) that can be compared with a symbol as strings. */
+template <typename T>
+concept SymbolComparable = std::is_convertible_v<const T&, std::string_view>
+	&& !std::is_same_v<std::remove_cvref_t<T>, Symbol>;
+
+/**
+ * @brief Handle of an interned (immutable) string.
+ *
+ * All symbols with the same text share a single copy of the string stored in a global
+ * process-wide table, so a symbol is only a pointer. Copying a symbol never allocates memory
+ * and two symbols are equal if and only if they point to the same string. Symbols are ordered
+ * lexicographically by their text, same as strings.
+ *
+ * Creating a symbol from a string requires a lookup in the table (and an insertion of new
+ * strings). To avoid the lookup on hot paths, create frequently used symbols once and copy
+ * them afterwards.
+ *
+ * @warning Interned strings are never released. Symbols are intended for a limited set of
+ *   names (e.g. dictionary keys and units), not for arbitrary unbounded data.
+ */
+class Symbol {
+public:
+	/** @brief Create an empty symbol. */
+	Symbol() noexcept
+		: m_str(&emptyString())
+	{
+	}
+
+	/**
+	 * @brief Create a symbol of the string @p str.
+	 * @param str Text of the symbol
+	 */
+	Symbol(std::string_view str);
+	Symbol(const std::string& str)
+		: Symbol(std::string_view(str))
+	{
+	}
+	Symbol(const char* str)
+		: Symbol(std::string_view(str))
+	{
+	}
+
+	/** @brief Get the text of the symbol (valid for the lifetime of the process). */
+	[[nodiscard]] const std::string& str() const noexcept { return *m_str; }
+	[[nodiscard]] std::string_view view() const noexcept { return *m_str; }
+	[[nodiscard]] const char* c_str() const noexcept { return m_str->c_str(); }
+	[[nodiscard]] const char* data() const noexcept { return m_str->data(); }
+	[[nodiscard]] size_t size() const noexcept { return m_str->size(); }
+	[[nodiscard]] size_t length() const noexcept { return m_str->length(); }
+	[[nodiscard]] bool empty() const noexcept { return m_str->empty(); }
+
+	operator const std::string&() const noexcept { return *m_str; }
+	operator std::string_view() const noexcept { return *m_str; }
+
+	friend bool operator==(const Symbol& lhs, const Symbol& rhs) noexcept
+	{
+		return lhs.m_str == rhs.m_str;
+	}
+
+	friend std::strong_ordering operator<=>(const Symbol& lhs, const Symbol& rhs) noexcept
+	{
+		if (lhs.m_str == rhs.m_str) {
+			return std::strong_ordering::equal;
+		}
+		return lhs.view() <=> rhs.view();
+	}
+
+	template <SymbolComparable T>
+	friend bool operator==(const Symbol& lhs, const T& rhs) noexcept
+	{
+		return lhs.view() == std::string_view(rhs);
+	}
+
+	template <SymbolComparable T>
+	friend std::strong_ordering operator<=>(const Symbol& lhs, const T& rhs) noexcept
+	{
+		return lhs.view() <=> std::string_view(rhs);
+	}
+
+private:
+	static const std::string& emptyString() noexcept
+	{
+		static const std::string empty;
+		return empty;
+	}
+
+	const std::string* m_str;
+};
+
+/**
+ * @brief Write the text of the @p symbol to the @p stream.
+ */
+std::ostream& operator<<(std::ostream& stream, const Symbol& symbol);
+
+} // namespace telemetry
+
+template <>
+struct std::hash<telemetry::Symbol> {
+	size_t operator()(const telemetry::Symbol& symbol) const noexcept
+	{
+		return std::hash<const void*> {}(symbol.data());
+	}
+};
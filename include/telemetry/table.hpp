@@ -0,0 +1,162 @@
+/**
+ * @file
+ * @author Pavel Siska <siska@cesnet.cz>
+ * @brief Table of telemetry values stored by columns
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#pragma once
+
+#include "contentAllocator.hpp"
+#include "symbol.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+namespace telemetry {
+
+/**
+ * @brief Column of a table.
+ *
+ * Values of the column are stored in a contiguous vector of a single numeric type.
+ */
+struct TableColumn {
+	/** @brief Vector of column values. */
+	template <typename T>
+	using Values = std::vector<T, ContentAllocator<T>>;
+	/** @brief Values of any supported type. */
+	using Data = std::variant<Values<uint64_t>, Values<int64_t>, Values<double>>;
+
+	Symbol name; ///< Name of the column
+	Symbol unit; ///< Unit of all values of the column (empty if there is no unit)
+	Data data; ///< Values of the column (one per row)
+
+	bool operator==(const TableColumn& other) const = default;
+};
+
+/**
+ * @brief Table of numeric values with named columns.
+ *
+ * The table is stored by columns (struct of arrays), so e.g. 20 counters of 256 queues are
+ * kept in 20 contiguous vectors instead of 5120 separate scalars. All columns have the same
+ * number of rows given when the table is created. Rows are identified by their index.
+ *
+ * Allocates from the content memory resource of the creating thread (see ContentResourceScope).
+ *
+ * @code
+ * Table table(queueCount);
+ * auto packets = table.addColumn<uint64_t>("packets");
+ * auto bytes = table.addColumn<uint64_t>("bytes", "B");
+ * for (size_t queue = 0; queue < queueCount; queue++) {
+ *     packets[queue] = stats[queue].packets;
+ *     bytes[queue] = stats[queue].bytes;
+ * }
+ * @endcode
+ */
+class Table {
+public:
+	/** @brief Columns of the table in the order of their addition. */
+	using Columns = std::vector<TableColumn, ContentAllocator<TableColumn>>;
+
+	/**
+	 * @brief Create a table without columns.
+	 * @param rowCount Number of rows of all columns
+	 */
+	explicit Table(size_t rowCount = 0)
+		: m_rowCount(rowCount)
+	{
+	}
+
+	/**
+	 * @brief Add a column of zero values.
+	 *
+	 * @tparam T Type of values (uint64_t, int64_t or double)
+	 * @param name Unique name of the column
+	 * @param unit Unit of the values (empty if there is no unit)
+	 * @return Values of the column to fill (valid until another column is added)
+	 * @throw TelemetryException if the name is empty or it is already used.
+	 */
+	template <typename T>
+	std::span<T> addColumn(std::string_view name, std::string_view unit = {})
+	{
+		static_assert(
+			std::is_same_v<T, uint64_t> || std::is_same_v<T, int64_t> || std::is_same_v<T, double>,
+			"unsupported type of table column");
+
+		TableColumn& column
+			= insertColumn(name, unit, TableColumn::Values<T>(m_rowCount, T {}));
+		return std::get<TableColumn::Values<T>>(column.data);
+	}
+
+	/**
+	 * @brief Add a column with the given values.
+	 *
+	 * @param name Unique name of the column
+	 * @param data Values of the column (one per row)
+	 * @param unit Unit of the values (empty if there is no unit)
+	 * @throw TelemetryException if the name is empty or it is already used, or the number
+	 *   of values differs from the number of rows.
+	 */
+	void addColumn(std::string_view name, TableColumn::Data data, std::string_view unit = {});
+
+	/** @brief Get the number of rows. */
+	[[nodiscard]] size_t rowCount() const noexcept { return m_rowCount; }
+
+	/** @brief Get all columns of the table. */
+	[[nodiscard]] const Columns& columns() const noexcept { return m_columns; }
+
+	/**
+	 * @brief Find a column by its name.
+	 * @return Pointer to the column or nullptr if there is no such column.
+	 */
+	[[nodiscard]] const TableColumn* findColumn(std::string_view name) const noexcept;
+
+	bool operator==(const Table& other) const = default;
+
+private:
+	TableColumn& insertColumn(std::string_view name, std::string_view unit, TableColumn::Data data);
+
+	size_t m_rowCount;
+	Columns m_columns;
+};
+
+/**
+ * @brief Append human readable string of the @p table to the @p output.
+ *
+ * The table is rendered as aligned columns with a header line of column names (followed
+ * by units in parentheses). It is the same as the output of contentToString() of the table.
+ *
+ * @param output Output buffer
+ * @param table Table to render
+ */
+void appendTableToString(std::string& output, const Table& table);
+
+/**
+ * @brief Append CSV representation of the @p table to the @p output.
+ *
+ * The first record is the header with column names (followed by units in parentheses),
+ * then there is a record for each row. Records are terminated by a line feed, fields are
+ * quoted only if needed and floating point numbers are written in the shortest form that
+ * preserves their value.
+ *
+ * @param output Output buffer
+ * @param table Table to render
+ */
+void appendTableToCsv(std::string& output, const Table& table);
+
+/**
+ * @brief Convert the @p table to CSV.
+ *
+ * @param table Table to render
+ * @return CSV representation of the table (see appendTableToCsv())
+ */
+std::string tableToCsv(const Table& table);
+
+} // namespace telemetry
@@ -0,0 +1,181 @@
+/**
+ * @file
+ * @author Pavel Siska <siska@cesnet.cz>
+ * @brief Mergeable summary of the most frequent keys (heavy hitters)
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#pragma once
+
+#include "contentAllocator.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace telemetry {
+
+/**
+ * @brief Summary of the most frequent keys (e.g. top talkers) by the Space-Saving algorithm.
+ *
+ * The summary monitors at most @p capacity keys with their counts. A key that isn't monitored
+ * replaces the key with the lowest count when the summary is full and inherits its count.
+ * The count of a monitored key is thus never lower than its exact count and it exceeds
+ * the exact count by at most the error of the item. Keys that aren't monitored occurred
+ * at most minCount() times. Any key that occurred more than count() / capacity times is
+ * monitored.
+ *
+ * Summaries can be merged, e.g. summaries of several workers are merged by the MERGE
+ * aggregation method into a summary of all keys with the same guarantees. Unlike joined
+ * arrays of keys, the merged summary doesn't grow with the number of workers.
+ *
+ * The summary is a snapshot of counts, it is not thread-safe. Producers that record keys
+ * from several threads should use TopKRecorder and provide its snapshots.
+ *
+ * Allocates from the content memory resource of the creating thread (see ContentResourceScope).
+ */
+class TopK {
+public:
+	/** @brief Default number of monitored keys. */
+	static constexpr size_t DEFAULT_CAPACITY = 64;
+
+	/** @brief Monitored key. */
+	struct Item {
+		std::string key; ///< Key
+		uint64_t count; ///< Upper bound of the number of occurrences of the key
+		uint64_t error; ///< Maximal overestimation of the count
+
+		bool operator==(const Item& other) const = default;
+	};
+
+	/** @brief Monitored keys sorted by their count (descending) and key. */
+	using Items = std::vector<Item, ContentAllocator<Item>>;
+
+	/**
+	 * @brief Create an empty summary.
+	 * @param capacity Maximal number of monitored keys
+	 * @throw TelemetryException if the capacity is zero.
+	 */
+	explicit TopK(size_t capacity = DEFAULT_CAPACITY);
+
+	/**
+	 * @brief Create a summary from its parts (e.g. when it is decoded).
+	 *
+	 * @param capacity Maximal number of monitored keys
+	 * @param items Monitored keys sorted by their count (descending) and key
+	 * @param count Number of all recorded occurrences
+	 * @throw TelemetryException if the parts are not consistent.
+	 */
+	static TopK fromParts(size_t capacity, Items items, uint64_t count);
+
+	/**
+	 * @brief Record occurrences of a key.
+	 *
+	 * Monitored keys are searched linearly, producers with a high rate of keys should use
+	 * TopKRecorder.
+	 *
+	 * @param key Recorded key
+	 * @param count Number of occurrences of the key
+	 */
+	void record(std::string_view key, uint64_t count = 1);
+
+	/**
+	 * @brief Add all keys of the @p other summary.
+	 *
+	 * A key monitored by only one of the summaries is counted as if it occurred minCount()
+	 * times in the other summary, so counts remain upper bounds of exact counts. The capacity
+	 * of this summary is kept.
+	 */
+	void merge(const TopK& other);
+
+	/** @brief Get the maximal number of monitored keys. */
+	[[nodiscard]] size_t capacity() const noexcept { return m_capacity; }
+	/** @brief Get monitored keys sorted by their count (descending) and key. */
+	[[nodiscard]] const Items& items() const noexcept { return m_items; }
+	/** @brief Get the number of all recorded occurrences. */
+	[[nodiscard]] uint64_t count() const noexcept { return m_count; }
+
+	/**
+	 * @brief Get the maximal number of occurrences of a key that isn't monitored.
+	 * @return The lowest count of monitored keys if the summary is full, 0 otherwise.
+	 */
+	[[nodiscard]] uint64_t minCount() const noexcept;
+
+	bool operator==(const TopK& other) const = default;
+
+private:
+	void insert(Item item);
+
+	size_t m_capacity;
+	Items m_items;
+	uint64_t m_count = 0;
+};
+
+/**
+ * @brief Recorder of keys to a top-K summary from any number of threads.
+ *
+ * Monitored keys are found by a hash table, so recording of a monitored key takes a constant
+ * time. Only a key that replaces another key searches for the key with the lowest count.
+ * Recording is serialized by a mutex, each worker thread should thus preferably use its own
+ * recorder and summaries of workers should be merged by the MERGE aggregation method:
+ *
+ * @code
+ * TopKRecorder talkers;
+ * // worker thread
+ * talkers.record(flow.srcIp, flow.bytes);
+ * // telemetry file
+ * ops.read = [&]() { return talkers.snapshot(); };
+ * @endcode
+ *
+ * Recorded keys are the same as if they were recorded to TopK directly.
+ */
+class TopKRecorder {
+public:
+	/**
+	 * @brief Create a recorder.
+	 * @param capacity Maximal number of monitored keys (see TopK)
+	 * @throw TelemetryException if the capacity is zero.
+	 */
+	explicit TopKRecorder(size_t capacity = TopK::DEFAULT_CAPACITY);
+
+	/**
+	 * @brief Record occurrences of a key (thread-safe).
+	 * @param key Recorded key
+	 * @param count Number of occurrences of the key
+	 */
+	void record(std::string_view key, uint64_t count = 1);
+
+	/** @brief Take a snapshot of recorded keys. */
+	[[nodiscard]] TopK snapshot() const;
+
+	/** @brief Discard all recorded keys. */
+	void reset();
+
+private:
+	struct Counter {
+		uint64_t count;
+		uint64_t error;
+	};
+
+	struct KeyHash {
+		using is_transparent = void;
+
+		size_t operator()(std::string_view key) const noexcept
+		{
+			return std::hash<std::string_view>()(key);
+		}
+	};
+
+	size_t m_capacity;
+	uint64_t m_count = 0;
+	std::unordered_map<std::string, Counter, KeyHash, std::equal_to<>> m_counters;
+	mutable std::mutex m_mutex;
+};
+
+} // namespace telemetry
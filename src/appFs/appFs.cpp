@@ -6,6 +6,9 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#include "appFsCommon.hpp"
+#include "appFsLowLevel.hpp"
+
 #include <appFs.hpp>
 
 #include <cstdlib>
@@ -19,69 +22,14 @@
 
 namespace telemetry::appFs {
 
-static std::string fileContentToString(const std::shared_ptr<File>& file)
-{
-	const Content content = file->read();
-	return contentToString(content) + "\n";
-}
-
-static off_t getMaxFileSize(const std::shared_ptr<File>& file)
-{
-	const size_t blockSize = BUFSIZ;
-
-	if (!file->hasRead()) {
-		return blockSize;
-	}
-
-	constexpr double requiredBlockEmptyCapacityMultiplier = 0.5;
-	constexpr auto requiredCapacity = static_cast<size_t>(
-		static_cast<double>(blockSize) * requiredBlockEmptyCapacityMultiplier);
-
-	const size_t contentSize = fileContentToString(file).size();
-	const size_t blockSizeMultiplier = ((contentSize + requiredCapacity) / blockSize) + 1;
-
-	return static_cast<off_t>(blockSizeMultiplier * blockSize);
-}
-
-static void setSymlinkAttr(struct stat* stbuf)
-{
-	const mode_t symlinkMode = 0777;
-	stbuf->st_mode = S_IFLNK | symlinkMode;
-	stbuf->st_nlink = 1;
-	stbuf->st_size = BUFSIZ;
-	stbuf->st_mtime = time(nullptr);
-}
-
-static void setFileAttr(const std::shared_ptr<File>& file, struct stat* stbuf)
-{
-	stbuf->st_mode = S_IFREG;
-
-	if (file->hasRead()) {
-		const mode_t readMode = 0444;
-		stbuf->st_mode |= readMode;
-	}
-
-	if (file->hasClear()) {
-		const mode_t writeMode = 0222;
-		stbuf->st_mode |= writeMode;
-	}
-
-	stbuf->st_nlink = 1;
-	stbuf->st_size = getMaxFileSize(file);
-	stbuf->st_mtime = time(nullptr);
-}
-
-static void setDirectoryAttr(struct stat* stbuf)
+static const AppFsContext& getContext()
 {
-	const mode_t readExecuteMode = 0555;
-	stbuf->st_mode = S_IFDIR | readExecuteMode;
-	stbuf->st_nlink = 2;
-	stbuf->st_mtime = time(nullptr);
+	return *reinterpret_cast<const AppFsContext*>(fuse_get_context()->private_data);
 }
 
 static std::shared_ptr<Directory> getRootDirectory()
 {
-	return *reinterpret_cast<std::shared_ptr<Directory>*>(fuse_get_context()->private_data);
+	return getContext().rootDirectory;
 }
 
 static int fuseGetAttr(const char* path, struct stat* stbuf, struct fuse_file_info* fileInfo)
@@ -93,22 +41,11 @@ static int fuseGetAttr(const char* path, struct stat* stbuf, struct fuse_file_in
 	const std::shared_ptr<Directory> rootDirectory = getRootDirectory();
 	auto node = utils::getNodeFromPath(rootDirectory, path);
 
-	if (utils::isSymlink(node)) {
-		setSymlinkAttr(stbuf);
-		return 0;
-	}
-
-	if (utils::isFile(node)) {
-		setFileAttr(std::dynamic_pointer_cast<File>(node), stbuf);
-		return 0;
-	}
-
-	if (utils::isDirectory(node)) {
-		setDirectoryAttr(stbuf);
-		return 0;
+	if (!setNodeAttr(node, getContext().fileSizeMode, stbuf)) {
+		return -ENOENT;
 	}
 
-	return -ENOENT;
+	return 0;
 }
 
 static int getAttrCallback(const char* path, struct stat* stbuf, struct fuse_file_info* fileInfo)
@@ -130,6 +67,11 @@ static int fuseOpen(const char* path, struct fuse_file_info* fileInfo)
 		return -ENOENT;
 	}
 
+	if (getContext().fileSizeMode == FileSizeMode::DIRECT_IO) {
+		// Reported size is not valid, the kernel must not cache nor truncate the content.
+		fileInfo->direct_io = 1;
+	}
+
 	fileInfo->fh = reinterpret_cast<uint64_t>(new std::string());
 
 	return 0;
@@ -230,20 +172,10 @@ static int readFile(
 	// NOLINTNEXTLINE (performance-no-int-to-ptr, integer to pointer cast)
 	std::string& cacheBuffer = *reinterpret_cast<std::string*>(fileInfo->fh);
 
-	if (cacheBuffer.empty()) {
-		cacheBuffer = fileContentToString(file);
-	}
-
-	const auto uOffset = static_cast<size_t>(offset);
+	const std::string_view part = getFileContentPart(file, cacheBuffer, size, offset);
+	std::memcpy(buffer, part.data(), part.size());
 
-	if (uOffset >= cacheBuffer.size()) {
-		return 0;
-	}
-
-	const size_t length = std::min(size, cacheBuffer.size() - uOffset);
-	std::memcpy(buffer, cacheBuffer.c_str() + uOffset, length);
-
-	return static_cast<int>(length);
+	return static_cast<int>(part.size());
 }
 
 static int
@@ -330,16 +262,13 @@ static int readlinkCallback(const char* path, char* buffer, size_t size)
 		return -ENOENT;
 	}
 
-	const auto targetNode = std::dynamic_pointer_cast<Symlink>(node)->getTarget();
-	if (targetNode == nullptr) {
+	const std::string relativeTargetPath = getSymlinkRelativeTarget(
+		std::dynamic_pointer_cast<Symlink>(node),
+		std::filesystem::path(path).parent_path());
+	if (relativeTargetPath.empty()) {
 		return -ENOENT;
 	}
 
-	const std::filesystem::path targetPath = targetNode->getFullPath();
-
-	const std::string relativeTargetPath
-		= std::filesystem::relative(targetPath, std::filesystem::path(path).parent_path()).string();
-
 	if (size < relativeTargetPath.size() + 1) {
 		return -ENAMETOOLONG;
 	}
@@ -377,10 +306,8 @@ private:
 	fuse_buf m_buffer {};
 };
 
-static void fuseLoop(struct fuse_session* session)
+static void fuseLoop(struct fuse_session* session, AppFsFuseBuffer& buffer)
 {
-	AppFsFuseBuffer buffer;
-
 	do {
 		const int ret = fuse_session_receive_buf(session, buffer.getBuffer());
 		if (ret == -EINTR) {
@@ -398,9 +325,8 @@ static void fuseLoop(struct fuse_session* session)
 	} while (true);
 }
 
-static void setupFuseSessionFd(struct fuse* fuse)
+static void setupFuseSessionFd(struct fuse_session* session)
 {
-	struct fuse_session* session = fuse_get_session(fuse);
 	const int sessionFd = fuse_session_fd(session);
 
 	int ret = fcntl(sessionFd, F_GETFL, 0);
@@ -416,9 +342,14 @@ static void setupFuseSessionFd(struct fuse* fuse)
 	}
 }
 
-static void pollableFuseLoop(struct fuse* fuse)
+static void pollableFuseLoop(struct fuse_session* session)
 {
-	struct fuse_session* session = fuse_get_session(fuse);
+	/*
+	 * Each worker thread has its own buffer. The session file-descriptor is non-blocking
+	 * and shared by all workers, so a request is always received by exactly one of them
+	 * and the others get EAGAIN.
+	 */
+	AppFsFuseBuffer buffer;
 
 	struct pollfd pfd;
 	pfd.fd = fuse_session_fd(session);
@@ -437,33 +368,40 @@ static void pollableFuseLoop(struct fuse* fuse)
 		}
 
 		if ((pfd.revents & POLLIN) != 0) {
-			fuseLoop(session);
+			fuseLoop(session, buffer);
 		}
 	}
 }
 
-static void tryCatchPollableFuseLoop(struct fuse* fuse)
+static void tryCatchPollableFuseLoop(struct fuse_session* session)
 {
 	try {
-		pollableFuseLoop(fuse);
+		pollableFuseLoop(session);
 	} catch (const std::exception& ex) {
 		std::cerr << ex.what() << std::endl;
 	}
 }
 
-static void fillFuseArgs(struct fuse_args* fuseArgs)
+static void fillFuseArgs(struct fuse_args* fuseArgs, FuseBackend backend)
 {
+	fuse_opt_add_arg(fuseArgs, "appfs");
+	fuse_opt_add_arg(fuseArgs, "-o");
+	fuse_opt_add_arg(fuseArgs, "allow_other");
+
+	if (backend == FuseBackend::INODE) {
+		// Remaining options are options of the high-level API only. The low-level backend
+		// sets the owner and the attribute timeout in its replies.
+		return;
+	}
+
 	const std::string fuseUID = "uid=" + std::to_string(getuid());
 	const std::string fuseGID = "gid=" + std::to_string(getgid());
 
-	fuse_opt_add_arg(fuseArgs, "appfs");
 	fuse_opt_add_arg(fuseArgs, "-o");
 	fuse_opt_add_arg(fuseArgs, fuseUID.c_str());
 	fuse_opt_add_arg(fuseArgs, "-o");
 	fuse_opt_add_arg(fuseArgs, fuseGID.c_str());
 	fuse_opt_add_arg(fuseArgs, "-o");
-	fuse_opt_add_arg(fuseArgs, "allow_other");
-	fuse_opt_add_arg(fuseArgs, "-o");
 	fuse_opt_add_arg(fuseArgs, "attr_timeout=0");
 }
 
@@ -516,18 +454,26 @@ AppFsFuse::AppFsFuse(
 	std::shared_ptr<Directory> rootDirectory,
 	const std::string& mountPoint,
 	bool tryToUnmountOnStart,
-	bool createMountPoint)
+	bool createMountPoint,
+	FileSizeMode fileSizeMode,
+	size_t threadCount,
+	FuseBackend backend)
+	: m_threadCount(threadCount)
 {
-	m_rootDirectory = std::move(rootDirectory);
-	if (m_rootDirectory == nullptr) {
+	if (rootDirectory == nullptr) {
 		throw std::runtime_error("Root directory is not set.");
 	}
 
-	FuseArgs fuseArgs;
-	fillFuseArgs(fuseArgs.get());
+	if (m_threadCount == 0) {
+		throw std::runtime_error("Number of FUSE threads must be greater than zero.");
+	}
 
-	struct fuse_operations fuseOps = {};
-	setFuseOperations(&fuseOps);
+	m_context = std::make_unique<AppFsContext>();
+	m_context->rootDirectory = std::move(rootDirectory);
+	m_context->fileSizeMode = fileSizeMode;
+
+	FuseArgs fuseArgs;
+	fillFuseArgs(fuseArgs.get(), backend);
 
 	/**
 	 * If tryToUnmountOnStart is true, this code attempts to unmount the specified mount point using
@@ -544,17 +490,32 @@ AppFsFuse::AppFsFuse(
 		createDirectories(mountPoint);
 	}
 
-	m_fuse.reset(fuse_new(fuseArgs.get(), &fuseOps, sizeof(fuseOps), (void*) &m_rootDirectory));
-	if (m_fuse == nullptr) {
-		throw std::runtime_error("fuse_new() has failed.");
-	}
+	if (backend == FuseBackend::INODE) {
+		m_session.reset(createLowLevelSession(fuseArgs.get(), *m_context));
+		if (m_session == nullptr) {
+			throw std::runtime_error("fuse_session_new() has failed.");
+		}
 
-	const int ret = fuse_mount(m_fuse.get(), mountPoint.c_str());
-	if (ret < 0) {
-		throw std::runtime_error("fuse_mount() has failed.");
+		const int ret = fuse_session_mount(m_session.get(), mountPoint.c_str());
+		if (ret != 0) {
+			throw std::runtime_error("fuse_session_mount() has failed.");
+		}
+	} else {
+		struct fuse_operations fuseOps = {};
+		setFuseOperations(&fuseOps);
+
+		m_fuse.reset(fuse_new(fuseArgs.get(), &fuseOps, sizeof(fuseOps), (void*) m_context.get()));
+		if (m_fuse == nullptr) {
+			throw std::runtime_error("fuse_new() has failed.");
+		}
+
+		const int ret = fuse_mount(m_fuse.get(), mountPoint.c_str());
+		if (ret < 0) {
+			throw std::runtime_error("fuse_mount() has failed.");
+		}
 	}
 
-	setupFuseSessionFd(m_fuse.get());
+	setupFuseSessionFd(getSession());
 }
 
 void AppFsFuse::start()
@@ -563,17 +524,22 @@ void AppFsFuse::start()
 		throw std::runtime_error("AppFsFuse::start() has already been called");
 	}
 
-	m_fuseThread = std::thread([&]() { tryCatchPollableFuseLoop(m_fuse.get()); });
+	for (size_t idx = 0; idx < m_threadCount; idx++) {
+		m_fuseThreads.emplace_back([&]() { tryCatchPollableFuseLoop(getSession()); });
+	}
+
 	m_isStarted = true;
 }
 
 void AppFsFuse::stop()
 {
 	unmount();
-	fuse_exit(m_fuse.get());
+	fuse_session_exit(getSession());
 
-	if (m_fuseThread.joinable()) {
-		m_fuseThread.join();
+	for (auto& fuseThread : m_fuseThreads) {
+		if (fuseThread.joinable()) {
+			fuseThread.join();
+		}
 	}
 }
 
@@ -581,12 +547,27 @@ void AppFsFuse::unmount()
 {
 	if (m_fuse != nullptr) {
 		fuse_unmount(m_fuse.get());
+	} else if (m_session != nullptr) {
+		fuse_session_unmount(m_session.get());
 	}
 }
 
+struct fuse_session* AppFsFuse::getSession()
+{
+	if (m_fuse != nullptr) {
+		return fuse_get_session(m_fuse.get());
+	}
+
+	return m_session.get();
+}
+
 AppFsFuse::~AppFsFuse()
 {
 	stop();
 }
 
 } // namespace telemetry::appFs
+
+#ifdef TELEMETRY_ENABLE_TESTS
+#include "tests/testAppFs.cpp"
+#endif
@@ -0,0 +1,144 @@
+/**
+ * @file
+ * @brief Implementation of helpers shared by the FUSE backends of AppFs
+ * @author Pavel Siska <siska@cesnet.cz>
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "appFsCommon.hpp"
+
+#include "appFsLowLevel.hpp"
+
+#include <cstdio>
+#include <ctime>
+
+namespace telemetry::appFs {
+
+AppFsContext::AppFsContext() = default;
+AppFsContext::~AppFsContext() = default;
+
+/**
+ * @brief Render the file content by the writer reused by all reads of the calling thread.
+ * @return Rendered content (without the trailing newline) valid until the next render.
+ */
+static const std::string& renderFileContent(const std::shared_ptr<File>& file)
+{
+	thread_local TextContentWriter writer;
+
+	writer.clear();
+	file->readTo(writer);
+	return writer.str();
+}
+
+static off_t getMaxFileSize(const std::shared_ptr<File>& file)
+{
+	const size_t blockSize = BUFSIZ;
+
+	if (!file->hasRead()) {
+		return blockSize;
+	}
+
+	constexpr double requiredBlockEmptyCapacityMultiplier = 0.5;
+	constexpr auto requiredCapacity = static_cast<size_t>(
+		static_cast<double>(blockSize) * requiredBlockEmptyCapacityMultiplier);
+
+	const size_t contentSize = renderFileContent(file).size() + 1;
+	const size_t blockSizeMultiplier = ((contentSize + requiredCapacity) / blockSize) + 1;
+
+	return static_cast<off_t>(blockSizeMultiplier * blockSize);
+}
+
+static void setSymlinkAttr(struct stat* stbuf)
+{
+	const mode_t symlinkMode = 0777;
+	stbuf->st_mode = S_IFLNK | symlinkMode;
+	stbuf->st_nlink = 1;
+	stbuf->st_size = BUFSIZ;
+	stbuf->st_mtime = time(nullptr);
+}
+
+static void
+setFileAttr(const std::shared_ptr<File>& file, FileSizeMode fileSizeMode, struct stat* stbuf)
+{
+	stbuf->st_mode = S_IFREG;
+
+	if (file->hasRead()) {
+		const mode_t readMode = 0444;
+		stbuf->st_mode |= readMode;
+	}
+
+	if (file->hasClear()) {
+		const mode_t writeMode = 0222;
+		stbuf->st_mode |= writeMode;
+	}
+
+	stbuf->st_nlink = 1;
+	stbuf->st_size = fileSizeMode == FileSizeMode::RENDER ? getMaxFileSize(file) : 0;
+	stbuf->st_mtime = time(nullptr);
+}
+
+static void setDirectoryAttr(struct stat* stbuf)
+{
+	const mode_t readExecuteMode = 0555;
+	stbuf->st_mode = S_IFDIR | readExecuteMode;
+	stbuf->st_nlink = 2;
+	stbuf->st_mtime = time(nullptr);
+}
+
+bool setNodeAttr(const std::shared_ptr<Node>& node, FileSizeMode fileSizeMode, struct stat* stbuf)
+{
+	if (utils::isSymlink(node)) {
+		setSymlinkAttr(stbuf);
+		return true;
+	}
+
+	if (utils::isFile(node)) {
+		setFileAttr(std::dynamic_pointer_cast<File>(node), fileSizeMode, stbuf);
+		return true;
+	}
+
+	if (utils::isDirectory(node)) {
+		setDirectoryAttr(stbuf);
+		return true;
+	}
+
+	return false;
+}
+
+std::string_view getFileContentPart(
+	const std::shared_ptr<File>& file,
+	std::string& cacheBuffer,
+	size_t size,
+	off_t offset)
+{
+	if (cacheBuffer.empty()) {
+		const std::string& content = renderFileContent(file);
+		cacheBuffer.reserve(content.size() + 1);
+		cacheBuffer.append(content);
+		cacheBuffer.append("\n");
+	}
+
+	const auto uOffset = static_cast<size_t>(offset);
+
+	if (uOffset >= cacheBuffer.size()) {
+		return {};
+	}
+
+	const size_t length = std::min(size, cacheBuffer.size() - uOffset);
+	return std::string_view(cacheBuffer).substr(uOffset, length);
+}
+
+std::string
+getSymlinkRelativeTarget(const std::shared_ptr<Symlink>& symlink, const std::filesystem::path& symlinkDir)
+{
+	const auto targetNode = symlink->getTarget();
+	if (targetNode == nullptr) {
+		return {};
+	}
+
+	const std::filesystem::path targetPath = targetNode->getFullPath();
+	return std::filesystem::relative(targetPath, symlinkDir).string();
+}
+
+} // namespace telemetry::appFs
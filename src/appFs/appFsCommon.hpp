@@ -0,0 +1,80 @@
+/**
+ * @file
+ * @brief Helpers shared by the FUSE backends of AppFs
+ * @author Pavel Siska <siska@cesnet.cz>
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#pragma once
+
+#include <appFs.hpp>
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <sys/stat.h>
+#include <telemetry.hpp>
+
+namespace telemetry::appFs {
+
+class InodeTable;
+
+/**
+ * @brief Data shared by all FUSE callbacks (FUSE private data).
+ */
+struct AppFsContext {
+	AppFsContext();
+	~AppFsContext();
+
+	AppFsContext(const AppFsContext& other) = delete;
+	AppFsContext& operator=(const AppFsContext& other) = delete;
+	AppFsContext(AppFsContext&& other) = delete;
+	AppFsContext& operator=(AppFsContext&& other) = delete;
+
+	std::shared_ptr<Directory> rootDirectory;
+	FileSizeMode fileSizeMode = FileSizeMode::RENDER;
+	/** Inode to node mapping, used only by the FuseBackend::INODE backend. */
+	std::unique_ptr<InodeTable> inodeTable;
+};
+
+/**
+ * @brief Fill attributes of a telemetry @p node.
+ *
+ * @param node Telemetry node (file, directory or symlink).
+ * @param fileSizeMode Strategy used to report the size of telemetry files.
+ * @param stbuf Attributes to fill.
+ * @return False if the node is not valid (e.g. nullptr), true otherwise.
+ */
+bool setNodeAttr(const std::shared_ptr<Node>& node, FileSizeMode fileSizeMode, struct stat* stbuf);
+
+/**
+ * @brief Get a part of the rendered file content.
+ *
+ * The content of the @p file is rendered into @p cacheBuffer on the first call, following
+ * calls with the same buffer return parts of the previously rendered content.
+ *
+ * @param file Telemetry file supporting the read operation.
+ * @param cacheBuffer Buffer with the rendered content (bound to an opened file).
+ * @param size Maximum size of the part.
+ * @param offset Offset of the part in the content.
+ * @return View of the part (empty if the offset is beyond the end of the content).
+ */
+std::string_view getFileContentPart(
+	const std::shared_ptr<File>& file,
+	std::string& cacheBuffer,
+	size_t size,
+	off_t offset);
+
+/**
+ * @brief Get the target of a @p symlink relative to the directory @p symlinkDir.
+ *
+ * @param symlink Telemetry symlink.
+ * @param symlinkDir Path of the directory that contains the symlink.
+ * @return Relative path or an empty string if the target doesn't exist anymore.
+ */
+std::string
+getSymlinkRelativeTarget(const std::shared_ptr<Symlink>& symlink, const std::filesystem::path& symlinkDir);
+
+} // namespace telemetry::appFs
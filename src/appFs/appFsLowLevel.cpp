@@ -0,0 +1,471 @@
+/**
+ * @file
+ * @brief Implementation of the low-level (inode based) FUSE backend of AppFs
+ * @author Pavel Siska <siska@cesnet.cz>
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "appFsLowLevel.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+namespace telemetry::appFs {
+
+/**
+ * Attributes are not cached by the kernel at all (same as "attr_timeout=0" of the high-level
+ * backend), so file permissions and sizes are always up to date.
+ */
+static constexpr double g_ATTR_TIMEOUT = 0.0;
+
+/**
+ * Name to inode mapping is cached by the kernel for a short period of time. Thanks to that
+ * the kernel doesn't have to look up every path segment on each open.
+ */
+static constexpr double g_ENTRY_TIMEOUT = 1.0;
+
+/** Inode number of directory entries that have not been looked up yet. */
+static constexpr fuse_ino_t g_UNKNOWN_INODE = 0xffffffff;
+
+InodeTable::InodeTable(std::shared_ptr<Directory> rootDirectory)
+	: m_rootDirectory(std::move(rootDirectory))
+{
+}
+
+std::shared_ptr<Node> InodeTable::getNode(fuse_ino_t inode)
+{
+	if (inode == FUSE_ROOT_ID) {
+		return m_rootDirectory;
+	}
+
+	const std::shared_lock lock(m_mutex);
+
+	auto iter = m_entries.find(inode);
+	if (iter == m_entries.end()) {
+		return nullptr;
+	}
+
+	return iter->second.node.lock();
+}
+
+fuse_ino_t InodeTable::addLookup(const std::shared_ptr<Node>& node)
+{
+	if (node == m_rootDirectory) {
+		return FUSE_ROOT_ID;
+	}
+
+	const std::lock_guard lock(m_mutex);
+
+	if (auto iter = m_inodes.find(node.get()); iter != m_inodes.end()) {
+		auto& entry = m_entries.at(iter->second);
+
+		// The address might belong to an already destroyed node that has not been forgotten
+		if (entry.node.lock() == node) {
+			entry.lookupCount++;
+			return iter->second;
+		}
+	}
+
+	const fuse_ino_t inode = m_nextInode++;
+	m_entries.emplace(inode, Entry {node, node.get(), 1});
+	m_inodes.insert_or_assign(node.get(), inode);
+
+	return inode;
+}
+
+void InodeTable::forget(fuse_ino_t inode, uint64_t lookupCount)
+{
+	if (inode == FUSE_ROOT_ID) {
+		return;
+	}
+
+	const std::lock_guard lock(m_mutex);
+
+	auto iter = m_entries.find(inode);
+	if (iter == m_entries.end()) {
+		return;
+	}
+
+	auto& entry = iter->second;
+	if (entry.lookupCount > lookupCount) {
+		entry.lookupCount -= lookupCount;
+		return;
+	}
+
+	// The address might have been already reused by a newer node with another inode
+	auto nodeIter = m_inodes.find(entry.address);
+	if (nodeIter != m_inodes.end() && nodeIter->second == inode) {
+		m_inodes.erase(nodeIter);
+	}
+
+	m_entries.erase(iter);
+}
+
+/**
+ * @brief Opened directory with a snapshot of its entries.
+ */
+struct DirectoryHandle {
+	struct Entry {
+		std::string name;
+		mode_t type;
+	};
+
+	std::vector<Entry> entries;
+};
+
+static AppFsContext& getContext(fuse_req_t req)
+{
+	return *static_cast<AppFsContext*>(fuse_req_userdata(req));
+}
+
+static std::shared_ptr<Node> getNode(fuse_req_t req, fuse_ino_t inode)
+{
+	return getContext(req).inodeTable->getNode(inode);
+}
+
+static bool fillAttr(fuse_req_t req, const std::shared_ptr<Node>& node, struct stat* stbuf)
+{
+	std::memset(stbuf, 0, sizeof(struct stat));
+
+	if (!setNodeAttr(node, getContext(req).fileSizeMode, stbuf)) {
+		return false;
+	}
+
+	stbuf->st_uid = getuid();
+	stbuf->st_gid = getgid();
+	return true;
+}
+
+/**
+ * @brief Execute an operation and reply with an error if the operation fails.
+ *
+ * The operation must return zero if it has replied to the request, otherwise it must
+ * return a positive error number.
+ */
+template <typename Operation>
+static void replyOnError(fuse_req_t req, Operation&& operation)
+{
+	int error;
+
+	try {
+		error = operation();
+	} catch (std::exception& ex) {
+		std::cerr << ex.what() << std::endl;
+		error = EINVAL;
+	}
+
+	if (error != 0) {
+		fuse_reply_err(req, error);
+	}
+}
+
+static int fuseLookup(fuse_req_t req, fuse_ino_t parent, const char* name)
+{
+	auto directory = std::dynamic_pointer_cast<Directory>(getNode(req, parent));
+	if (directory == nullptr) {
+		return ENOENT;
+	}
+
+	auto node = directory->getEntry(name);
+
+	struct fuse_entry_param entryParam = {};
+	if (!fillAttr(req, node, &entryParam.attr)) {
+		return ENOENT;
+	}
+
+	entryParam.ino = getContext(req).inodeTable->addLookup(node);
+	entryParam.attr.st_ino = entryParam.ino;
+	entryParam.attr_timeout = g_ATTR_TIMEOUT;
+	entryParam.entry_timeout = g_ENTRY_TIMEOUT;
+
+	fuse_reply_entry(req, &entryParam);
+	return 0;
+}
+
+static void lookupCallback(fuse_req_t req, fuse_ino_t parent, const char* name)
+{
+	replyOnError(req, [&]() { return fuseLookup(req, parent, name); });
+}
+
+static void forgetCallback(fuse_req_t req, fuse_ino_t inode, uint64_t lookupCount)
+{
+	getContext(req).inodeTable->forget(inode, lookupCount);
+	fuse_reply_none(req);
+}
+
+static int fuseGetAttr(fuse_req_t req, fuse_ino_t inode)
+{
+	struct stat stbuf;
+	if (!fillAttr(req, getNode(req, inode), &stbuf)) {
+		return ENOENT;
+	}
+
+	stbuf.st_ino = inode;
+	fuse_reply_attr(req, &stbuf, g_ATTR_TIMEOUT);
+	return 0;
+}
+
+static void getAttrCallback(fuse_req_t req, fuse_ino_t inode, struct fuse_file_info* fileInfo)
+{
+	(void) fileInfo;
+
+	replyOnError(req, [&]() { return fuseGetAttr(req, inode); });
+}
+
+static int fuseReadlink(fuse_req_t req, fuse_ino_t inode)
+{
+	auto symlink = std::dynamic_pointer_cast<Symlink>(getNode(req, inode));
+	if (symlink == nullptr) {
+		return ENOENT;
+	}
+
+	const std::filesystem::path symlinkPath = symlink->getFullPath();
+	const std::string relativeTargetPath
+		= getSymlinkRelativeTarget(symlink, symlinkPath.parent_path());
+	if (relativeTargetPath.empty()) {
+		return ENOENT;
+	}
+
+	fuse_reply_readlink(req, relativeTargetPath.c_str());
+	return 0;
+}
+
+static void readlinkCallback(fuse_req_t req, fuse_ino_t inode)
+{
+	replyOnError(req, [&]() { return fuseReadlink(req, inode); });
+}
+
+static int fuseOpen(fuse_req_t req, fuse_ino_t inode, struct fuse_file_info* fileInfo)
+{
+	if (!utils::isFile(getNode(req, inode))) {
+		return ENOENT;
+	}
+
+	if (getContext(req).fileSizeMode == FileSizeMode::DIRECT_IO) {
+		// Reported size is not valid, the kernel must not cache nor truncate the content.
+		fileInfo->direct_io = 1;
+	}
+
+	fileInfo->fh = reinterpret_cast<uint64_t>(new std::string());
+
+	if (fuse_reply_open(req, fileInfo) != 0) {
+		// NOLINTNEXTLINE (performance-no-int-to-ptr, integer to pointer cast)
+		delete reinterpret_cast<std::string*>(fileInfo->fh);
+	}
+
+	return 0;
+}
+
+static void openCallback(fuse_req_t req, fuse_ino_t inode, struct fuse_file_info* fileInfo)
+{
+	replyOnError(req, [&]() { return fuseOpen(req, inode, fileInfo); });
+}
+
+static void releaseCallback(fuse_req_t req, fuse_ino_t inode, struct fuse_file_info* fileInfo)
+{
+	(void) inode;
+
+	// NOLINTNEXTLINE (performance-no-int-to-ptr, integer to pointer cast)
+	delete reinterpret_cast<std::string*>(fileInfo->fh);
+	fuse_reply_err(req, 0);
+}
+
+static int
+fuseRead(fuse_req_t req, fuse_ino_t inode, size_t size, off_t offset, struct fuse_file_info* fileInfo)
+{
+	auto file = std::dynamic_pointer_cast<File>(getNode(req, inode));
+	if (file == nullptr) {
+		return ENOENT;
+	}
+
+	if (!file->hasRead()) {
+		return ENOTSUP;
+	}
+
+	// NOLINTNEXTLINE (performance-no-int-to-ptr, integer to pointer cast)
+	std::string& cacheBuffer = *reinterpret_cast<std::string*>(fileInfo->fh);
+
+	const std::string_view part = getFileContentPart(file, cacheBuffer, size, offset);
+	fuse_reply_buf(req, part.data(), part.size());
+	return 0;
+}
+
+static void readCallback(
+	fuse_req_t req,
+	fuse_ino_t inode,
+	size_t size,
+	off_t offset,
+	struct fuse_file_info* fileInfo)
+{
+	replyOnError(req, [&]() { return fuseRead(req, inode, size, offset, fileInfo); });
+}
+
+static int fuseWrite(fuse_req_t req, fuse_ino_t inode, size_t size)
+{
+	auto file = std::dynamic_pointer_cast<File>(getNode(req, inode));
+	if (file == nullptr) {
+		return ENOENT;
+	}
+
+	if (!file->hasClear()) {
+		return ENOTSUP;
+	}
+
+	file->clear();
+
+	fuse_reply_write(req, size);
+	return 0;
+}
+
+static void writeCallback(
+	// NOLINTBEGIN
+	fuse_req_t req,
+	fuse_ino_t inode,
+	const char* buffer,
+	size_t size,
+	off_t offset,
+	// NOLINTEND
+	struct fuse_file_info* fileInfo)
+{
+	(void) buffer;
+	(void) offset;
+	(void) fileInfo;
+
+	replyOnError(req, [&]() { return fuseWrite(req, inode, size); });
+}
+
+static mode_t getNodeType(const std::shared_ptr<Node>& node)
+{
+	if (utils::isSymlink(node)) {
+		return S_IFLNK;
+	}
+
+	if (utils::isDirectory(node)) {
+		return S_IFDIR;
+	}
+
+	return S_IFREG;
+}
+
+static int fuseOpenDir(fuse_req_t req, fuse_ino_t inode, struct fuse_file_info* fileInfo)
+{
+	auto directory = std::dynamic_pointer_cast<Directory>(getNode(req, inode));
+	if (directory == nullptr) {
+		return ENOENT;
+	}
+
+	auto handle = std::make_unique<DirectoryHandle>();
+	handle->entries.push_back({".", S_IFDIR});
+	handle->entries.push_back({"..", S_IFDIR});
+
+	for (auto& name : directory->listEntries()) {
+		auto node = directory->getEntry(name);
+		if (node == nullptr) {
+			continue;
+		}
+
+		handle->entries.push_back({std::move(name), getNodeType(node)});
+	}
+
+	fileInfo->fh = reinterpret_cast<uint64_t>(handle.get());
+
+	if (fuse_reply_open(req, fileInfo) == 0) {
+		handle.release();
+	}
+
+	return 0;
+}
+
+static void openDirCallback(fuse_req_t req, fuse_ino_t inode, struct fuse_file_info* fileInfo)
+{
+	replyOnError(req, [&]() { return fuseOpenDir(req, inode, fileInfo); });
+}
+
+static int fuseReadDir(fuse_req_t req, size_t size, off_t offset, struct fuse_file_info* fileInfo)
+{
+	// NOLINTNEXTLINE (performance-no-int-to-ptr, integer to pointer cast)
+	const auto& handle = *reinterpret_cast<DirectoryHandle*>(fileInfo->fh);
+
+	std::vector<char> buffer(size);
+	size_t bufferUsed = 0;
+
+	for (auto idx = static_cast<size_t>(offset); idx < handle.entries.size(); idx++) {
+		const auto& entry = handle.entries[idx];
+
+		struct stat stbuf = {};
+		stbuf.st_ino = g_UNKNOWN_INODE;
+		stbuf.st_mode = entry.type;
+
+		const size_t entrySize = fuse_add_direntry(
+			req,
+			buffer.data() + bufferUsed,
+			size - bufferUsed,
+			entry.name.c_str(),
+			&stbuf,
+			static_cast<off_t>(idx + 1));
+
+		if (entrySize > size - bufferUsed) {
+			break;
+		}
+
+		bufferUsed += entrySize;
+	}
+
+	fuse_reply_buf(req, buffer.data(), bufferUsed);
+	return 0;
+}
+
+static void readDirCallback(
+	fuse_req_t req,
+	fuse_ino_t inode,
+	size_t size,
+	off_t offset,
+	struct fuse_file_info* fileInfo)
+{
+	(void) inode;
+
+	replyOnError(req, [&]() { return fuseReadDir(req, size, offset, fileInfo); });
+}
+
+static void releaseDirCallback(fuse_req_t req, fuse_ino_t inode, struct fuse_file_info* fileInfo)
+{
+	(void) inode;
+
+	// NOLINTNEXTLINE (performance-no-int-to-ptr, integer to pointer cast)
+	delete reinterpret_cast<DirectoryHandle*>(fileInfo->fh);
+	fuse_reply_err(req, 0);
+}
+
+static void setFuseLowLevelOperations(struct fuse_lowlevel_ops* fuseOps)
+{
+	fuseOps->lookup = lookupCallback;
+	fuseOps->forget = forgetCallback;
+	fuseOps->getattr = getAttrCallback;
+	fuseOps->readlink = readlinkCallback;
+	fuseOps->open = openCallback;
+	fuseOps->read = readCallback;
+	fuseOps->write = writeCallback;
+	fuseOps->release = releaseCallback;
+	fuseOps->opendir = openDirCallback;
+	fuseOps->readdir = readDirCallback;
+	fuseOps->releasedir = releaseDirCallback;
+}
+
+struct fuse_session* createLowLevelSession(struct fuse_args* args, AppFsContext& context)
+{
+	context.inodeTable = std::make_unique<InodeTable>(context.rootDirectory);
+
+	struct fuse_lowlevel_ops fuseOps = {};
+	setFuseLowLevelOperations(&fuseOps);
+
+	return fuse_session_new(args, &fuseOps, sizeof(fuseOps), &context);
+}
+
+} // namespace telemetry::appFs
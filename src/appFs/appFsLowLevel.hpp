@@ -0,0 +1,90 @@
+/**
+ * @file
+ * @brief Low-level (inode based) FUSE backend of AppFs
+ * @author Pavel Siska <siska@cesnet.cz>
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#pragma once
+
+#include "appFsCommon.hpp"
+
+#include <cstdint>
+#include <fuse3/fuse_lowlevel.h>
+#include <memory>
+#include <shared_mutex>
+#include <telemetry.hpp>
+#include <unordered_map>
+
+namespace telemetry::appFs {
+
+/**
+ * @brief Mapping between FUSE inode numbers and telemetry nodes.
+ *
+ * The kernel identifies nodes by inode numbers obtained by the lookup operation. Each looked up
+ * node gets an inode number that stays valid until the kernel forgets it, so all following
+ * requests resolve the node by a single hash table lookup instead of walking its path.
+ *
+ * The table holds only weak references, so a removed telemetry node is never kept alive by
+ * the kernel dentry cache.
+ */
+class InodeTable {
+public:
+	/**
+	 * @brief Create the table with the root directory mapped to FUSE_ROOT_ID.
+	 * @param rootDirectory Telemetry root directory.
+	 */
+	explicit InodeTable(std::shared_ptr<Directory> rootDirectory);
+
+	/**
+	 * @brief Get a node with the given @p inode number.
+	 * @param inode Inode number.
+	 * @return Pointer or nullptr (i.e. unknown inode or the node doesn't exist anymore).
+	 */
+	std::shared_ptr<Node> getNode(fuse_ino_t inode);
+
+	/**
+	 * @brief Get the inode number of a looked up @p node and increase its lookup count.
+	 *
+	 * If the node doesn't have an inode number yet, a new one is assigned.
+	 *
+	 * @param node Telemetry node.
+	 * @return Inode number of the node.
+	 */
+	fuse_ino_t addLookup(const std::shared_ptr<Node>& node);
+
+	/**
+	 * @brief Decrease the lookup count of an @p inode and remove it when it reaches zero.
+	 * @param inode Inode number.
+	 * @param lookupCount Number of lookups to forget.
+	 */
+	void forget(fuse_ino_t inode, uint64_t lookupCount);
+
+private:
+	struct Entry {
+		std::weak_ptr<Node> node;
+		const Node* address;
+		uint64_t lookupCount;
+	};
+
+	std::shared_ptr<Directory> m_rootDirectory;
+
+	std::shared_mutex m_mutex;
+	std::unordered_map<fuse_ino_t, Entry> m_entries;
+	std::unordered_map<const Node*, fuse_ino_t> m_inodes;
+	fuse_ino_t m_nextInode = FUSE_ROOT_ID + 1;
+};
+
+/**
+ * @brief Create a FUSE session that uses the low-level (inode based) API.
+ *
+ * The inode table of the @p context is created by this function.
+ *
+ * @param args FUSE arguments.
+ * @param context Data shared by all FUSE callbacks. Must outlive the session.
+ * @return New FUSE session or nullptr on failure.
+ */
+struct fuse_session* createLowLevelSession(struct fuse_args* args, AppFsContext& context);
+
+} // namespace telemetry::appFs
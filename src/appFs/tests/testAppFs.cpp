@@ -0,0 +1,152 @@
+/**
+ * @file
+ * @author Pavel Siska <siska@cesnet.cz>
+ * @brief Unit tests of telemetry::appFs::AppFsFuse class
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace telemetry::appFs {
+
+static std::string getTestMountPoint()
+{
+	const auto dirName = "telemetryTestAppFs-" + std::to_string(getpid());
+	return (std::filesystem::temp_directory_path() / dirName).string();
+}
+
+static std::string readFileContent(const std::string& path)
+{
+	const std::ifstream file(path);
+	std::stringstream buffer;
+	buffer << file.rdbuf();
+	return buffer.str();
+}
+
+/**
+ * @test Test that a slow read callback doesn't block readers of other files.
+ */
+TEST(AppFsFuse, slowFileDoesNotBlockFastFile)
+{
+	using namespace std::chrono_literals;
+
+	const auto slowReadDuration = 1s;
+	const size_t threadCount = 2;
+	const std::string mountPoint = getTestMountPoint();
+
+	std::atomic<bool> slowReadEntered = false;
+
+	FileOps slowOps {};
+	slowOps.read = [&]() {
+		slowReadEntered = true;
+		std::this_thread::sleep_for(slowReadDuration);
+		return Scalar {uint64_t {1}};
+	};
+
+	FileOps fastOps {};
+	fastOps.read = []() { return Scalar {uint64_t {2}}; };
+
+	auto root = Directory::create();
+	auto slowFile = root->addFile("slow", slowOps);
+	auto fastFile = root->addFile("fast", fastOps);
+
+	std::unique_ptr<AppFsFuse> appFs;
+	try {
+		appFs = std::make_unique<AppFsFuse>(
+			root,
+			mountPoint,
+			false,
+			true,
+			FileSizeMode::DIRECT_IO,
+			threadCount);
+	} catch (const std::exception& ex) {
+		GTEST_SKIP() << "Unable to mount FUSE filesystem: " << ex.what();
+	}
+
+	appFs->start();
+
+	auto slowReader
+		= std::async(std::launch::async, [&]() { return readFileContent(mountPoint + "/slow"); });
+
+	while (!slowReadEntered) {
+		std::this_thread::sleep_for(1ms);
+	}
+
+	const auto start = std::chrono::steady_clock::now();
+	const std::string fastContent = readFileContent(mountPoint + "/fast");
+	const auto elapsed = std::chrono::steady_clock::now() - start;
+
+	EXPECT_EQ("2\n", fastContent);
+	EXPECT_LT(elapsed, slowReadDuration / 2);
+	EXPECT_EQ("1\n", slowReader.get());
+
+	appFs->stop();
+	std::filesystem::remove(mountPoint);
+}
+
+/**
+ * @test Test accessing files, directories and symlinks through the inode based backend.
+ */
+TEST(AppFsFuse, inodeBackend)
+{
+	const std::string mountPoint = getTestMountPoint();
+
+	FileOps statsOps {};
+	statsOps.read = []() { return Dict {{"cpu_usage", ScalarWithUnit {uint64_t {42}, "%"}}}; };
+
+	auto root = Directory::create();
+	auto serverDir = root->addDirs("data_centers/dc1/server1");
+	auto statsFile = serverDir->addFile("stats", statsOps);
+	auto statsLink = root->addSymlink("link", statsFile);
+
+	std::unique_ptr<AppFsFuse> appFs;
+	try {
+		appFs = std::make_unique<AppFsFuse>(
+			root,
+			mountPoint,
+			false,
+			true,
+			FileSizeMode::DIRECT_IO,
+			1,
+			FuseBackend::INODE);
+	} catch (const std::exception& ex) {
+		GTEST_SKIP() << "Unable to mount FUSE filesystem: " << ex.what();
+	}
+
+	appFs->start();
+
+	const std::string statsPath = mountPoint + "/data_centers/dc1/server1/stats";
+	EXPECT_TRUE(std::filesystem::is_regular_file(statsPath));
+	EXPECT_TRUE(std::filesystem::is_directory(mountPoint + "/data_centers/dc1"));
+	EXPECT_FALSE(std::filesystem::exists(mountPoint + "/data_centers/dc2"));
+
+	EXPECT_EQ("cpu_usage: 42 (%)\n", readFileContent(statsPath));
+	EXPECT_EQ("cpu_usage: 42 (%)\n", readFileContent(statsPath));
+
+	std::vector<std::string> entries;
+	for (const auto& entry : std::filesystem::directory_iterator(mountPoint + "/data_centers")) {
+		entries.push_back(entry.path().filename().string());
+	}
+	EXPECT_EQ(std::vector<std::string> {"dc1"}, entries);
+
+	EXPECT_TRUE(std::filesystem::is_symlink(mountPoint + "/link"));
+	EXPECT_EQ(
+		"data_centers/dc1/server1/stats",
+		std::filesystem::read_symlink(mountPoint + "/link").string());
+	EXPECT_EQ("cpu_usage: 42 (%)\n", readFileContent(mountPoint + "/link"));
+
+	appFs->stop();
+	std::filesystem::remove(mountPoint);
+}
+
+} // namespace telemetry::appFs
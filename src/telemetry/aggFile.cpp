@@ -149,6 +149,8 @@ FileOps AggregatedFile::getOps()
 {
 	FileOps ops = {};
 	ops.read = [this]() { return read(); };
+	// Aggregated content is only returned, never kept by the file
+	ops.readArena = true;
 	return ops;
 }
 
@@ -168,7 +170,8 @@ AggregatedFile::AggregatedFile(
 		m_aggMethods.push_back(AggMethodFactory::createAggMethod(
 			aggOp.method,
 			aggOp.dictFieldName,
-			aggOp.dictResultName));
+			aggOp.dictResultName,
+			aggOp.quantiles));
 	}
 }
 
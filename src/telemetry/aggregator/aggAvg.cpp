@@ -45,12 +45,28 @@ static AggMethodSum::ResultType convertToAverage(AggContent& aggContent, size_t
 	throw TelemetryException("Unexpected variant alternative.");
 }
 
+size_t AggMethodAvg::countValues(const std::vector<Content>& contents)
+{
+	size_t count = 0;
+
+	for (const auto& content : contents) {
+		const AggContent aggContent = getAggContent(content);
+		if (std::holds_alternative<Array>(aggContent)) {
+			count += std::get<Array>(aggContent).size();
+		} else {
+			count++;
+		}
+	}
+
+	return count;
+}
+
 Content AggMethodAvg::aggregate(const std::vector<Content>& contents)
 {
 	const Content aggregatedSum = AggMethodSum::aggregate(contents);
 	const bool useDictResultNameAsKey = true;
 	AggContent aggContent = getAggContent(aggregatedSum, useDictResultNameAsKey);
-	const AggMethodSum::ResultType result = convertToAverage(aggContent, contents.size());
+	const AggMethodSum::ResultType result = convertToAverage(aggContent, countValues(contents));
 	return createContent(result);
 }
 
@@ -27,6 +27,10 @@ public:
 	 * @throws TelemetryException if the aggregation encounters an error.
 	 */
 	Content aggregate(const std::vector<Content>& contents) override;
+
+private:
+	// Number of averaged values (elements of arrays are counted separately)
+	size_t countValues(const std::vector<Content>& contents);
 };
 
 } // namespace telemetry
@@ -34,7 +34,7 @@ static ResultType aggregateGatheredValues(const std::vector<AggContent>& values)
 	return result;
 }
 
-static Content createContent(const std::string& dictKey, const ResultType& result)
+static Content createContent(const DictKey& dictKey, const ResultType& result)
 {
 	if (!dictKey.empty()) {
 		return Dict {{dictKey, result}};
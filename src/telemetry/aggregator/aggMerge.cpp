@@ -0,0 +1,66 @@
+/**
+ * @file
+ * @author Pavel Siska <siska@cesnet.cz>
+ * @brief Implementation of the MERGE aggregation method for telemetry data.
+ *
+ * @note SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "aggMerge.hpp"
+
+#include <telemetry/node.hpp>
+
+namespace telemetry {
+
+template <typename Distribution>
+static Distribution mergeContents(const std::vector<Content>& contents)
+{
+	Distribution result = std::get<Distribution>(contents.front());
+	for (size_t idx = 1; idx < contents.size(); idx++) {
+		const auto* distribution = std::get_if<Distribution>(&contents[idx]);
+		if (distribution == nullptr) {
+			throw TelemetryException("The contents data contain different types of values");
+		}
+		result.merge(*distribution);
+	}
+
+	return result;
+}
+
+Content mergeDistributions(const std::vector<Content>& contents)
+{
+	if (contents.empty()) {
+		return Histogram();
+	}
+
+	if (std::holds_alternative<Histogram>(contents.front())) {
+		return mergeContents<Histogram>(contents);
+	}
+	if (std::holds_alternative<QuantileSketch>(contents.front())) {
+		return mergeContents<QuantileSketch>(contents);
+	}
+
+	throw TelemetryException("The contents data does not contain a histogram or a sketch");
+}
+
+Content AggMethodMerge::aggregate(const std::vector<Content>& contents)
+{
+	if (!getDictResultName().empty()) {
+		throw TelemetryException("Histogram can't be aggregated by a dictionary field.");
+	}
+
+	if (!contents.empty() && std::holds_alternative<HyperLogLog>(contents.front())) {
+		return mergeContents<HyperLogLog>(contents);
+	}
+	if (!contents.empty() && std::holds_alternative<TopK>(contents.front())) {
+		return mergeContents<TopK>(contents);
+	}
+
+	return mergeDistributions(contents);
+}
+
+} // namespace telemetry
+
+#ifdef TELEMETRY_ENABLE_TESTS
+#include "tests/testAggMerge.cpp"
+#endif
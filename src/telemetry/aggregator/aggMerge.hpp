@@ -0,0 +1,49 @@
+/**
+ * @file
+ * @author Pavel Siska <siska@cesnet.cz>
+ * @brief Interface of the MERGE aggregation method for telemetry data.
+ *
+ * @note SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#pragma once
+
+#include <telemetry/aggMethod.hpp>
+#include <telemetry/content.hpp>
+#include <vector>
+
+namespace telemetry {
+
+/**
+ * @brief Merge histograms or quantile sketches of all @p contents.
+ * @param contents The vector of telemetry content to merge (all histograms or all sketches).
+ * @return The merged histogram or sketch (an empty histogram if there are no contents).
+ *
+ * @throws TelemetryException if contents are not all histograms or all sketches, or they
+ *   differ in the unit, the precision or the relative accuracy.
+ */
+Content mergeDistributions(const std::vector<Content>& contents);
+
+/**
+ * @brief Implementation of the MERGE aggregation method.
+ *
+ * Histograms and quantile sketches are merged bucket-wise, so the result is the same as if
+ * all values were recorded to a single histogram or sketch. HyperLogLogs are merged
+ * register-wise, so the result estimates the number of distinct values of all contents
+ * (values seen in several contents are counted once). Top-K summaries are merged into
+ * a summary of the same capacity, so the result doesn't grow with the number of contents.
+ */
+class AggMethodMerge : public AggMethod {
+public:
+	/**
+	 * @brief Aggregate telemetry data using the MERGE method.
+	 * @param contents The vector of telemetry content to aggregate.
+	 * @return The merged histogram, sketch, HyperLogLog or top-K summary.
+	 *
+	 * @throws TelemetryException if contents can't be merged (see mergeDistributions()),
+	 *   HyperLogLogs differ in the precision or top-K summaries differ in the capacity.
+	 */
+	Content aggregate(const std::vector<Content>& contents) override;
+};
+
+} // namespace telemetry
@@ -13,16 +13,38 @@
 
 namespace telemetry {
 
-static DictValue getDictValue(const Dict& dict, const std::string& dictKeyName)
+static DictValue getDictValue(const Dict& dict, const DictKey& dictKeyName)
 {
 	auto iter = dict.find(dictKeyName);
 	if (iter == dict.end()) {
-		throw TelemetryException("Dict does not contain the specified key { " + dictKeyName + "}.");
+		throw TelemetryException(
+			"Dict does not contain the specified key { " + dictKeyName.str() + "}.");
 	}
 
 	return iter->second;
 }
 
+static Array getTableColumn(const Table& table, const DictKey& columnName)
+{
+	const TableColumn* column = table.findColumn(columnName);
+	if (column == nullptr) {
+		throw TelemetryException(
+			"Table does not contain the specified column { " + columnName.str() + "}.");
+	}
+
+	Array array;
+	std::visit(
+		[&array](const auto& values) {
+			array.reserve(values.size());
+			for (const auto value : values) {
+				array.emplace_back(value);
+			}
+		},
+		column->data);
+
+	return array;
+}
+
 void AggMethod::setDictField(const std::string& dictFieldName, const std::string& dictResultName)
 {
 	m_dictFieldName = dictFieldName;
@@ -38,8 +60,21 @@ AggContent AggMethod::getAggContent(const Content& content, bool useDictResultNa
 	auto visitor = [&](const auto& arg) -> AggContent {
 		using T = std::decay_t<decltype(arg)>;
 		if constexpr (std::is_same_v<T, Dict>) {
-			const std::string key = useDictResultName ? m_dictResultname : m_dictFieldName;
+			const DictKey& key = useDictResultName ? m_dictResultname : m_dictFieldName;
 			return getDictValue(std::get<Dict>(content), key);
+		} else if constexpr (std::is_same_v<T, Table>) {
+			if (m_dictFieldName.empty()) {
+				throw TelemetryException("Table can be aggregated only by a column.");
+			}
+			const DictKey& key = useDictResultName ? m_dictResultname : m_dictFieldName;
+			return getTableColumn(arg, key);
+		} else if constexpr (std::is_same_v<T, Histogram> || std::is_same_v<T, QuantileSketch>) {
+			throw TelemetryException(
+				"Histogram can be aggregated only by the MERGE or QUANTILES method.");
+		} else if constexpr (std::is_same_v<T, HyperLogLog>) {
+			throw TelemetryException("HyperLogLog can be aggregated only by the MERGE method.");
+		} else if constexpr (std::is_same_v<T, TopK>) {
+			throw TelemetryException("Top-K summary can be aggregated only by the MERGE method.");
 		} else {
 			if (!m_dictFieldName.empty()) {
 				throw TelemetryException(
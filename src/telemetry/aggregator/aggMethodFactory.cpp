@@ -8,7 +8,9 @@
 
 #include "aggAvg.hpp"
 #include "aggJoin.hpp"
+#include "aggMerge.hpp"
 #include "aggMinMax.hpp"
+#include "aggQuantiles.hpp"
 #include "aggSum.hpp"
 
 #include <telemetry/node.hpp>
@@ -18,7 +20,8 @@ namespace telemetry {
 std::unique_ptr<AggMethod> AggMethodFactory::createAggMethod(
 	const AggMethodType& aggMethodType,
 	const std::string& dictFieldName,
-	const std::string& dictResultName)
+	const std::string& dictResultName,
+	const std::vector<double>& quantiles)
 {
 	std::unique_ptr<AggMethod> aggMethod;
 
@@ -30,6 +33,10 @@ std::unique_ptr<AggMethod> AggMethodFactory::createAggMethod(
 		aggMethod = std::make_unique<AggMethodMinMax>(aggMethodType);
 	} else if (aggMethodType == AggMethodType::JOIN) {
 		aggMethod = std::make_unique<AggMethodJoin>();
+	} else if (aggMethodType == AggMethodType::MERGE) {
+		aggMethod = std::make_unique<AggMethodMerge>();
+	} else if (aggMethodType == AggMethodType::QUANTILES) {
+		aggMethod = std::make_unique<AggMethodQuantiles>(quantiles);
 	} else {
 		throw TelemetryException("Invalid aggregation method.");
 	}
@@ -11,6 +11,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace telemetry {
 
@@ -25,13 +26,15 @@ public:
 	 * @param aggMethodType The type of aggregation method to create.
 	 * @param dictFieldName The name of the dictionary field.
 	 * @param dictResultName The name of the dictionary result.
+	 * @param quantiles Quantiles reported by the QUANTILES method.
 	 * @return A unique pointer to the created aggregation method.
 	 * @throws TelemetryException if the specified aggregation method type is invalid.
 	 */
 	static std::unique_ptr<AggMethod> createAggMethod(
 		const AggMethodType& aggMethodType,
 		const std::string& dictFieldName = "",
-		const std::string& dictResultName = "");
+		const std::string& dictResultName = "",
+		const std::vector<double>& quantiles = {});
 };
 
 } // namespace telemetry
@@ -109,6 +109,20 @@ static ScalarWithUnit aggregateScalarWithUnit(
 	return {result, unit};
 }
 
+static Scalar
+aggregateArray(std::vector<AggContent>& values, const AggMethodMinMax::AggMethod& aggMethod)
+{
+	Scalar result = std::monostate();
+
+	for (const auto& value : values) {
+		for (const auto& scalar : std::get<Array>(value)) {
+			aggMethod(scalar, result);
+		}
+	}
+
+	return result;
+}
+
 static ResultType aggregateGatheredValues(
 	std::vector<AggContent>& values,
 	const AggMethodMinMax::AggMethod& aggMethod)
@@ -117,6 +131,10 @@ static ResultType aggregateGatheredValues(
 		return aggregateScalar(values, aggMethod);
 	}
 
+	if (std::holds_alternative<Array>(values.front())) {
+		return aggregateArray(values, aggMethod);
+	}
+
 	if (std::holds_alternative<ScalarWithUnit>(values.front())) {
 		return aggregateScalarWithUnit(values, aggMethod);
 	}
@@ -124,7 +142,7 @@ static ResultType aggregateGatheredValues(
 	throw TelemetryException("Unexpected variant alternative.");
 }
 
-static Content createDictContent(const std::string& dictKey, const ResultType& result)
+static Content createDictContent(const DictKey& dictKey, const ResultType& result)
 {
 	Dict dict;
 
@@ -134,7 +152,7 @@ static Content createDictContent(const std::string& dictKey, const ResultType& r
 	return dict;
 }
 
-static Content createContent(const std::string& dictKey, const ResultType& result)
+static Content createContent(const DictKey& dictKey, const ResultType& result)
 {
 	if (!dictKey.empty()) {
 		return createDictContent(dictKey, result);
@@ -164,7 +182,7 @@ Content AggMethodMinMax::aggregate(const std::vector<Content>& contents)
 		values.emplace_back(aggContent);
 	}
 
-	if (!hasOneOfThisAlternative<ScalarWithUnit, Scalar>(values)) {
+	if (!hasOneOfThisAlternative<ScalarWithUnit, Scalar, Array>(values)) {
 		throw TelemetryException("The contents data does not contain the same variant alternative");
 	}
 
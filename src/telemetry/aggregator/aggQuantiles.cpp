@@ -0,0 +1,102 @@
+/**
+ * @file
+ * @author Pavel Siska <siska@cesnet.cz>
+ * @brief Implementation of the QUANTILES aggregation method for telemetry data.
+ *
+ * @note SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "aggQuantiles.hpp"
+
+#include "aggMerge.hpp"
+
+#include <telemetry/node.hpp>
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <string>
+
+namespace telemetry {
+
+/**
+ * @brief Get the name of the percentile of the @p quantile (e.g. "p999" for 0.999).
+ */
+static std::string getPercentileName(double quantile)
+{
+	if (quantile == 0) {
+		return "p0";
+	}
+	if (quantile == 1) {
+		return "p100";
+	}
+
+	// Enough for the shortest representation of any double in [0, 1)
+	constexpr size_t bufferSize = 400;
+	std::array<char, bufferSize> buffer;
+	const auto result = std::to_chars(
+		buffer.data(),
+		buffer.data() + buffer.size(),
+		quantile,
+		std::chars_format::fixed);
+
+	// Digits after "0." are digits of the percentile (at least two of them)
+	std::string name = "p";
+	if (result.ptr - buffer.data() > 2) {
+		name.append(buffer.data() + 2, result.ptr);
+	}
+	name.resize(std::max<size_t>(name.size(), 3), '0');
+	return name;
+}
+
+AggMethodQuantiles::AggMethodQuantiles(const std::vector<double>& quantiles)
+{
+	static const std::vector<double> DEFAULT_QUANTILES = {0.5, 0.99, 0.999};
+
+	for (const double quantile : quantiles.empty() ? DEFAULT_QUANTILES : quantiles) {
+		if (!(quantile >= 0 && quantile <= 1)) {
+			throw TelemetryException(
+				"Quantile " + std::to_string(quantile) + " is out of the range [0, 1].");
+		}
+		m_quantiles.emplace_back(getPercentileName(quantile), quantile);
+	}
+}
+
+Content AggMethodQuantiles::aggregate(const std::vector<Content>& contents)
+{
+	if (!getDictResultName().empty()) {
+		throw TelemetryException("Histogram can't be aggregated by a dictionary field.");
+	}
+
+	const Content merged = mergeDistributions(contents);
+
+	Dict result;
+	auto addValues = [&](const auto& distribution) {
+		for (const auto& [name, quantile] : m_quantiles) {
+			Scalar value;
+			if (distribution.count() > 0) {
+				value = distribution.valueAtQuantile(quantile);
+			}
+
+			if (distribution.unit().empty()) {
+				result[name] = value;
+			} else {
+				result[name] = ScalarWithUnit {value, distribution.unit()};
+			}
+		}
+	};
+
+	if (const auto* histogram = std::get_if<Histogram>(&merged)) {
+		addValues(*histogram);
+	} else {
+		addValues(std::get<QuantileSketch>(merged));
+	}
+
+	return result;
+}
+
+} // namespace telemetry
+
+#ifdef TELEMETRY_ENABLE_TESTS
+#include "tests/testAggQuantiles.cpp"
+#endif
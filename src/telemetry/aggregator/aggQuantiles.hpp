@@ -0,0 +1,49 @@
+/**
+ * @file
+ * @author Pavel Siska <siska@cesnet.cz>
+ * @brief Interface of the QUANTILES aggregation method for telemetry data.
+ *
+ * @note SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#pragma once
+
+#include <telemetry/aggMethod.hpp>
+#include <telemetry/content.hpp>
+
+#include <utility>
+#include <vector>
+
+namespace telemetry {
+
+/**
+ * @brief Implementation of the QUANTILES aggregation method.
+ *
+ * Histograms or quantile sketches are merged (see AggMethodMerge) and values at the configured
+ * quantiles of the merged histogram or sketch are reported as a dictionary. Keys are names
+ * of percentiles, e.g. "p50" for 0.5, "p99" for 0.99 and "p999" for 0.999.
+ */
+class AggMethodQuantiles : public AggMethod {
+public:
+	/**
+	 * @brief Construct a new AggMethodQuantiles object.
+	 *
+	 * @param quantiles Reported quantiles in the range [0, 1] (p50, p99 and p999 if empty).
+	 * @throws TelemetryException if a quantile is out of the range.
+	 */
+	explicit AggMethodQuantiles(const std::vector<double>& quantiles = {});
+
+	/**
+	 * @brief Aggregate telemetry data using the QUANTILES method.
+	 * @param contents The vector of telemetry content to aggregate.
+	 * @return Dictionary of values at quantiles (unknown if there are no values).
+	 *
+	 * @throws TelemetryException if contents can't be merged (see mergeDistributions()).
+	 */
+	Content aggregate(const std::vector<Content>& contents) override;
+
+private:
+	std::vector<std::pair<DictKey, double>> m_quantiles;
+};
+
+} // namespace telemetry
@@ -74,12 +74,29 @@ static ScalarWithUnit aggregateScalarWithUnit(std::vector<AggContent>& values)
 	return {result, unit};
 }
 
+static Scalar aggregateArray(std::vector<AggContent>& values)
+{
+	Scalar result = std::monostate();
+
+	for (const auto& value : values) {
+		for (const auto& scalar : std::get<Array>(value)) {
+			sumarize(scalar, result);
+		}
+	}
+
+	return result;
+}
+
 static AggMethodSum::ResultType aggregateGatheredValues(std::vector<AggContent>& values)
 {
 	if (std::holds_alternative<Scalar>(values.front())) {
 		return aggregateScalar(values);
 	}
 
+	if (std::holds_alternative<Array>(values.front())) {
+		return aggregateArray(values);
+	}
+
 	if (std::holds_alternative<ScalarWithUnit>(values.front())) {
 		return aggregateScalarWithUnit(values);
 	}
@@ -87,7 +104,7 @@ static AggMethodSum::ResultType aggregateGatheredValues(std::vector<AggContent>&
 	throw TelemetryException("Unexpected variant alternative.");
 }
 
-static Content createDictContent(const std::string& dictKey, const AggMethodSum::ResultType& result)
+static Content createDictContent(const DictKey& dictKey, const AggMethodSum::ResultType& result)
 {
 	Dict dict;
 
@@ -117,7 +134,7 @@ Content AggMethodSum::aggregate(const std::vector<Content>& contents)
 		values.emplace_back(aggContent);
 	}
 
-	if (!hasOneOfThisAlternative<ScalarWithUnit, Scalar>(values)) {
+	if (!hasOneOfThisAlternative<ScalarWithUnit, Scalar, Array>(values)) {
 		throw TelemetryException(
 			"The contents data does not contain the same variant alternative.");
 	}
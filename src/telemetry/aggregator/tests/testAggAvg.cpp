@@ -147,6 +147,19 @@ TEST(AggAvgTest, TestAggregate)
 		const Scalar& scalarValueAvg = std::get<Scalar>(dict.at("packetsSum"));
 		EXPECT_EQ(3.0, std::get<double>(scalarValueAvg));
 	}
+
+	// Test aggregation of a table column (average of all rows)
+	{
+		Table first(2);
+		first.addColumn("packets", TableColumn::Values<uint64_t> {1, 2});
+		Table second(1);
+		second.addColumn("packets", TableColumn::Values<uint64_t> {6});
+
+		AggMethodAvg aggMethodAvg;
+		aggMethodAvg.setDictField("packets", "packetsAvg");
+		const Content content = aggMethodAvg.aggregate({first, second});
+		EXPECT_EQ(Content(Dict({{"packetsAvg", Scalar {3.0}}})), content);
+	}
 }
 
 } // namespace telemetry
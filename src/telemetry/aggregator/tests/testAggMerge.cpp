@@ -0,0 +1,122 @@
+/**
+ * @file
+ * @author Pavel Siska <siska@cesnet.cz>
+ * @brief Unit tests of Telemetry::AggMethodMerge
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <gtest/gtest.h>
+
+namespace telemetry {
+
+/**
+ * @test Test merging of histograms
+ */
+TEST(AggMergeTest, TestAggregate)
+{
+	Histogram first("us");
+	first.record(10);
+	first.record(1000, 3);
+
+	Histogram second("us");
+	second.record(5);
+	second.record(1000);
+
+	Histogram expected("us");
+	expected.record(5);
+	expected.record(10);
+	expected.record(1000, 4);
+
+	AggMethodMerge aggMethodMerge;
+	EXPECT_EQ(Content {expected}, aggMethodMerge.aggregate({first, second, Histogram("us")}));
+	EXPECT_EQ(Content {Histogram()}, aggMethodMerge.aggregate({}));
+
+	EXPECT_THROW(aggMethodMerge.aggregate({first, Histogram("ms")}), TelemetryException);
+	EXPECT_THROW(aggMethodMerge.aggregate({first, Scalar {uint64_t {1}}}), TelemetryException);
+	EXPECT_THROW(aggMethodMerge.aggregate({Scalar {uint64_t {1}}}), TelemetryException);
+
+	aggMethodMerge.setDictField("latency", "");
+	EXPECT_THROW(aggMethodMerge.aggregate({first}), TelemetryException);
+}
+
+/**
+ * @test Test merging of quantile sketches
+ */
+TEST(AggMergeTest, TestAggregateSketch)
+{
+	QuantileSketch first("us");
+	first.record(10);
+	first.record(1000, 3);
+
+	QuantileSketch second("us");
+	second.record(0);
+	second.record(1000);
+
+	QuantileSketch expected("us");
+	expected.record(10);
+	expected.record(1000, 3);
+	expected.record(0);
+	expected.record(1000);
+
+	AggMethodMerge aggMethodMerge;
+	EXPECT_EQ(Content {expected}, aggMethodMerge.aggregate({first, second}));
+
+	EXPECT_THROW(aggMethodMerge.aggregate({first, QuantileSketch("us", 0.05)}), TelemetryException);
+	EXPECT_THROW(aggMethodMerge.aggregate({first, Histogram("us")}), TelemetryException);
+}
+
+/**
+ * @test Test merging of HyperLogLogs
+ */
+TEST(AggMergeTest, TestAggregateHyperLogLog)
+{
+	HyperLogLog first;
+	HyperLogLog second;
+	HyperLogLog expected;
+
+	for (uint64_t value = 0; value < 1000; value++) {
+		first.add(value);
+		second.add(value + 500);
+		expected.add(value);
+		expected.add(value + 500);
+	}
+
+	AggMethodMerge aggMethodMerge;
+	const Content merged = aggMethodMerge.aggregate({first, second});
+	EXPECT_EQ(Content {expected}, merged);
+	EXPECT_NEAR(1500, static_cast<double>(std::get<HyperLogLog>(merged).estimate()), 50);
+
+	EXPECT_THROW(aggMethodMerge.aggregate({first, HyperLogLog(10)}), TelemetryException);
+	EXPECT_THROW(aggMethodMerge.aggregate({first, Histogram()}), TelemetryException);
+}
+
+/**
+ * @test Test merging of top-K summaries
+ */
+TEST(AggMergeTest, TestAggregateTopK)
+{
+	TopK first(2);
+	first.record("a", 10);
+	first.record("b", 2);
+
+	TopK second(2);
+	second.record("c", 7);
+	second.record("a", 1);
+
+	TopK third(2);
+	third.record("c", 4);
+
+	// Keys not monitored by the full first summary might have occurred twice there
+	const TopK::Items expected {{"c", 13, 2}, {"a", 11, 0}};
+
+	AggMethodMerge aggMethodMerge;
+	const Content merged = aggMethodMerge.aggregate({first, second, third});
+	EXPECT_EQ(expected, std::get<TopK>(merged).items());
+	EXPECT_EQ(24, std::get<TopK>(merged).count());
+
+	EXPECT_THROW(aggMethodMerge.aggregate({first, TopK(3)}), TelemetryException);
+	EXPECT_THROW(aggMethodMerge.aggregate({first, HyperLogLog()}), TelemetryException);
+}
+
+} // namespace telemetry
@@ -0,0 +1,60 @@
+/**
+ * @file
+ * @author Pavel Siska <siska@cesnet.cz>
+ * @brief Unit tests of Telemetry::AggMethodQuantiles
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <gtest/gtest.h>
+
+namespace telemetry {
+
+/**
+ * @test Test reporting of quantiles of merged sketches and histograms
+ */
+TEST(AggQuantilesTest, TestAggregate)
+{
+	QuantileSketch first("us");
+	QuantileSketch second("us");
+	for (int value = 1; value <= 1000; value++) {
+		(value % 2 == 0 ? first : second).record(value);
+	}
+
+	AggMethodQuantiles aggMethodQuantiles;
+	const auto sketchResult = aggMethodQuantiles.aggregate({first, second});
+	const auto& sketchDict = std::get<Dict>(sketchResult);
+	EXPECT_EQ(3, sketchDict.size());
+	for (const auto& [name, exact] : {std::pair {"p50", 500.5}, {"p99", 990.0}, {"p999", 999.0}}) {
+		const auto& [value, unit] = std::get<ScalarWithUnit>(sketchDict.at(name));
+		EXPECT_EQ("us", unit);
+		EXPECT_NEAR(exact, std::get<double>(value), exact * 0.01);
+	}
+
+	Histogram histogram;
+	histogram.record(10);
+	histogram.record(1000, 3);
+
+	AggMethodQuantiles configured({0, 0.05, 0.9, 0.9999, 1});
+	const Dict expected {
+		{"p0", Scalar {uint64_t {10}}},
+		{"p05", Scalar {uint64_t {10}}},
+		{"p90", Scalar {uint64_t {1000}}},
+		{"p9999", Scalar {uint64_t {1000}}},
+		{"p100", Scalar {uint64_t {1000}}},
+	};
+	EXPECT_EQ(Content {expected}, configured.aggregate({histogram, Histogram()}));
+
+	const Dict unknown {{"p50", Scalar {}}, {"p99", Scalar {}}, {"p999", Scalar {}}};
+	EXPECT_EQ(Content {unknown}, aggMethodQuantiles.aggregate({}));
+	EXPECT_EQ(Content {unknown}, aggMethodQuantiles.aggregate({QuantileSketch()}));
+
+	EXPECT_THROW(AggMethodQuantiles({1.5}), TelemetryException);
+	EXPECT_THROW(aggMethodQuantiles.aggregate({first, histogram}), TelemetryException);
+	EXPECT_THROW(aggMethodQuantiles.aggregate({Scalar {uint64_t {1}}}), TelemetryException);
+
+	aggMethodQuantiles.setDictField("latency", "");
+	EXPECT_THROW(aggMethodQuantiles.aggregate({first}), TelemetryException);
+}
+
+} // namespace telemetry
@@ -201,6 +201,33 @@ TEST(AggSumTest, TestAggregate)
 		const Scalar& scalarValueSum = std::get<Scalar>(dict.at("packetsSum"));
 		EXPECT_EQ(uint64_t(6), std::get<uint64_t>(scalarValueSum));
 	}
+
+	// Test aggregation of a table column over all rows of all tables
+	{
+		Table first(2);
+		first.addColumn("packets", TableColumn::Values<uint64_t> {1, 2});
+		Table second(1);
+		second.addColumn("packets", TableColumn::Values<uint64_t> {10});
+
+		AggMethodSum aggMethodSum;
+		aggMethodSum.setDictField("packets", "packetsSum");
+		const Content content = aggMethodSum.aggregate({first, second});
+		EXPECT_EQ(Content(Dict({{"packetsSum", Scalar {uint64_t {13}}}})), content);
+
+		AggMethodSum missingColumn;
+		missingColumn.setDictField("bytes", "");
+		EXPECT_THROW(missingColumn.aggregate({first}), TelemetryException);
+
+		AggMethodSum noColumn;
+		EXPECT_THROW(noColumn.aggregate({first}), TelemetryException);
+	}
+
+	// Test aggregation of histograms (expect failure, they are merged by the MERGE method)
+	{
+		AggMethodSum aggMethodSum;
+		std::vector<Content> contents = {Histogram("us"), Histogram("us")};
+		EXPECT_THROW(aggMethodSum.aggregate(contents), TelemetryException);
+	}
 }
 
 } // namespace telemetry
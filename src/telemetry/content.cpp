@@ -6,10 +6,12 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#include "contentFormat.hpp"
+
 #include <telemetry/content.hpp>
+#include <telemetry/contentWriter.hpp>
 
-#include <iomanip>
-#include <sstream>
+#include <algorithm>
 #include <string>
 #include <type_traits>
 
@@ -18,81 +20,80 @@ namespace telemetry {
 template <typename... T>
 constexpr bool g_AlwaysFalse = false;
 
-static std::string scalarToString(const Scalar& scalar)
+static void appendScalar(std::string& output, const Scalar& scalar)
 {
-	auto converter = [](auto&& arg) -> std::string {
+	auto formatter = [&output](const auto& arg) {
 		using T = std::decay_t<decltype(arg)>;
 
 		if constexpr (std::is_same_v<T, std::monostate>) {
-			return "<N/A>";
+			output += "<N/A>";
 		} else if constexpr (std::is_same_v<T, bool>) {
-			return arg ? "true" : "false";
-		} else if constexpr (std::is_same_v<T, uint64_t> || std::is_same_v<T, int64_t>) {
-			return std::to_string(arg);
-		} else if constexpr (std::is_same_v<T, double>) {
-			std::stringstream stream;
-			stream << std::fixed << std::setprecision(2) << arg;
-			return stream.str();
+			output += arg ? "true" : "false";
+		} else if constexpr (
+			std::is_same_v<T, uint64_t> || std::is_same_v<T, int64_t>
+			|| std::is_same_v<T, double>) {
+			appendNumber(output, arg);
 		} else if constexpr (std::is_same_v<T, std::string>) {
-			return arg;
+			output += arg;
 		} else {
 			static_assert(g_AlwaysFalse<T>, "non-exhaustive visitor");
 		}
 	};
 
-	return std::visit(converter, scalar);
+	std::visit(formatter, scalar);
 }
 
-static std::string scalarWithUnitToString(const ScalarWithUnit& scalar)
+static void appendScalarWithUnit(std::string& output, const ScalarWithUnit& scalar)
 {
 	const auto& [value, unit] = scalar;
-	return scalarToString(value) + " (" + unit + ")";
+
+	appendScalar(output, value);
+	output += " (";
+	output += unit;
+	output += ')';
 }
 
-static std::string arrayToString(const Array& array)
+static void appendArray(std::string& output, const Array& array)
 {
-	std::string result;
 	size_t cnt = 0;
 
-	result += '[';
+	output += '[';
 
 	for (const auto& elem : array) {
 		if (cnt > 0) {
-			result += ", ";
+			output += ", ";
 		}
 
-		result += scalarToString(elem);
+		appendScalar(output, elem);
 		cnt++;
 	}
 
-	result += ']';
-	return result;
+	output += ']';
 }
 
-static std::string dictValueToString(const DictValue& value)
+static void appendDictValue(std::string& output, const DictValue& value)
 {
-	auto converter = [](auto&& arg) -> std::string {
+	auto formatter = [&output](const auto& arg) {
 		using T = std::decay_t<decltype(arg)>;
 
 		if constexpr (std::is_same_v<T, std::monostate>) {
-			return "<N/A>";
+			output += "<N/A>";
 		} else if constexpr (std::is_same_v<T, Scalar>) {
-			return scalarToString(arg);
+			appendScalar(output, arg);
 		} else if constexpr (std::is_same_v<T, ScalarWithUnit>) {
-			return scalarWithUnitToString(arg);
+			appendScalarWithUnit(output, arg);
 		} else if constexpr (std::is_same_v<T, Array>) {
-			return arrayToString(arg);
+			appendArray(output, arg);
 		} else {
 			static_assert(g_AlwaysFalse<T>, "non-exhaustive visitor");
 		}
 	};
 
-	return std::visit(converter, value);
+	std::visit(formatter, value);
 }
 
-static std::string dictToString(const Dict& dict)
+static void appendDict(std::string& output, const Dict& dict)
 {
-	std::stringstream result;
 	size_t maxKeyLen = 0;
 	size_t cnt = 0;
 
@@ -101,41 +102,63 @@ static std::string dictToString(const Dict& dict)
 	}
 
 	for (const auto& [key, value] : dict) {
-		const int extraSpaces = static_cast<int>(maxKeyLen - key.length());
-
 		if (cnt > 0) {
-			result << '\n';
+			output += '\n';
 		}
 
-		result << key;
-		result << std::left << std::setw(2 + extraSpaces) << ':';
-		result << dictValueToString(value);
+		// Values are aligned after the colon of the longest key
+		output += key;
+		output += ':';
+		output.append(maxKeyLen - key.length() + 1, ' ');
+		appendDictValue(output, value);
 
 		cnt++;
 	}
-
-	return result.str();
 }
 
-std::string contentToString(const Content& content)
+void appendContentToString(std::string& output, const Content& content)
 {
-	auto converter = [](auto&& arg) -> std::string {
+	auto formatter = [&output](const auto& arg) {
 		using T = std::decay_t<decltype(arg)>;
 
 		if constexpr (std::is_same_v<T, Scalar>) {
-			return scalarToString(arg);
+			appendScalar(output, arg);
 		} else if constexpr (std::is_same_v<T, ScalarWithUnit>) {
-			return scalarWithUnitToString(arg);
+			appendScalarWithUnit(output, arg);
 		} else if constexpr (std::is_same_v<T, Array>) {
-			return arrayToString(arg);
+			appendArray(output, arg);
 		} else if constexpr (std::is_same_v<T, Dict>) {
-			return dictToString(arg);
+			appendDict(output, arg);
+		} else if constexpr (std::is_same_v<T, Table>) {
+			appendTableToString(output, arg);
+		} else if constexpr (std::is_same_v<T, Histogram>) {
+			// Histogram and sketch are rendered as the summary written by content writers
+			TextContentWriter writer;
+			writer.histogram(arg);
+			output += writer.str();
+		} else if constexpr (std::is_same_v<T, QuantileSketch>) {
+			TextContentWriter writer;
+			writer.quantileSketch(arg);
+			output += writer.str();
+		} else if constexpr (std::is_same_v<T, HyperLogLog>) {
+			appendScalar(output, Scalar {arg.estimate()});
+		} else if constexpr (std::is_same_v<T, TopK>) {
+			TextContentWriter writer;
+			writer.topK(arg);
+			output += writer.str();
 		} else {
 			static_assert(g_AlwaysFalse<T>, "non-exhaustive visitor");
 		}
 	};
 
-	return std::visit(converter, content);
+	std::visit(formatter, content);
+}
+
+std::string contentToString(const Content& content)
+{
+	std::string result;
+	appendContentToString(result, content);
+	return result;
 }
 
 } // namespace telemetry
@@ -0,0 +1,36 @@
+/**
+ * @file
+ * @author Pavel Siska <siska@cesnet.cz>
+ * @brief Memory resource used by telemetry content containers
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <telemetry/contentAllocator.hpp>
+
+namespace telemetry {
+
+// Resource of the innermost scope of the thread (nullptr for the default resource)
+static thread_local std::pmr::memory_resource* g_contentResource = nullptr;
+
+std::pmr::memory_resource* getContentResource() noexcept
+{
+	return g_contentResource != nullptr ? g_contentResource : std::pmr::get_default_resource();
+}
+
+ContentResourceScope::ContentResourceScope(std::pmr::memory_resource* resource) noexcept
+	: m_previous(g_contentResource)
+{
+	g_contentResource = resource;
+}
+
+ContentResourceScope::~ContentResourceScope()
+{
+	g_contentResource = m_previous;
+}
+
+} // namespace telemetry
+
+#ifdef TELEMETRY_ENABLE_TESTS
+#include "tests/testContentAllocator.cpp"
+#endif
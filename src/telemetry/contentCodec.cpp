@@ -0,0 +1,254 @@
+/**
+ * @file
+ * @author Pavel Siska <siska@cesnet.cz>
+ * @brief Compact binary encoding of telemetry content
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "contentCodecFormat.hpp"
+
+#include <telemetry/contentCodec.hpp>
+
+#include <array>
+#include <bit>
+
+namespace telemetry {
+
+static constexpr std::array<uint8_t, 2> CODEC_MAGIC = {'T', 'C'};
+
+BinaryContentWriter::BinaryContentWriter()
+{
+	clear();
+}
+
+void BinaryContentWriter::clear()
+{
+	m_data.assign(CODEC_MAGIC.begin(), CODEC_MAGIC.end());
+	m_data.push_back(CONTENT_CODEC_VERSION);
+}
+
+void BinaryContentWriter::beginDict()
+{
+	m_data.push_back(tag::DICT_BEGIN);
+}
+
+void BinaryContentWriter::key(std::string_view key)
+{
+	m_data.push_back(tag::KEY);
+	appendString(m_data, key);
+}
+
+void BinaryContentWriter::endDict()
+{
+	m_data.push_back(tag::DICT_END);
+}
+
+void BinaryContentWriter::beginArray()
+{
+	m_data.push_back(tag::ARRAY_BEGIN);
+}
+
+void BinaryContentWriter::endArray()
+{
+	m_data.push_back(tag::ARRAY_END);
+}
+
+void BinaryContentWriter::unit(std::string_view unit)
+{
+	m_data.push_back(tag::UNIT);
+	appendString(m_data, unit);
+}
+
+void BinaryContentWriter::value(std::monostate)
+{
+	m_data.push_back(tag::NONE);
+}
+
+void BinaryContentWriter::value(bool value)
+{
+	m_data.push_back(value ? tag::BOOL_TRUE : tag::BOOL_FALSE);
+}
+
+void BinaryContentWriter::value(uint64_t value)
+{
+	m_data.push_back(tag::UINT);
+	appendVarint(m_data, value);
+}
+
+void BinaryContentWriter::value(int64_t value)
+{
+	m_data.push_back(tag::INT);
+	appendVarint(m_data, zigzagEncode(value));
+}
+
+void BinaryContentWriter::value(double value)
+{
+	m_data.push_back(tag::DOUBLE);
+	appendFixed64(m_data, std::bit_cast<uint64_t>(value));
+}
+
+void BinaryContentWriter::value(std::string_view value)
+{
+	m_data.push_back(tag::STRING);
+	appendString(m_data, value);
+}
+
+void BinaryContentWriter::table(const Table& table)
+{
+	appendTable(m_data, table);
+}
+
+void BinaryContentWriter::histogram(const Histogram& histogram)
+{
+	appendHistogram(m_data, histogram);
+}
+
+void BinaryContentWriter::quantileSketch(const QuantileSketch& sketch)
+{
+	appendQuantileSketch(m_data, sketch);
+}
+
+void BinaryContentWriter::hyperLogLog(const HyperLogLog& hyperLogLog)
+{
+	appendHyperLogLog(m_data, hyperLogLog);
+}
+
+void BinaryContentWriter::topK(const TopK& topK)
+{
+	appendTopK(m_data, topK);
+}
+
+std::vector<uint8_t> encodeContent(const Content& content)
+{
+	BinaryContentWriter writer;
+	writeContent(writer, content);
+	return writer.data();
+}
+
+/**
+ * @brief Reader of the encoded content that validates its shape.
+ */
+class ContentDecoder {
+public:
+	ContentDecoder(std::span<const uint8_t> data, ContentWriter& writer)
+		: m_reader(data, "decodeContent()")
+		, m_writer(writer)
+	{
+	}
+
+	void decode()
+	{
+		m_reader.readHeader(CODEC_MAGIC, CONTENT_CODEC_VERSION);
+
+		const uint8_t tag = m_reader.readByte();
+		if (tag == tag::DICT_BEGIN) {
+			decodeDict();
+		} else if (tag == tag::TABLE) {
+			m_writer.table(m_reader.readTable());
+		} else if (tag == tag::HISTOGRAM) {
+			m_writer.histogram(m_reader.readHistogram());
+		} else if (tag == tag::SKETCH) {
+			m_writer.quantileSketch(m_reader.readQuantileSketch());
+		} else if (tag == tag::HYPERLOGLOG) {
+			m_writer.hyperLogLog(m_reader.readHyperLogLog());
+		} else if (tag == tag::TOPK) {
+			m_writer.topK(m_reader.readTopK());
+		} else {
+			decodeDictValue(tag);
+		}
+
+		if (!m_reader.atEnd()) {
+			m_reader.fail("unexpected data after the content");
+		}
+	}
+
+private:
+	void decodeScalar(uint8_t tag)
+	{
+		switch (tag) {
+		case tag::NONE:
+			m_writer.value(std::monostate());
+			break;
+		case tag::BOOL_FALSE:
+			m_writer.value(false);
+			break;
+		case tag::BOOL_TRUE:
+			m_writer.value(true);
+			break;
+		case tag::UINT:
+			m_writer.value(m_reader.readVarint());
+			break;
+		case tag::INT:
+			m_writer.value(zigzagDecode(m_reader.readVarint()));
+			break;
+		case tag::DOUBLE:
+			m_writer.value(std::bit_cast<double>(m_reader.readFixed64()));
+			break;
+		case tag::STRING:
+			m_writer.value(m_reader.readString());
+			break;
+		default:
+			m_reader.failUnexpectedTag(tag, "a scalar");
+		}
+	}
+
+	void decodeArray()
+	{
+		m_writer.beginArray();
+		for (uint8_t tag = m_reader.readByte(); tag != tag::ARRAY_END; tag = m_reader.readByte()) {
+			decodeScalar(tag);
+		}
+		m_writer.endArray();
+	}
+
+	void decodeDictValue(uint8_t tag)
+	{
+		if (tag == tag::ARRAY_BEGIN) {
+			decodeArray();
+			return;
+		}
+
+		if (tag == tag::UNIT) {
+			m_writer.unit(m_reader.readString());
+			tag = m_reader.readByte();
+		}
+
+		decodeScalar(tag);
+	}
+
+	void decodeDict()
+	{
+		m_writer.beginDict();
+		for (uint8_t tag = m_reader.readByte(); tag != tag::DICT_END; tag = m_reader.readByte()) {
+			if (tag != tag::KEY) {
+				m_reader.failUnexpectedTag(tag, "a dictionary key");
+			}
+
+			m_writer.key(m_reader.readString());
+			decodeDictValue(m_reader.readByte());
+		}
+		m_writer.endDict();
+	}
+
+	ByteReader m_reader;
+	ContentWriter& m_writer;
+};
+
+void decodeContent(std::span<const uint8_t> data, ContentWriter& writer)
+{
+	ContentDecoder(data, writer).decode();
+}
+
+Content decodeContent(std::span<const uint8_t> data)
+{
+	ContentBuilder builder;
+	decodeContent(data, builder);
+	return builder.takeContent();
+}
+
+} // namespace telemetry
+
+#ifdef TELEMETRY_ENABLE_TESTS
+#include "tests/testContentCodec.cpp"
+#endif
@@ -0,0 +1,566 @@
+/**
+ * @file
+ * @author Pavel Siska <siska@cesnet.cz>
+ * @brief Primitives of the binary encoding of telemetry content
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#pragma once
+
+#include <telemetry/histogram.hpp>
+#include <telemetry/hyperLogLog.hpp>
+#include <telemetry/node.hpp>
+#include <telemetry/quantileSketch.hpp>
+#include <telemetry/table.hpp>
+#include <telemetry/topK.hpp>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace telemetry {
+
+/*
+ * Encoding of content:
+ *   header     := 'T' 'C' version
+ *   content    := scalarItem | array | dict | table | histogram | sketch | hll | topk
+ *   scalarItem := [UNIT string] scalar
+ *   scalar     := NONE | BOOL_FALSE | BOOL_TRUE | UINT varint | INT zigzag-varint
+ *               | DOUBLE 8B-little-endian | STRING string
+ *   array      := ARRAY_BEGIN scalar* ARRAY_END
+ *   dict       := DICT_BEGIN (KEY string (scalarItem | array))* DICT_END
+ *   table      := TABLE varint-rows varint-columns column*
+ *   column     := KEY string [UNIT string] (UINT varint* | INT zigzag-varint*
+ *               | DOUBLE 8B-little-endian*)
+ *   histogram  := HISTOGRAM [UNIT string] varint-precision varint-sum varint-min varint-max
+ *                 varint-count (varint-gap varint-count)*
+ *   sketch     := SKETCH [UNIT string] 8B-accuracy varint-max-buckets zigzag-varint-offset
+ *                 8B-sum 8B-min 8B-max varint-zero-count varint-count varint*
+ *   hll        := HYPERLOGLOG varint-precision varint-count (varint-gap byte)*
+ *   topk       := TOPK varint-capacity varint-total varint-count
+ *                 (string varint-count varint-error)*
+ *   string     := varint-length bytes
+ *
+ * Values of table columns are stored without tags, one per row. Only non-empty buckets
+ * of histograms and non-zero registers of HyperLogLogs are stored, their indices as gaps
+ * from the bucket (register) following the previous one.
+ * Doubles of sketches are stored as 8B little-endian values.
+ */
+namespace tag {
+constexpr uint8_t NONE = 0x00;
+constexpr uint8_t BOOL_FALSE = 0x01;
+constexpr uint8_t BOOL_TRUE = 0x02;
+constexpr uint8_t UINT = 0x03;
+constexpr uint8_t INT = 0x04;
+constexpr uint8_t DOUBLE = 0x05;
+constexpr uint8_t STRING = 0x06;
+constexpr uint8_t UNIT = 0x07;
+constexpr uint8_t ARRAY_BEGIN = 0x08;
+constexpr uint8_t ARRAY_END = 0x09;
+constexpr uint8_t DICT_BEGIN = 0x0A;
+constexpr uint8_t DICT_END = 0x0B;
+constexpr uint8_t KEY = 0x0C;
+constexpr uint8_t TABLE = 0x0D;
+constexpr uint8_t HISTOGRAM = 0x0E;
+constexpr uint8_t SKETCH = 0x0F;
+constexpr uint8_t HYPERLOGLOG = 0x10;
+constexpr uint8_t TOPK = 0x11;
+} // namespace tag
+
+inline constexpr unsigned VARINT_BITS = 7;
+inline constexpr uint8_t VARINT_MASK = 0x7F;
+inline constexpr uint8_t VARINT_CONTINUE = 0x80;
+inline constexpr unsigned BYTE_BITS = 8;
+
+inline uint64_t zigzagEncode(int64_t value)
+{
+	const auto bits = static_cast<uint64_t>(value);
+	return (bits << 1U) ^ static_cast<uint64_t>(value >> 63);
+}
+
+inline int64_t zigzagDecode(uint64_t value)
+{
+	return static_cast<int64_t>((value >> 1U) ^ (~(value & 1U) + 1U));
+}
+
+/** @brief Get the number of bytes of the variable length integer @p value. */
+inline size_t varintSize(uint64_t value)
+{
+	size_t size = 1;
+	while (value > VARINT_MASK) {
+		value >>= VARINT_BITS;
+		size++;
+	}
+	return size;
+}
+
+inline void appendVarint(std::vector<uint8_t>& output, uint64_t value)
+{
+	while (value > VARINT_MASK) {
+		output.push_back(static_cast<uint8_t>((value & VARINT_MASK) | VARINT_CONTINUE));
+		value >>= VARINT_BITS;
+	}
+	output.push_back(static_cast<uint8_t>(value));
+}
+
+inline void appendFixed64(std::vector<uint8_t>& output, uint64_t value)
+{
+	for (unsigned idx = 0; idx < sizeof(value); idx++) {
+		output.push_back(static_cast<uint8_t>(value >> (idx * BYTE_BITS)));
+	}
+}
+
+inline void appendString(std::vector<uint8_t>& output, std::string_view str)
+{
+	appendVarint(output, str.size());
+	output.insert(output.end(), str.begin(), str.end());
+}
+
+/** @brief Append the @p table including its tag. */
+inline void appendTable(std::vector<uint8_t>& output, const Table& table)
+{
+	output.push_back(tag::TABLE);
+	appendVarint(output, table.rowCount());
+	appendVarint(output, table.columns().size());
+
+	for (const auto& column : table.columns()) {
+		output.push_back(tag::KEY);
+		appendString(output, column.name);
+
+		if (!column.unit.empty()) {
+			output.push_back(tag::UNIT);
+			appendString(output, column.unit);
+		}
+
+		if (const auto* values = std::get_if<TableColumn::Values<uint64_t>>(&column.data)) {
+			output.push_back(tag::UINT);
+			for (const uint64_t value : *values) {
+				appendVarint(output, value);
+			}
+		} else if (const auto* values = std::get_if<TableColumn::Values<int64_t>>(&column.data)) {
+			output.push_back(tag::INT);
+			for (const int64_t value : *values) {
+				appendVarint(output, zigzagEncode(value));
+			}
+		} else {
+			output.push_back(tag::DOUBLE);
+			for (const double value : std::get<TableColumn::Values<double>>(column.data)) {
+				appendFixed64(output, std::bit_cast<uint64_t>(value));
+			}
+		}
+	}
+}
+
+/** @brief Append the @p histogram including its tag. */
+inline void appendHistogram(std::vector<uint8_t>& output, const Histogram& histogram)
+{
+	output.push_back(tag::HISTOGRAM);
+
+	if (!histogram.unit().empty()) {
+		output.push_back(tag::UNIT);
+		appendString(output, histogram.unit());
+	}
+
+	appendVarint(output, histogram.precision());
+	appendVarint(output, histogram.sum());
+	appendVarint(output, histogram.min());
+	appendVarint(output, histogram.max());
+	appendVarint(output, histogram.buckets().size());
+
+	uint32_t next = 0;
+	for (const auto& bucket : histogram.buckets()) {
+		appendVarint(output, bucket.index - next);
+		appendVarint(output, bucket.count);
+		next = bucket.index + 1;
+	}
+}
+
+/** @brief Append the quantile @p sketch including its tag. */
+inline void appendQuantileSketch(std::vector<uint8_t>& output, const QuantileSketch& sketch)
+{
+	output.push_back(tag::SKETCH);
+
+	if (!sketch.unit().empty()) {
+		output.push_back(tag::UNIT);
+		appendString(output, sketch.unit());
+	}
+
+	appendFixed64(output, std::bit_cast<uint64_t>(sketch.relativeAccuracy()));
+	appendVarint(output, sketch.maxBuckets());
+	appendVarint(output, zigzagEncode(sketch.offset()));
+	appendFixed64(output, std::bit_cast<uint64_t>(sketch.sum()));
+	appendFixed64(output, std::bit_cast<uint64_t>(sketch.min()));
+	appendFixed64(output, std::bit_cast<uint64_t>(sketch.max()));
+	appendVarint(output, sketch.zeroCount());
+	appendVarint(output, sketch.counts().size());
+
+	for (const uint64_t count : sketch.counts()) {
+		appendVarint(output, count);
+	}
+}
+
+/** @brief Append the @p topK summary including its tag. */
+inline void appendTopK(std::vector<uint8_t>& output, const TopK& topK)
+{
+	output.push_back(tag::TOPK);
+	appendVarint(output, topK.capacity());
+	appendVarint(output, topK.count());
+	appendVarint(output, topK.items().size());
+
+	for (const auto& item : topK.items()) {
+		appendString(output, item.key);
+		appendVarint(output, item.count);
+		appendVarint(output, item.error);
+	}
+}
+
+/** @brief Append the @p hyperLogLog including its tag. */
+inline void appendHyperLogLog(std::vector<uint8_t>& output, const HyperLogLog& hyperLogLog)
+{
+	const auto& registers = hyperLogLog.registers();
+
+	output.push_back(tag::HYPERLOGLOG);
+	appendVarint(output, hyperLogLog.precision());
+	const auto zeros = static_cast<size_t>(std::ranges::count(registers, 0));
+	appendVarint(output, registers.size() - zeros);
+
+	size_t next = 0;
+	for (size_t idx = 0; idx < registers.size(); idx++) {
+		if (registers[idx] != 0) {
+			appendVarint(output, idx - next);
+			output.push_back(registers[idx]);
+			next = idx + 1;
+		}
+	}
+}
+
+/**
+ * @brief Reader of primitives of the binary encoding with bounds checking.
+ *
+ * Errors are reported by TelemetryException with messages prefixed by the name of
+ * the decoding function.
+ */
+class ByteReader {
+public:
+	ByteReader(std::span<const uint8_t> data, std::string_view function)
+		: m_data(data)
+		, m_function(function)
+	{
+	}
+
+	/**
+	 * @brief Check the header (magic bytes and the version) at the beginning of the data.
+	 */
+	void readHeader(const std::array<uint8_t, 2>& magic, uint8_t version)
+	{
+		if (m_data.size() < magic.size() + 1 || m_data[0] != magic[0] || m_data[1] != magic[1]) {
+			fail("invalid header");
+		}
+
+		m_pos = magic.size();
+		if (readByte() != version) {
+			fail("unsupported version");
+		}
+	}
+
+	[[nodiscard]] bool atEnd() const noexcept { return m_pos == m_data.size(); }
+	[[nodiscard]] size_t remaining() const noexcept { return m_data.size() - m_pos; }
+
+	uint8_t peekByte()
+	{
+		if (m_pos >= m_data.size()) {
+			fail("unexpected end of data");
+		}
+		return m_data[m_pos];
+	}
+
+	uint8_t readByte()
+	{
+		if (m_pos >= m_data.size()) {
+			fail("unexpected end of data");
+		}
+		return m_data[m_pos++];
+	}
+
+	uint64_t readVarint()
+	{
+		uint64_t value = 0;
+
+		for (unsigned shift = 0; shift < sizeof(value) * BYTE_BITS; shift += VARINT_BITS) {
+			const uint8_t byte = readByte();
+			value |= static_cast<uint64_t>(byte & VARINT_MASK) << shift;
+			if ((byte & VARINT_CONTINUE) == 0) {
+				return value;
+			}
+		}
+
+		fail("invalid variable length integer");
+	}
+
+	uint64_t readFixed64()
+	{
+		uint64_t value = 0;
+		for (unsigned idx = 0; idx < sizeof(value); idx++) {
+			value |= static_cast<uint64_t>(readByte()) << (idx * BYTE_BITS);
+		}
+		return value;
+	}
+
+	std::string_view readString()
+	{
+		const uint64_t length = readVarint();
+		if (length > m_data.size() - m_pos) {
+			fail("unexpected end of data");
+		}
+
+		const auto* begin = reinterpret_cast<const char*>(m_data.data() + m_pos);
+		m_pos += length;
+		return {begin, length};
+	}
+
+	/**
+	 * @brief Read a table (following its tag).
+	 */
+	Table readTable()
+	{
+		const uint64_t rows = readVarint();
+		const uint64_t columns = readVarint();
+		// Each column takes at least three bytes and each of its values at least one
+		if (columns > remaining() || (columns > 0 && rows > remaining())) {
+			fail("invalid table");
+		}
+
+		Table table(rows);
+		for (uint64_t idx = 0; idx < columns; idx++) {
+			uint8_t tag = readByte();
+			if (tag != tag::KEY) {
+				failUnexpectedTag(tag, "a table column");
+			}
+
+			const std::string_view name = readString();
+			if (name.empty() || table.findColumn(name) != nullptr) {
+				fail("invalid table column name");
+			}
+
+			std::string_view unit;
+			tag = readByte();
+			if (tag == tag::UNIT) {
+				unit = readString();
+				tag = readByte();
+			}
+
+			switch (tag) {
+			case tag::UINT:
+				for (auto& value : table.addColumn<uint64_t>(name, unit)) {
+					value = readVarint();
+				}
+				break;
+			case tag::INT:
+				for (auto& value : table.addColumn<int64_t>(name, unit)) {
+					value = zigzagDecode(readVarint());
+				}
+				break;
+			case tag::DOUBLE:
+				for (auto& value : table.addColumn<double>(name, unit)) {
+					value = std::bit_cast<double>(readFixed64());
+				}
+				break;
+			default:
+				failUnexpectedTag(tag, "a type of table column");
+			}
+		}
+
+		return table;
+	}
+
+	/**
+	 * @brief Read a histogram (following its tag).
+	 */
+	Histogram readHistogram()
+	{
+		std::string_view unit;
+		if (peekByte() == tag::UNIT) {
+			readByte();
+			unit = readString();
+		}
+
+		const uint64_t precision = readVarint();
+		const uint64_t sum = readVarint();
+		const uint64_t min = readVarint();
+		const uint64_t max = readVarint();
+		const uint64_t count = readVarint();
+		// Each bucket takes at least two bytes
+		if (precision > Histogram::MAX_PRECISION || count > remaining() / 2) {
+			fail("invalid histogram");
+		}
+
+		Histogram::Buckets buckets;
+		buckets.reserve(count);
+
+		uint64_t next = 0;
+		for (uint64_t idx = 0; idx < count; idx++) {
+			const uint64_t index = next + readVarint();
+			if (index < next || index > std::numeric_limits<uint32_t>::max()) {
+				fail("invalid histogram bucket");
+			}
+
+			buckets.push_back({static_cast<uint32_t>(index), readVarint()});
+			next = index + 1;
+		}
+
+		try {
+			return Histogram::fromParts(
+				unit,
+				static_cast<unsigned>(precision),
+				std::move(buckets),
+				sum,
+				min,
+				max);
+		} catch (const TelemetryException&) {
+			fail("invalid histogram");
+		}
+	}
+
+	/**
+	 * @brief Read a quantile sketch (following its tag).
+	 */
+	QuantileSketch readQuantileSketch()
+	{
+		std::string_view unit;
+		if (peekByte() == tag::UNIT) {
+			readByte();
+			unit = readString();
+		}
+
+		const auto relativeAccuracy = std::bit_cast<double>(readFixed64());
+		const uint64_t maxBuckets = readVarint();
+		const int64_t offset = zigzagDecode(readVarint());
+		const auto sum = std::bit_cast<double>(readFixed64());
+		const auto min = std::bit_cast<double>(readFixed64());
+		const auto max = std::bit_cast<double>(readFixed64());
+		const uint64_t zeroCount = readVarint();
+		const uint64_t count = readVarint();
+		if (maxBuckets > std::numeric_limits<uint32_t>::max()
+			|| offset < std::numeric_limits<int32_t>::min()
+			|| offset > std::numeric_limits<int32_t>::max() || count > remaining()) {
+			fail("invalid quantile sketch");
+		}
+
+		QuantileSketch::Counts counts(count);
+		for (auto& value : counts) {
+			value = readVarint();
+		}
+
+		try {
+			return QuantileSketch::fromParts(
+				unit,
+				relativeAccuracy,
+				static_cast<uint32_t>(maxBuckets),
+				static_cast<int32_t>(offset),
+				std::move(counts),
+				zeroCount,
+				sum,
+				min,
+				max);
+		} catch (const TelemetryException&) {
+			fail("invalid quantile sketch");
+		}
+	}
+
+	/**
+	 * @brief Read a top-K summary (following its tag).
+	 */
+	TopK readTopK()
+	{
+		const uint64_t capacity = readVarint();
+		const uint64_t total = readVarint();
+		const uint64_t count = readVarint();
+		// Each item takes at least three bytes
+		if (count > capacity || count > remaining() / 3) {
+			fail("invalid top-K summary");
+		}
+
+		TopK::Items items;
+		items.reserve(count);
+		for (uint64_t idx = 0; idx < count; idx++) {
+			std::string key(readString());
+			const uint64_t itemCount = readVarint();
+			items.push_back({std::move(key), itemCount, readVarint()});
+		}
+
+		try {
+			return TopK::fromParts(capacity, std::move(items), total);
+		} catch (const TelemetryException&) {
+			fail("invalid top-K summary");
+		}
+	}
+
+	/**
+	 * @brief Read a HyperLogLog (following its tag).
+	 */
+	HyperLogLog readHyperLogLog()
+	{
+		const uint64_t precision = readVarint();
+		const uint64_t count = readVarint();
+		if (precision < HyperLogLog::MIN_PRECISION || precision > HyperLogLog::MAX_PRECISION) {
+			fail("invalid HyperLogLog");
+		}
+
+		HyperLogLog::Registers registers(size_t {1} << precision);
+		// Each register takes at least two bytes
+		if (count > registers.size() || count > remaining() / 2) {
+			fail("invalid HyperLogLog");
+		}
+
+		uint64_t next = 0;
+		for (uint64_t idx = 0; idx < count; idx++) {
+			const uint64_t index = next + readVarint();
+			if (index < next || index >= registers.size()) {
+				fail("invalid HyperLogLog register");
+			}
+
+			registers[index] = readByte();
+			next = index + 1;
+		}
+
+		try {
+			return HyperLogLog::fromRegisters(
+				static_cast<unsigned>(precision),
+				std::move(registers));
+		} catch (const TelemetryException&) {
+			fail("invalid HyperLogLog");
+		}
+	}
+
+	[[noreturn]] void fail(std::string_view reason) const
+	{
+		std::string message(m_function);
+		message += ": ";
+		message += reason;
+		throw TelemetryException(message);
+	}
+
+	[[noreturn]] void failUnexpectedTag(uint8_t tag, std::string_view expected) const
+	{
+		std::string message("unexpected tag ");
+		message += std::to_string(tag);
+		message += ", expected ";
+		message += expected;
+		fail(message);
+	}
+
+private:
+	std::span<const uint8_t> m_data;
+	size_t m_pos = 0;
+	std::string_view m_function;
+};
+
+} // namespace telemetry
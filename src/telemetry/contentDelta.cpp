@@ -0,0 +1,708 @@
+/**
+ * @file
+ * @author Pavel Siska <siska@cesnet.cz>
+ * @brief Delta encoding of successive snapshots of telemetry content
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "contentCodecFormat.hpp"
+
+#include <telemetry/contentCodec.hpp>
+#include <telemetry/contentDelta.hpp>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <type_traits>
+
+namespace telemetry {
+
+/*
+ * Encoding of a delta (items of the content encoding are used for values stored in full):
+ *   header     := 'T' 'D' version
+ *   delta      := SAME | DICT_PATCH dictPatch | dict | TABLE_PATCH tablePatch | table
+ *               | histogram | sketch | value
+ *   dictPatch  := varint-count (string-key (REMOVED | value))*
+ *   value      := NA_VALUE | DELTA_UINT zigzag-varint | DELTA_INT zigzag-varint
+ *               | DELTA_DOUBLE varint-xor | ARRAY_PATCH arrayPatch | scalarItem | array
+ *   arrayPatch := varint-size varint-count (varint-gap (numericDelta | scalar))*
+ *   tablePatch := (zigzag-varint | varint-xor)*
+ *
+ * Numeric deltas are applied to the previous scalar (its unit is kept). Indices of changed
+ * array elements are stored as gaps from the element following the previous changed one.
+ * A table patch is used only if the previous table has the same rows and columns, it holds
+ * differences of all values of all columns (XOR for doubles) without tags. A changed
+ * histogram or quantile sketch is stored in full.
+ */
+namespace tag {
+constexpr uint8_t SAME = 0x20;
+constexpr uint8_t DELTA_UINT = 0x21;
+constexpr uint8_t DELTA_INT = 0x22;
+constexpr uint8_t DELTA_DOUBLE = 0x23;
+constexpr uint8_t ARRAY_PATCH = 0x24;
+constexpr uint8_t DICT_PATCH = 0x25;
+constexpr uint8_t REMOVED = 0x26;
+constexpr uint8_t NA_VALUE = 0x27;
+constexpr uint8_t TABLE_PATCH = 0x28;
+} // namespace tag
+
+static constexpr std::array<uint8_t, 2> DELTA_MAGIC = {'T', 'D'};
+
+template <typename... T>
+constexpr bool g_AlwaysFalse = false;
+
+/**
+ * @brief Convert scalars and arrays to a dictionary value.
+ * @return Converted value or an unknown value for other content.
+ */
+static DictValue toDictValue(const Content& content)
+{
+	auto visitor = [](const auto& arg) -> DictValue {
+		using T = std::decay_t<decltype(arg)>;
+
+		if constexpr (
+			std::is_same_v<T, Dict> || std::is_same_v<T, Table> || std::is_same_v<T, Histogram>
+			|| std::is_same_v<T, QuantileSketch> || std::is_same_v<T, HyperLogLog>
+			|| std::is_same_v<T, TopK>) {
+			return std::monostate();
+		} else if constexpr (
+			std::is_same_v<T, Scalar> || std::is_same_v<T, ScalarWithUnit>
+			|| std::is_same_v<T, Array>) {
+			return arg;
+		} else {
+			static_assert(g_AlwaysFalse<T>, "non-exhaustive visitor");
+		}
+	};
+
+	return std::visit(visitor, content);
+}
+
+/**
+ * @brief Check that tables have the same rows and columns (names, units and types).
+ */
+static bool hasSameLayout(const Table& previous, const Table& current)
+{
+	return previous.rowCount() == current.rowCount()
+		&& std::equal(
+			   previous.columns().begin(),
+			   previous.columns().end(),
+			   current.columns().begin(),
+			   current.columns().end(),
+			   [](const TableColumn& prev, const TableColumn& cur) {
+				   return prev.name == cur.name && prev.unit == cur.unit
+					   && prev.data.index() == cur.data.index();
+			   });
+}
+
+/**
+ * @brief Call @p callback for each key that differs between the dictionaries.
+ *
+ * The callback gets the key and pointers to the previous and the current value (nullptr
+ * if the key is missing in the dictionary).
+ */
+template <typename Callback>
+static void forEachDictChange(const Dict& previous, const Dict& current, Callback&& callback)
+{
+	auto prevIter = previous.begin();
+	auto curIter = current.begin();
+
+	while (prevIter != previous.end() || curIter != current.end()) {
+		if (curIter == current.end()
+			|| (prevIter != previous.end() && prevIter->first < curIter->first)) {
+			callback(prevIter->first, &prevIter->second, nullptr);
+			++prevIter;
+		} else if (prevIter == previous.end() || curIter->first < prevIter->first) {
+			callback(curIter->first, nullptr, &curIter->second);
+			++curIter;
+		} else {
+			if (prevIter->second != curIter->second) {
+				callback(curIter->first, &prevIter->second, &curIter->second);
+			}
+			++prevIter;
+			++curIter;
+		}
+	}
+}
+
+/**
+ * @brief Encoder of differences between two snapshots.
+ */
+class ContentDeltaEncoder {
+public:
+	std::vector<uint8_t> encode(const Content& previous, const Content& current)
+	{
+		m_data.assign(DELTA_MAGIC.begin(), DELTA_MAGIC.end());
+		m_data.push_back(CONTENT_DELTA_VERSION);
+
+		const auto* prevDict = std::get_if<Dict>(&previous);
+		const auto* curDict = std::get_if<Dict>(&current);
+		const auto* prevTable = std::get_if<Table>(&previous);
+		const auto* curTable = std::get_if<Table>(&current);
+		const auto* curHistogram = std::get_if<Histogram>(&current);
+		const auto* curSketch = std::get_if<QuantileSketch>(&current);
+		const auto* curHyperLogLog = std::get_if<HyperLogLog>(&current);
+		const auto* curTopK = std::get_if<TopK>(&current);
+
+		if (previous == current) {
+			m_data.push_back(tag::SAME);
+		} else if (prevDict != nullptr && curDict != nullptr) {
+			encodeDictPatch(*prevDict, *curDict);
+		} else if (curDict != nullptr) {
+			encodeDict(*curDict);
+		} else if (
+			prevTable != nullptr && curTable != nullptr && hasSameLayout(*prevTable, *curTable)) {
+			encodeTablePatch(*prevTable, *curTable);
+		} else if (curTable != nullptr) {
+			appendTable(m_data, *curTable);
+		} else if (curHistogram != nullptr) {
+			appendHistogram(m_data, *curHistogram);
+		} else if (curSketch != nullptr) {
+			appendQuantileSketch(m_data, *curSketch);
+		} else if (curHyperLogLog != nullptr) {
+			appendHyperLogLog(m_data, *curHyperLogLog);
+		} else if (curTopK != nullptr) {
+			appendTopK(m_data, *curTopK);
+		} else {
+			encodeValueChange(toDictValue(previous), toDictValue(current));
+		}
+
+		return std::move(m_data);
+	}
+
+private:
+	void encodeScalar(const Scalar& scalar)
+	{
+		auto visitor = [this](const auto& arg) {
+			using T = std::decay_t<decltype(arg)>;
+
+			if constexpr (std::is_same_v<T, std::monostate>) {
+				m_data.push_back(tag::NONE);
+			} else if constexpr (std::is_same_v<T, bool>) {
+				m_data.push_back(arg ? tag::BOOL_TRUE : tag::BOOL_FALSE);
+			} else if constexpr (std::is_same_v<T, uint64_t>) {
+				m_data.push_back(tag::UINT);
+				appendVarint(m_data, arg);
+			} else if constexpr (std::is_same_v<T, int64_t>) {
+				m_data.push_back(tag::INT);
+				appendVarint(m_data, zigzagEncode(arg));
+			} else if constexpr (std::is_same_v<T, double>) {
+				m_data.push_back(tag::DOUBLE);
+				appendFixed64(m_data, std::bit_cast<uint64_t>(arg));
+			} else if constexpr (std::is_same_v<T, std::string>) {
+				m_data.push_back(tag::STRING);
+				appendString(m_data, arg);
+			} else {
+				static_assert(g_AlwaysFalse<T>, "non-exhaustive visitor");
+			}
+		};
+
+		std::visit(visitor, scalar);
+	}
+
+	void encodeValue(const DictValue& value)
+	{
+		auto visitor = [this](const auto& arg) {
+			using T = std::decay_t<decltype(arg)>;
+
+			if constexpr (std::is_same_v<T, std::monostate>) {
+				m_data.push_back(tag::NA_VALUE);
+			} else if constexpr (std::is_same_v<T, Scalar>) {
+				encodeScalar(arg);
+			} else if constexpr (std::is_same_v<T, ScalarWithUnit>) {
+				m_data.push_back(tag::UNIT);
+				appendString(m_data, arg.second);
+				encodeScalar(arg.first);
+			} else if constexpr (std::is_same_v<T, Array>) {
+				m_data.push_back(tag::ARRAY_BEGIN);
+				for (const auto& elem : arg) {
+					encodeScalar(elem);
+				}
+				m_data.push_back(tag::ARRAY_END);
+			} else {
+				static_assert(g_AlwaysFalse<T>, "non-exhaustive visitor");
+			}
+		};
+
+		std::visit(visitor, value);
+	}
+
+	void encodeDict(const Dict& dict)
+	{
+		m_data.push_back(tag::DICT_BEGIN);
+		for (const auto& [key, value] : dict) {
+			m_data.push_back(tag::KEY);
+			appendString(m_data, key);
+			encodeValue(value);
+		}
+		m_data.push_back(tag::DICT_END);
+	}
+
+	/**
+	 * @brief Encode the difference of numbers of the same type.
+	 * @return False if the scalars are not numbers of the same type.
+	 */
+	bool encodeNumericDelta(const Scalar& previous, const Scalar& current)
+	{
+		if (previous.index() != current.index()) {
+			return false;
+		}
+
+		if (const auto* cur = std::get_if<uint64_t>(&current)) {
+			m_data.push_back(tag::DELTA_UINT);
+			const uint64_t diff = *cur - std::get<uint64_t>(previous);
+			appendVarint(m_data, zigzagEncode(static_cast<int64_t>(diff)));
+			return true;
+		}
+
+		if (const auto* cur = std::get_if<int64_t>(&current)) {
+			const auto prev = std::get<int64_t>(previous);
+			const uint64_t diff = static_cast<uint64_t>(*cur) - static_cast<uint64_t>(prev);
+			m_data.push_back(tag::DELTA_INT);
+			appendVarint(m_data, zigzagEncode(static_cast<int64_t>(diff)));
+			return true;
+		}
+
+		if (const auto* cur = std::get_if<double>(&current)) {
+			const auto prev = std::get<double>(previous);
+			const uint64_t diff = std::bit_cast<uint64_t>(*cur) ^ std::bit_cast<uint64_t>(prev);
+			// Similar doubles share the sign, the exponent and the high bits of the mantissa
+			if (varintSize(diff) >= sizeof(diff)) {
+				return false;
+			}
+
+			m_data.push_back(tag::DELTA_DOUBLE);
+			appendVarint(m_data, diff);
+			return true;
+		}
+
+		return false;
+	}
+
+	void encodeScalarChange(const Scalar& previous, const Scalar& current)
+	{
+		if (!encodeNumericDelta(previous, current)) {
+			encodeScalar(current);
+		}
+	}
+
+	void encodeArrayPatch(const Array& previous, const Array& current)
+	{
+		auto isChanged = [&](size_t idx) {
+			return idx >= previous.size() || previous[idx] != current[idx];
+		};
+
+		size_t changed = 0;
+		for (size_t idx = 0; idx < current.size(); idx++) {
+			if (isChanged(idx)) {
+				changed++;
+			}
+		}
+
+		m_data.push_back(tag::ARRAY_PATCH);
+		appendVarint(m_data, current.size());
+		appendVarint(m_data, changed);
+
+		size_t next = 0;
+		for (size_t idx = 0; idx < current.size(); idx++) {
+			if (!isChanged(idx)) {
+				continue;
+			}
+
+			appendVarint(m_data, idx - next);
+			next = idx + 1;
+
+			if (idx < previous.size()) {
+				encodeScalarChange(previous[idx], current[idx]);
+			} else {
+				encodeScalar(current[idx]);
+			}
+		}
+	}
+
+	void encodeValueChange(const DictValue& previous, const DictValue& current)
+	{
+		const auto* prevScalar = std::get_if<Scalar>(&previous);
+		const auto* curScalar = std::get_if<Scalar>(&current);
+		if (prevScalar != nullptr && curScalar != nullptr) {
+			encodeScalarChange(*prevScalar, *curScalar);
+			return;
+		}
+
+		const auto* prevWithUnit = std::get_if<ScalarWithUnit>(&previous);
+		const auto* curWithUnit = std::get_if<ScalarWithUnit>(&current);
+		if (prevWithUnit != nullptr && curWithUnit != nullptr
+			&& prevWithUnit->second == curWithUnit->second
+			&& encodeNumericDelta(prevWithUnit->first, curWithUnit->first)) {
+			return;
+		}
+
+		const auto* prevArray = std::get_if<Array>(&previous);
+		const auto* curArray = std::get_if<Array>(&current);
+		if (prevArray != nullptr && curArray != nullptr) {
+			encodeArrayPatch(*prevArray, *curArray);
+			return;
+		}
+
+		encodeValue(current);
+	}
+
+	void encodeDictPatch(const Dict& previous, const Dict& current)
+	{
+		size_t changed = 0;
+		forEachDictChange(
+			previous,
+			current,
+			[&changed](const DictKey&, const DictValue*, const DictValue*) { changed++; });
+
+		m_data.push_back(tag::DICT_PATCH);
+		appendVarint(m_data, changed);
+
+		forEachDictChange(
+			previous,
+			current,
+			[this](const DictKey& key, const DictValue* prevValue, const DictValue* curValue) {
+				appendString(m_data, key);
+
+				if (curValue == nullptr) {
+					m_data.push_back(tag::REMOVED);
+				} else if (prevValue == nullptr) {
+					encodeValue(*curValue);
+				} else {
+					encodeValueChange(*prevValue, *curValue);
+				}
+			});
+	}
+
+	void encodeTablePatch(const Table& previous, const Table& current)
+	{
+		m_data.push_back(tag::TABLE_PATCH);
+
+		for (size_t idx = 0; idx < current.columns().size(); idx++) {
+			const auto& prevData = previous.columns()[idx].data;
+			const auto& curData = current.columns()[idx].data;
+
+			auto visitor = [&](const auto& curValues) {
+				using Values = std::decay_t<decltype(curValues)>;
+				const auto& prevValues = std::get<Values>(prevData);
+
+				for (size_t row = 0; row < curValues.size(); row++) {
+					if constexpr (std::is_same_v<typename Values::value_type, double>) {
+						appendVarint(
+							m_data,
+							std::bit_cast<uint64_t>(curValues[row])
+								^ std::bit_cast<uint64_t>(prevValues[row]));
+					} else {
+						const uint64_t diff = static_cast<uint64_t>(curValues[row])
+							- static_cast<uint64_t>(prevValues[row]);
+						appendVarint(m_data, zigzagEncode(static_cast<int64_t>(diff)));
+					}
+				}
+			};
+
+			std::visit(visitor, curData);
+		}
+	}
+
+	std::vector<uint8_t> m_data;
+};
+
+/**
+ * @brief Decoder of a delta that rebuilds the current snapshot.
+ */
+class ContentDeltaDecoder {
+public:
+	explicit ContentDeltaDecoder(std::span<const uint8_t> delta)
+		: m_reader(delta, "applyContentDelta()")
+	{
+	}
+
+	Content apply(const Content& previous)
+	{
+		m_reader.readHeader(DELTA_MAGIC, CONTENT_DELTA_VERSION);
+
+		Content result = decodeDelta(previous);
+
+		if (!m_reader.atEnd()) {
+			m_reader.fail("unexpected data after the delta");
+		}
+
+		return result;
+	}
+
+private:
+	Content decodeDelta(const Content& previous)
+	{
+		const uint8_t tag = m_reader.readByte();
+
+		if (tag == tag::SAME) {
+			return previous;
+		}
+
+		if (tag == tag::DICT_PATCH) {
+			const auto* prevDict = std::get_if<Dict>(&previous);
+			if (prevDict == nullptr) {
+				m_reader.fail("dictionary patch of a content that is not a dictionary");
+			}
+			return decodeDictPatch(*prevDict);
+		}
+
+		if (tag == tag::DICT_BEGIN) {
+			return decodeDict();
+		}
+
+		if (tag == tag::TABLE_PATCH) {
+			const auto* prevTable = std::get_if<Table>(&previous);
+			if (prevTable == nullptr) {
+				m_reader.fail("table patch of a content that is not a table");
+			}
+			return decodeTablePatch(*prevTable);
+		}
+
+		if (tag == tag::TABLE) {
+			return m_reader.readTable();
+		}
+
+		if (tag == tag::HISTOGRAM) {
+			return m_reader.readHistogram();
+		}
+
+		if (tag == tag::SKETCH) {
+			return m_reader.readQuantileSketch();
+		}
+
+		if (tag == tag::HYPERLOGLOG) {
+			return m_reader.readHyperLogLog();
+		}
+
+		if (tag == tag::TOPK) {
+			return m_reader.readTopK();
+		}
+
+		const DictValue prevValue = toDictValue(previous);
+		DictValue value = decodeValue(tag, &prevValue);
+		if (auto* scalar = std::get_if<Scalar>(&value)) {
+			return std::move(*scalar);
+		}
+		if (auto* scalarWithUnit = std::get_if<ScalarWithUnit>(&value)) {
+			return std::move(*scalarWithUnit);
+		}
+		if (auto* array = std::get_if<Array>(&value)) {
+			return std::move(*array);
+		}
+
+		m_reader.fail("unknown value is not a valid content");
+	}
+
+	Scalar decodeScalar(uint8_t tag)
+	{
+		switch (tag) {
+		case tag::NONE:
+			return {};
+		case tag::BOOL_FALSE:
+			return false;
+		case tag::BOOL_TRUE:
+			return true;
+		case tag::UINT:
+			return m_reader.readVarint();
+		case tag::INT:
+			return zigzagDecode(m_reader.readVarint());
+		case tag::DOUBLE:
+			return std::bit_cast<double>(m_reader.readFixed64());
+		case tag::STRING:
+			return std::string(m_reader.readString());
+		default:
+			m_reader.failUnexpectedTag(tag, "a scalar");
+		}
+	}
+
+	/**
+	 * @brief Decode a numeric delta (if the @p tag is a numeric delta) or a scalar.
+	 */
+	Scalar decodeScalarChange(uint8_t tag, const Scalar* previous)
+	{
+		if (tag != tag::DELTA_UINT && tag != tag::DELTA_INT && tag != tag::DELTA_DOUBLE) {
+			return decodeScalar(tag);
+		}
+
+		const uint64_t delta = m_reader.readVarint();
+
+		if (tag == tag::DELTA_UINT && previous != nullptr) {
+			if (const auto* prev = std::get_if<uint64_t>(previous)) {
+				return *prev + static_cast<uint64_t>(zigzagDecode(delta));
+			}
+		} else if (tag == tag::DELTA_INT && previous != nullptr) {
+			if (const auto* prev = std::get_if<int64_t>(previous)) {
+				const auto diff = static_cast<uint64_t>(zigzagDecode(delta));
+				return static_cast<int64_t>(static_cast<uint64_t>(*prev) + diff);
+			}
+		} else if (tag == tag::DELTA_DOUBLE && previous != nullptr) {
+			if (const auto* prev = std::get_if<double>(previous)) {
+				return std::bit_cast<double>(std::bit_cast<uint64_t>(*prev) ^ delta);
+			}
+		}
+
+		m_reader.fail("numeric delta doesn't match the previous value");
+	}
+
+	Array decodeArray()
+	{
+		Array array;
+		for (uint8_t tag = m_reader.readByte(); tag != tag::ARRAY_END; tag = m_reader.readByte()) {
+			array.emplace_back(decodeScalar(tag));
+		}
+		return array;
+	}
+
+	Array decodeArrayPatch(const Array& previous)
+	{
+		const uint64_t size = m_reader.readVarint();
+		const uint64_t changed = m_reader.readVarint();
+		// New elements are always changed and each change takes at least two bytes
+		if (changed > size || size - changed > previous.size() || changed > m_reader.remaining()) {
+			m_reader.fail("invalid array patch");
+		}
+
+		Array array = previous;
+		array.resize(size);
+
+		uint64_t next = 0;
+		for (uint64_t idx = 0; idx < changed; idx++) {
+			const uint64_t pos = next + m_reader.readVarint();
+			if (pos < next || pos >= size) {
+				m_reader.fail("array patch index out of range");
+			}
+
+			const Scalar* prev = pos < previous.size() ? &previous[pos] : nullptr;
+			array[pos] = decodeScalarChange(m_reader.readByte(), prev);
+			next = pos + 1;
+		}
+
+		return array;
+	}
+
+	Table decodeTablePatch(const Table& previous)
+	{
+		Table table(previous.rowCount());
+
+		for (const auto& column : previous.columns()) {
+			auto visitor = [&](const auto& prevValues) {
+				using Value = typename std::decay_t<decltype(prevValues)>::value_type;
+				auto values = table.addColumn<Value>(column.name, column.unit);
+
+				for (size_t row = 0; row < values.size(); row++) {
+					const uint64_t delta = m_reader.readVarint();
+					const auto prev = prevValues[row];
+					if constexpr (std::is_same_v<Value, double>) {
+						values[row] = std::bit_cast<double>(std::bit_cast<uint64_t>(prev) ^ delta);
+					} else {
+						const auto diff = static_cast<uint64_t>(zigzagDecode(delta));
+						values[row] = static_cast<Value>(static_cast<uint64_t>(prev) + diff);
+					}
+				}
+			};
+
+			std::visit(visitor, column.data);
+		}
+
+		return table;
+	}
+
+	DictValue decodeValue(uint8_t tag, const DictValue* previous)
+	{
+		switch (tag) {
+		case tag::NA_VALUE:
+			return std::monostate();
+		case tag::ARRAY_BEGIN:
+			return decodeArray();
+		case tag::ARRAY_PATCH: {
+			const auto* prevArray = previous != nullptr ? std::get_if<Array>(previous) : nullptr;
+			if (prevArray == nullptr) {
+				m_reader.fail("array patch of a value that is not an array");
+			}
+			return decodeArrayPatch(*prevArray);
+		}
+		case tag::UNIT: {
+			Unit unit(m_reader.readString());
+			return ScalarWithUnit {decodeScalar(m_reader.readByte()), std::move(unit)};
+		}
+		case tag::DELTA_UINT:
+		case tag::DELTA_INT:
+		case tag::DELTA_DOUBLE: {
+			// Numeric deltas keep the unit of the previous value
+			if (const auto* prevWithUnit
+				= previous != nullptr ? std::get_if<ScalarWithUnit>(previous) : nullptr) {
+				return ScalarWithUnit {
+					decodeScalarChange(tag, &prevWithUnit->first),
+					prevWithUnit->second};
+			}
+			const auto* prevScalar = previous != nullptr ? std::get_if<Scalar>(previous) : nullptr;
+			return decodeScalarChange(tag, prevScalar);
+		}
+		default:
+			return decodeScalar(tag);
+		}
+	}
+
+	Dict decodeDict()
+	{
+		Dict dict;
+		for (uint8_t tag = m_reader.readByte(); tag != tag::DICT_END; tag = m_reader.readByte()) {
+			if (tag != tag::KEY) {
+				m_reader.failUnexpectedTag(tag, "a dictionary key");
+			}
+
+			DictKey key(m_reader.readString());
+			dict.insert_or_assign(std::move(key), decodeValue(m_reader.readByte(), nullptr));
+		}
+		return dict;
+	}
+
+	Dict decodeDictPatch(const Dict& previous)
+	{
+		Dict dict = previous;
+
+		const uint64_t changed = m_reader.readVarint();
+		for (uint64_t idx = 0; idx < changed; idx++) {
+			const std::string_view key = m_reader.readString();
+			const uint8_t tag = m_reader.readByte();
+
+			if (tag == tag::REMOVED) {
+				if (dict.erase(key) == 0) {
+					m_reader.fail("removed key doesn't exist in the previous content");
+				}
+				continue;
+			}
+
+			auto iter = dict.find(key);
+			const DictValue* prevValue = iter != dict.end() ? &iter->second : nullptr;
+			DictValue value = decodeValue(tag, prevValue);
+			dict.insert_or_assign(DictKey(key), std::move(value));
+		}
+
+		return dict;
+	}
+
+	ByteReader m_reader;
+};
+
+std::vector<uint8_t> encodeContentDelta(const Content& previous, const Content& current)
+{
+	return ContentDeltaEncoder().encode(previous, current);
+}
+
+std::vector<uint8_t> encodeContentDelta(std::span<const uint8_t> previous, const Content& current)
+{
+	return encodeContentDelta(decodeContent(previous), current);
+}
+
+Content applyContentDelta(const Content& previous, std::span<const uint8_t> delta)
+{
+	return ContentDeltaDecoder(delta).apply(previous);
+}
+
+} // namespace telemetry
+
+#ifdef TELEMETRY_ENABLE_TESTS
+#include "tests/testContentDelta.cpp"
+#endif
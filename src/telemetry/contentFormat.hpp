@@ -0,0 +1,50 @@
+/**
+ * @file
+ * @author Pavel Siska <siska@cesnet.cz>
+ * @brief Formatting of numbers in the human readable telemetry content
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#pragma once
+
+#include <array>
+#include <charconv>
+#include <string>
+#include <type_traits>
+
+namespace telemetry {
+
+/**
+ * @brief Append a number to the @p output in the human readable format.
+ *
+ * Integers are written in full, floating point numbers in fixed notation with 2 decimals
+ * (the same as std::fixed and std::setprecision(2) of iostreams).
+ *
+ * @param output Output buffer
+ * @param number Number to append
+ */
+template <typename T>
+inline void appendNumber(std::string& output, T number)
+{
+	// Enough for any 64-bit integer and for fixed notation of any double with 2 decimals
+	constexpr size_t bufferSize = 512;
+	std::array<char, bufferSize> buffer;
+
+	std::to_chars_result result;
+	if constexpr (std::is_floating_point_v<T>) {
+		constexpr int precision = 2;
+		result = std::to_chars(
+			buffer.data(),
+			buffer.data() + buffer.size(),
+			number,
+			std::chars_format::fixed,
+			precision);
+	} else {
+		result = std::to_chars(buffer.data(), buffer.data() + buffer.size(), number);
+	}
+
+	output.append(buffer.data(), result.ptr);
+}
+
+} // namespace telemetry
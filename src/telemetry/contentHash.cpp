@@ -0,0 +1,289 @@
+/**
+ * @file
+ * @author Pavel Siska <siska@cesnet.cz>
+ * @brief Hashing of telemetry content
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "contentCodecFormat.hpp"
+
+#include <telemetry/contentCodec.hpp>
+#include <telemetry/contentHash.hpp>
+
+#include <bit>
+#include <cstring>
+
+namespace telemetry {
+
+// Primes of the XXH64 algorithm
+static constexpr uint64_t PRIME1 = 11400714785074694791ULL;
+static constexpr uint64_t PRIME2 = 14029467366897019727ULL;
+static constexpr uint64_t PRIME3 = 1609587929392839161ULL;
+static constexpr uint64_t PRIME4 = 9650029242287828579ULL;
+static constexpr uint64_t PRIME5 = 2870177450012600261ULL;
+
+static constexpr std::array<uint8_t, 3> HASH_HEADER = {'T', 'C', CONTENT_CODEC_VERSION};
+
+// Maximal size of a tag followed by a variable length integer
+static constexpr size_t MAX_TAGGED_VARINT_SIZE = 11;
+
+static uint64_t readLittleEndian(const uint8_t* data, size_t size) noexcept
+{
+	uint64_t value = 0;
+	for (size_t idx = 0; idx < size; idx++) {
+		value |= static_cast<uint64_t>(data[idx]) << (idx * BYTE_BITS);
+	}
+	return value;
+}
+
+static uint64_t xxhRound(uint64_t accumulator, uint64_t input) noexcept
+{
+	accumulator += input * PRIME2;
+	accumulator = std::rotl(accumulator, 31);
+	return accumulator * PRIME1;
+}
+
+static uint64_t xxhMergeRound(uint64_t accumulator, uint64_t value) noexcept
+{
+	accumulator ^= xxhRound(0, value);
+	return accumulator * PRIME1 + PRIME4;
+}
+
+ContentHasher::ContentHasher()
+{
+	reset();
+}
+
+void ContentHasher::reset() noexcept
+{
+	constexpr uint64_t seed = 0;
+
+	m_accumulators = {seed + PRIME1 + PRIME2, seed + PRIME2, seed, seed - PRIME1};
+	m_bufferSize = 0;
+	m_totalLength = 0;
+
+	update(HASH_HEADER);
+}
+
+void ContentHasher::consumeStripe(const uint8_t* stripe) noexcept
+{
+	for (size_t lane = 0; lane < m_accumulators.size(); lane++) {
+		const uint64_t input = readLittleEndian(stripe + lane * sizeof(uint64_t), sizeof(uint64_t));
+		m_accumulators[lane] = xxhRound(m_accumulators[lane], input);
+	}
+}
+
+void ContentHasher::update(std::span<const uint8_t> data) noexcept
+{
+	m_totalLength += data.size();
+
+	if (m_bufferSize + data.size() < STRIPE_SIZE) {
+		std::memcpy(m_buffer.data() + m_bufferSize, data.data(), data.size());
+		m_bufferSize += data.size();
+		return;
+	}
+
+	if (m_bufferSize > 0) {
+		const size_t fill = STRIPE_SIZE - m_bufferSize;
+		std::memcpy(m_buffer.data() + m_bufferSize, data.data(), fill);
+		consumeStripe(m_buffer.data());
+		data = data.subspan(fill);
+		m_bufferSize = 0;
+	}
+
+	while (data.size() >= STRIPE_SIZE) {
+		consumeStripe(data.data());
+		data = data.subspan(STRIPE_SIZE);
+	}
+
+	std::memcpy(m_buffer.data(), data.data(), data.size());
+	m_bufferSize = data.size();
+}
+
+uint64_t ContentHasher::digest() const noexcept
+{
+	uint64_t hash;
+
+	if (m_totalLength >= STRIPE_SIZE) {
+		const auto& acc = m_accumulators;
+		hash = std::rotl(acc[0], 1) + std::rotl(acc[1], 7) + std::rotl(acc[2], 12)
+			+ std::rotl(acc[3], 18);
+		for (const uint64_t accumulator : acc) {
+			hash = xxhMergeRound(hash, accumulator);
+		}
+	} else {
+		hash = m_accumulators[2] + PRIME5;
+	}
+
+	hash += m_totalLength;
+
+	const uint8_t* pos = m_buffer.data();
+	const uint8_t* end = m_buffer.data() + m_bufferSize;
+
+	for (; pos + sizeof(uint64_t) <= end; pos += sizeof(uint64_t)) {
+		hash ^= xxhRound(0, readLittleEndian(pos, sizeof(uint64_t)));
+		hash = std::rotl(hash, 27) * PRIME1 + PRIME4;
+	}
+
+	if (pos + sizeof(uint32_t) <= end) {
+		hash ^= readLittleEndian(pos, sizeof(uint32_t)) * PRIME1;
+		hash = std::rotl(hash, 23) * PRIME2 + PRIME3;
+		pos += sizeof(uint32_t);
+	}
+
+	for (; pos < end; pos++) {
+		hash ^= *pos * PRIME5;
+		hash = std::rotl(hash, 11) * PRIME1;
+	}
+
+	hash ^= hash >> 33U;
+	hash *= PRIME2;
+	hash ^= hash >> 29U;
+	hash *= PRIME3;
+	hash ^= hash >> 32U;
+
+	return hash;
+}
+
+void ContentHasher::updateTag(uint8_t tag) noexcept
+{
+	update(std::span<const uint8_t>(&tag, 1));
+}
+
+void ContentHasher::updateVarint(uint8_t tag, uint64_t value) noexcept
+{
+	std::array<uint8_t, MAX_TAGGED_VARINT_SIZE> buffer;
+	size_t size = 0;
+
+	buffer[size++] = tag;
+	while (value > VARINT_MASK) {
+		buffer[size++] = static_cast<uint8_t>((value & VARINT_MASK) | VARINT_CONTINUE);
+		value >>= VARINT_BITS;
+	}
+	buffer[size++] = static_cast<uint8_t>(value);
+
+	update(std::span<const uint8_t>(buffer.data(), size));
+}
+
+void ContentHasher::updateString(uint8_t tag, std::string_view str) noexcept
+{
+	updateVarint(tag, str.size());
+	update(std::span<const uint8_t>(reinterpret_cast<const uint8_t*>(str.data()), str.size()));
+}
+
+void ContentHasher::beginDict()
+{
+	updateTag(tag::DICT_BEGIN);
+}
+
+void ContentHasher::key(std::string_view key)
+{
+	updateString(tag::KEY, key);
+}
+
+void ContentHasher::endDict()
+{
+	updateTag(tag::DICT_END);
+}
+
+void ContentHasher::beginArray()
+{
+	updateTag(tag::ARRAY_BEGIN);
+}
+
+void ContentHasher::endArray()
+{
+	updateTag(tag::ARRAY_END);
+}
+
+void ContentHasher::unit(std::string_view unit)
+{
+	updateString(tag::UNIT, unit);
+}
+
+void ContentHasher::value(std::monostate)
+{
+	updateTag(tag::NONE);
+}
+
+void ContentHasher::value(bool value)
+{
+	updateTag(value ? tag::BOOL_TRUE : tag::BOOL_FALSE);
+}
+
+void ContentHasher::value(uint64_t value)
+{
+	updateVarint(tag::UINT, value);
+}
+
+void ContentHasher::value(int64_t value)
+{
+	updateVarint(tag::INT, zigzagEncode(value));
+}
+
+void ContentHasher::value(double value)
+{
+	std::array<uint8_t, 1 + sizeof(uint64_t)> buffer;
+	const auto bits = std::bit_cast<uint64_t>(value);
+
+	buffer[0] = tag::DOUBLE;
+	for (unsigned idx = 0; idx < sizeof(bits); idx++) {
+		buffer[1 + idx] = static_cast<uint8_t>(bits >> (idx * BYTE_BITS));
+	}
+
+	update(buffer);
+}
+
+void ContentHasher::value(std::string_view value)
+{
+	updateString(tag::STRING, value);
+}
+
+void ContentHasher::table(const Table& table)
+{
+	m_encoded.clear();
+	appendTable(m_encoded, table);
+	update(m_encoded);
+}
+
+void ContentHasher::histogram(const Histogram& histogram)
+{
+	m_encoded.clear();
+	appendHistogram(m_encoded, histogram);
+	update(m_encoded);
+}
+
+void ContentHasher::quantileSketch(const QuantileSketch& sketch)
+{
+	m_encoded.clear();
+	appendQuantileSketch(m_encoded, sketch);
+	update(m_encoded);
+}
+
+void ContentHasher::hyperLogLog(const HyperLogLog& hyperLogLog)
+{
+	m_encoded.clear();
+	appendHyperLogLog(m_encoded, hyperLogLog);
+	update(m_encoded);
+}
+
+void ContentHasher::topK(const TopK& topK)
+{
+	m_encoded.clear();
+	appendTopK(m_encoded, topK);
+	update(m_encoded);
+}
+
+uint64_t hashContent(const Content& content)
+{
+	ContentHasher hasher;
+	writeContent(hasher, content);
+	return hasher.digest();
+}
+
+} // namespace telemetry
+
+#ifdef TELEMETRY_ENABLE_TESTS
+#include "tests/testContentHash.cpp"
+#endif
@@ -0,0 +1,506 @@
+/**
+ * @file
+ * @author Pavel Siska <siska@cesnet.cz>
+ * @brief Streaming writer of telemetry content
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "contentFormat.hpp"
+
+#include <telemetry/contentWriter.hpp>
+#include <telemetry/node.hpp>
+
+#include <algorithm>
+#include <array>
+#include <type_traits>
+#include <utility>
+
+namespace telemetry {
+
+template <typename... T>
+constexpr bool g_AlwaysFalse = false;
+
+void ContentWriter::value(const Scalar& scalar)
+{
+	auto visitor = [this](const auto& arg) {
+		using T = std::decay_t<decltype(arg)>;
+
+		if constexpr (std::is_same_v<T, std::string>) {
+			this->value(std::string_view(arg));
+		} else {
+			this->value(arg);
+		}
+	};
+
+	std::visit(visitor, scalar);
+}
+
+void ContentWriter::table(const Table& table)
+{
+	beginDict();
+	for (const auto& column : table.columns()) {
+		key(column.name);
+		beginArray();
+		std::visit(
+			[this](const auto& values) {
+				for (const auto elem : values) {
+					this->value(elem);
+				}
+			},
+			column.data);
+		endArray();
+	}
+	endDict();
+}
+
+/**
+ * @brief Write the summary of a histogram or a quantile sketch as a dictionary.
+ */
+template <typename Distribution>
+static void writeSummary(ContentWriter& writer, const Distribution& distribution)
+{
+	static constexpr std::array<std::pair<std::string_view, double>, 4> QUANTILES {{
+		{"p50", 0.5},
+		{"p90", 0.9},
+		{"p99", 0.99},
+		{"p999", 0.999},
+	}};
+
+	auto writeValue = [&](std::string_view name, auto value) {
+		writer.key(name);
+		if (!distribution.unit().empty()) {
+			writer.unit(distribution.unit());
+		}
+		if (distribution.count() == 0) {
+			writer.value(std::monostate());
+		} else {
+			writer.value(value);
+		}
+	};
+
+	writer.beginDict();
+	writer.key("count");
+	writer.value(distribution.count());
+	writeValue("sum", distribution.sum());
+	writeValue("min", distribution.min());
+	writeValue("max", distribution.max());
+	writeValue("mean", distribution.mean());
+	for (const auto& [name, quantile] : QUANTILES) {
+		writeValue(name, distribution.valueAtQuantile(quantile));
+	}
+	writer.endDict();
+}
+
+void ContentWriter::histogram(const Histogram& histogram)
+{
+	writeSummary(*this, histogram);
+}
+
+void ContentWriter::quantileSketch(const QuantileSketch& sketch)
+{
+	writeSummary(*this, sketch);
+}
+
+void ContentWriter::hyperLogLog(const HyperLogLog& hyperLogLog)
+{
+	value(hyperLogLog.estimate());
+}
+
+void ContentWriter::topK(const TopK& topK)
+{
+	beginDict();
+	for (const auto& item : topK.items()) {
+		key(item.key);
+		value(item.count);
+	}
+	endDict();
+}
+
+static void writeDictValue(ContentWriter& writer, const DictValue& value)
+{
+	auto visitor = [&writer](const auto& arg) {
+		using T = std::decay_t<decltype(arg)>;
+
+		if constexpr (std::is_same_v<T, std::monostate> || std::is_same_v<T, Scalar>) {
+			writer.value(arg);
+		} else if constexpr (std::is_same_v<T, ScalarWithUnit>) {
+			writer.unit(arg.second);
+			writer.value(arg.first);
+		} else if constexpr (std::is_same_v<T, Array>) {
+			writer.beginArray();
+			for (const auto& elem : arg) {
+				writer.value(elem);
+			}
+			writer.endArray();
+		} else {
+			static_assert(g_AlwaysFalse<T>, "non-exhaustive visitor");
+		}
+	};
+
+	std::visit(visitor, value);
+}
+
+void writeContent(ContentWriter& writer, const Content& content)
+{
+	auto visitor = [&writer](const auto& arg) {
+		using T = std::decay_t<decltype(arg)>;
+
+		if constexpr (std::is_same_v<T, Dict>) {
+			writer.beginDict();
+			for (const auto& [key, value] : arg) {
+				writer.key(key);
+				writeDictValue(writer, value);
+			}
+			writer.endDict();
+		} else if constexpr (
+			std::is_same_v<T, Scalar> || std::is_same_v<T, ScalarWithUnit>
+			|| std::is_same_v<T, Array>) {
+			writeDictValue(writer, arg);
+		} else if constexpr (std::is_same_v<T, Table>) {
+			writer.table(arg);
+		} else if constexpr (std::is_same_v<T, Histogram>) {
+			writer.histogram(arg);
+		} else if constexpr (std::is_same_v<T, QuantileSketch>) {
+			writer.quantileSketch(arg);
+		} else if constexpr (std::is_same_v<T, HyperLogLog>) {
+			writer.hyperLogLog(arg);
+		} else if constexpr (std::is_same_v<T, TopK>) {
+			writer.topK(arg);
+		} else {
+			static_assert(g_AlwaysFalse<T>, "non-exhaustive visitor");
+		}
+	};
+
+	std::visit(visitor, content);
+}
+
+void TextContentWriter::beginDict()
+{
+	m_dictKeys.clear();
+	m_dictValues.clear();
+	m_dictEntries.clear();
+	m_target = &m_dictValues;
+}
+
+void TextContentWriter::key(std::string_view key)
+{
+	m_dictEntries.push_back({m_dictKeys.size(), key.size(), m_dictValues.size(), 0});
+	m_dictKeys.append(key);
+}
+
+void TextContentWriter::endDict()
+{
+	size_t maxKeyLen = 0;
+	for (const auto& entry : m_dictEntries) {
+		maxKeyLen = std::max(maxKeyLen, entry.keyLength);
+	}
+
+	for (size_t idx = 0; idx < m_dictEntries.size(); idx++) {
+		const auto& entry = m_dictEntries[idx];
+
+		if (idx > 0) {
+			m_output += '\n';
+		}
+
+		m_output.append(m_dictKeys, entry.keyOffset, entry.keyLength);
+		m_output += ':';
+		m_output.append(maxKeyLen - entry.keyLength + 1, ' ');
+		m_output.append(m_dictValues, entry.valueOffset, entry.valueLength);
+	}
+
+	m_target = &m_output;
+}
+
+void TextContentWriter::beginArray()
+{
+	*m_target += '[';
+	m_inArray = true;
+	m_arraySize = 0;
+}
+
+void TextContentWriter::endArray()
+{
+	*m_target += ']';
+	m_inArray = false;
+	endValue();
+}
+
+void TextContentWriter::unit(std::string_view unit)
+{
+	m_unit.assign(unit);
+	m_hasUnit = true;
+}
+
+void TextContentWriter::value(std::monostate)
+{
+	beginValue();
+	m_target->append("<N/A>");
+	endValue();
+}
+
+void TextContentWriter::value(bool value)
+{
+	beginValue();
+	m_target->append(value ? "true" : "false");
+	endValue();
+}
+
+void TextContentWriter::value(uint64_t value)
+{
+	beginValue();
+	appendNumber(*m_target, value);
+	endValue();
+}
+
+void TextContentWriter::value(int64_t value)
+{
+	beginValue();
+	appendNumber(*m_target, value);
+	endValue();
+}
+
+void TextContentWriter::value(double value)
+{
+	beginValue();
+	appendNumber(*m_target, value);
+	endValue();
+}
+
+void TextContentWriter::value(std::string_view value)
+{
+	beginValue();
+	m_target->append(value);
+	endValue();
+}
+
+void TextContentWriter::table(const Table& table)
+{
+	appendTableToString(*m_target, table);
+}
+
+void TextContentWriter::clear() noexcept
+{
+	m_output.clear();
+	m_dictKeys.clear();
+	m_dictValues.clear();
+	m_dictEntries.clear();
+	m_target = &m_output;
+	m_hasUnit = false;
+	m_inArray = false;
+	m_arraySize = 0;
+}
+
+void TextContentWriter::beginValue()
+{
+	if (m_inArray && m_arraySize++ > 0) {
+		m_target->append(", ");
+	}
+}
+
+void TextContentWriter::endValue()
+{
+	if (m_inArray) {
+		return;
+	}
+
+	if (m_hasUnit) {
+		m_target->append(" (");
+		m_target->append(m_unit);
+		m_target->append(")");
+		m_hasUnit = false;
+	}
+
+	if (m_target == &m_dictValues && !m_dictEntries.empty()) {
+		auto& entry = m_dictEntries.back();
+		entry.valueLength = m_dictValues.size() - entry.valueOffset;
+	}
+}
+
+void ContentBuilder::beginDict()
+{
+	if (m_dict.has_value() || m_array.has_value()) {
+		throw TelemetryException("ContentBuilder: unexpected beginning of a dictionary");
+	}
+
+	m_dict.emplace();
+}
+
+void ContentBuilder::key(std::string_view key)
+{
+	if (!m_dict.has_value() || m_array.has_value()) {
+		throw TelemetryException("ContentBuilder: dictionary key outside of a dictionary");
+	}
+
+	m_key.emplace(key);
+}
+
+void ContentBuilder::endDict()
+{
+	if (!m_dict.has_value() || m_array.has_value()) {
+		throw TelemetryException("ContentBuilder: unexpected end of a dictionary");
+	}
+
+	m_content = std::move(*m_dict);
+	m_dict.reset();
+	m_key.reset();
+}
+
+void ContentBuilder::beginArray()
+{
+	if (m_array.has_value()) {
+		throw TelemetryException("ContentBuilder: nested arrays are not supported");
+	}
+
+	m_array.emplace();
+}
+
+void ContentBuilder::endArray()
+{
+	if (!m_array.has_value()) {
+		throw TelemetryException("ContentBuilder: unexpected end of an array");
+	}
+
+	Array array = std::move(*m_array);
+	m_array.reset();
+
+	if (m_dict.has_value()) {
+		addDictValue(std::move(array));
+	} else {
+		m_content = std::move(array);
+	}
+}
+
+void ContentBuilder::unit(std::string_view unit)
+{
+	m_unit.emplace(unit);
+}
+
+void ContentBuilder::value(std::monostate)
+{
+	addScalar(std::monostate());
+}
+
+void ContentBuilder::value(bool value)
+{
+	addScalar(value);
+}
+
+void ContentBuilder::value(uint64_t value)
+{
+	addScalar(value);
+}
+
+void ContentBuilder::value(int64_t value)
+{
+	addScalar(value);
+}
+
+void ContentBuilder::value(double value)
+{
+	addScalar(value);
+}
+
+void ContentBuilder::value(std::string_view value)
+{
+	addScalar(std::string(value));
+}
+
+void ContentBuilder::table(const Table& table)
+{
+	if (m_dict.has_value() || m_array.has_value()) {
+		throw TelemetryException("ContentBuilder: table must be the whole content");
+	}
+
+	m_content = table;
+}
+
+void ContentBuilder::histogram(const Histogram& histogram)
+{
+	if (m_dict.has_value() || m_array.has_value()) {
+		throw TelemetryException("ContentBuilder: histogram must be the whole content");
+	}
+
+	m_content = histogram;
+}
+
+void ContentBuilder::quantileSketch(const QuantileSketch& sketch)
+{
+	if (m_dict.has_value() || m_array.has_value()) {
+		throw TelemetryException("ContentBuilder: quantile sketch must be the whole content");
+	}
+
+	m_content = sketch;
+}
+
+void ContentBuilder::hyperLogLog(const HyperLogLog& hyperLogLog)
+{
+	if (m_dict.has_value() || m_array.has_value()) {
+		throw TelemetryException("ContentBuilder: HyperLogLog must be the whole content");
+	}
+
+	m_content = hyperLogLog;
+}
+
+void ContentBuilder::topK(const TopK& topK)
+{
+	if (m_dict.has_value() || m_array.has_value()) {
+		throw TelemetryException("ContentBuilder: top-K summary must be the whole content");
+	}
+
+	m_content = topK;
+}
+
+Content ContentBuilder::takeContent()
+{
+	if (m_dict.has_value() || m_array.has_value()) {
+		throw TelemetryException("ContentBuilder: content is not complete");
+	}
+
+	Content content = m_content.has_value() ? std::move(*m_content) : Scalar {};
+	m_content.reset();
+	m_unit.reset();
+	return content;
+}
+
+void ContentBuilder::addScalar(Scalar scalar)
+{
+	if (m_array.has_value()) {
+		m_array->emplace_back(std::move(scalar));
+		return;
+	}
+
+	if (m_unit.has_value()) {
+		ScalarWithUnit scalarWithUnit {std::move(scalar), std::move(*m_unit)};
+		m_unit.reset();
+
+		if (m_dict.has_value()) {
+			addDictValue(std::move(scalarWithUnit));
+		} else {
+			m_content = std::move(scalarWithUnit);
+		}
+		return;
+	}
+
+	if (m_dict.has_value()) {
+		addDictValue(std::move(scalar));
+	} else {
+		m_content = std::move(scalar);
+	}
+}
+
+void ContentBuilder::addDictValue(DictValue value)
+{
+	if (!m_key.has_value()) {
+		throw TelemetryException("ContentBuilder: dictionary value without a key");
+	}
+
+	(*m_dict)[std::move(*m_key)] = std::move(value);
+	m_key.reset();
+}
+
+} // namespace telemetry
+
+#ifdef TELEMETRY_ENABLE_TESTS
+#include "tests/testContentWriter.cpp"
+#endif
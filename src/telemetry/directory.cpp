@@ -75,6 +75,41 @@ std::shared_ptr<File> Directory::addFile(std::string_view name, FileOps ops)
 	return newFile;
 }
 
+std::shared_ptr<File>
+Directory::addCounterFile(std::string_view name, std::shared_ptr<ShardedCounter> counter)
+{
+	FileOps ops;
+	ops.read = [counter]() { return Content {Scalar {counter->value()}}; };
+	ops.streamRead = [counter](ContentWriter& writer) { writer.value(counter->value()); };
+	ops.clear = [counter]() { counter->reset(); };
+
+	return addFile(name, std::move(ops));
+}
+
+std::shared_ptr<File>
+Directory::addCounterFile(std::string_view name, const std::atomic<uint64_t>& counter)
+{
+	FileOps ops;
+	ops.variable = FileVariable(counter);
+	return addFile(name, std::move(ops));
+}
+
+std::shared_ptr<File>
+Directory::addGaugeFile(std::string_view name, const std::atomic<int64_t>& gauge)
+{
+	FileOps ops;
+	ops.variable = FileVariable(gauge);
+	return addFile(name, std::move(ops));
+}
+
+std::shared_ptr<File>
+Directory::addGaugeFile(std::string_view name, const std::atomic<double>& gauge)
+{
+	FileOps ops;
+	ops.variable = FileVariable(gauge);
+	return addFile(name, std::move(ops));
+}
+
 std::shared_ptr<AggregatedFile> Directory::addAggFile(
 	std::string_view name,
 	const std::string& aggFilesPattern,
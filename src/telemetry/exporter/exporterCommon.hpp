@@ -0,0 +1,51 @@
+/**
+ * @file
+ * @author Pavel Siska <siska@cesnet.cz>
+ * @brief Common functions of telemetry exporters
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#pragma once
+
+#include <telemetry/directory.hpp>
+#include <telemetry/file.hpp>
+
+#include <memory>
+#include <string_view>
+
+namespace telemetry {
+
+/**
+ * @brief Walk a directory tree in the ascending order of entry names.
+ *
+ * The @p visitor is notified by:
+ * - enterDirectory(name) and leaveDirectory() around entries of each subdirectory,
+ * - visitFile(name, file) for each file with read operation.
+ *
+ * Symbolic links are skipped to avoid cycles and duplicates, as are expired entries.
+ *
+ * @param dir Root directory of the tree (not reported to the visitor)
+ * @param visitor Visitor of the tree
+ */
+template <typename Visitor>
+void walkDirectory(const std::shared_ptr<Directory>& dir, Visitor& visitor)
+{
+	for (const auto& name : dir->listEntries()) {
+		const auto node = dir->getEntry(name);
+
+		if (const auto subdir = std::dynamic_pointer_cast<Directory>(node)) {
+			visitor.enterDirectory(std::string_view(name));
+			walkDirectory(subdir, visitor);
+			visitor.leaveDirectory();
+			continue;
+		}
+
+		const auto file = std::dynamic_pointer_cast<File>(node);
+		if (file && file->hasRead()) {
+			visitor.visitFile(std::string_view(name), *file);
+		}
+	}
+}
+
+} // namespace telemetry
@@ -0,0 +1,329 @@
+/**
+ * @file
+ * @author Pavel Siska <siska@cesnet.cz>
+ * @brief Export of telemetry directories in the InfluxDB line protocol
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "../contentFormat.hpp"
+#include "exporterCommon.hpp"
+
+#include <telemetry/influxExporter.hpp>
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <exception>
+
+namespace telemetry {
+
+/**
+ * @brief Append the @p str to the @p output, characters from @p specials are escaped.
+ */
+static void appendEscaped(std::string& output, std::string_view str, std::string_view specials)
+{
+	for (const char chr : str) {
+		if (specials.find(chr) != std::string_view::npos) {
+			output += '\\';
+		}
+		output += chr;
+	}
+}
+
+// Special characters of measurements
+static constexpr std::string_view MEASUREMENT_SPECIALS = ", ";
+// Special characters of tag keys, tag values and field keys
+static constexpr std::string_view KEY_SPECIALS = ",= ";
+// Special characters of string field values
+static constexpr std::string_view STRING_SPECIALS = "\"\\";
+
+/**
+ * @brief Adapter of the exporter to the directory walker.
+ */
+class InfluxVisitor {
+public:
+	explicit InfluxVisitor(InfluxExporter& exporter)
+		: m_exporter(exporter)
+	{
+	}
+
+	void enterDirectory(std::string_view name) { m_exporter.enterEntry(name); }
+
+	void leaveDirectory() { m_exporter.leaveEntry(); }
+
+	void visitFile(std::string_view name, File& file)
+	{
+		m_exporter.enterEntry(name);
+		m_exporter.visitFile(file);
+		m_exporter.leaveEntry();
+	}
+
+private:
+	InfluxExporter& m_exporter;
+};
+
+InfluxExporter::InfluxExporter(std::string_view prefix)
+{
+	appendEscaped(m_prefix, prefix, MEASUREMENT_SPECIALS);
+}
+
+void InfluxExporter::setTagDirectory(std::string_view directoryName, std::string_view tagName)
+{
+	if (tagName.empty()) {
+		throw TelemetryException("InfluxExporter: empty tag name");
+	}
+
+	std::string escapedName;
+	appendEscaped(escapedName, tagName, KEY_SPECIALS);
+
+	for (auto& [dirName, tag] : m_tagDirectories) {
+		if (dirName == directoryName) {
+			tag = std::move(escapedName);
+			return;
+		}
+	}
+
+	m_tagDirectories.emplace_back(directoryName, std::move(escapedName));
+}
+
+void InfluxExporter::exportDirectory(
+	const std::shared_ptr<Directory>& dir,
+	std::span<char> buffer,
+	const Sink& sink,
+	std::chrono::system_clock::time_point timestamp)
+{
+	if (buffer.empty()) {
+		throw TelemetryException("InfluxExporter: empty output buffer");
+	}
+
+	const auto nanoseconds
+		= std::chrono::duration_cast<std::chrono::nanoseconds>(timestamp.time_since_epoch());
+	m_timestamp.clear();
+	appendNumber(m_timestamp, static_cast<int64_t>(nanoseconds.count()));
+
+	m_measurement = m_prefix;
+	m_tags.clear();
+	m_levels.clear();
+	m_levels.push_back({m_measurement.size(), 0, {}});
+
+	m_buffer = buffer;
+	m_bufferUsed = 0;
+	m_sink = &sink;
+
+	InfluxVisitor visitor(*this);
+	walkDirectory(dir, visitor);
+
+	flush();
+	m_buffer = {};
+	m_sink = nullptr;
+}
+
+std::string InfluxExporter::exportDirectory(
+	const std::shared_ptr<Directory>& dir,
+	std::chrono::system_clock::time_point timestamp)
+{
+	constexpr size_t bufferSize = 4096;
+	std::array<char, bufferSize> buffer;
+	std::string output;
+
+	const Sink sink = [&output](std::string_view chunk) { output += chunk; };
+	exportDirectory(dir, buffer, sink, timestamp);
+	return output;
+}
+
+void InfluxExporter::enterEntry(std::string_view name)
+{
+	const std::string_view parentTag = m_levels.back().entryTag;
+	Level level {m_measurement.size(), m_tags.size(), {}};
+
+	for (const auto& [dirName, tag] : m_tagDirectories) {
+		if (dirName == name) {
+			level.entryTag = tag;
+			break;
+		}
+	}
+
+	if (parentTag.empty()) {
+		if (!m_measurement.empty()) {
+			m_measurement += '/';
+		}
+		appendEscaped(m_measurement, name, MEASUREMENT_SPECIALS);
+	} else {
+		m_tags += ',';
+		m_tags += parentTag;
+		m_tags += '=';
+		appendEscaped(m_tags, name, KEY_SPECIALS);
+	}
+
+	m_levels.push_back(level);
+}
+
+void InfluxExporter::leaveEntry()
+{
+	const Level& level = m_levels.back();
+	m_measurement.resize(level.measurementLength);
+	m_tags.resize(level.tagsLength);
+	m_levels.pop_back();
+}
+
+void InfluxExporter::visitFile(File& file)
+{
+	m_line.clear();
+	m_line += m_measurement;
+	m_line += m_tags;
+	m_line += ' ';
+	m_fieldsOffset = m_line.size();
+
+	m_key.clear();
+	m_inArray = false;
+
+	try {
+		file.readTo(*this);
+	} catch (const std::exception&) {
+		// Fields of a partially read file are not written yet, the line is dropped
+		return;
+	}
+
+	if (m_line.size() == m_fieldsOffset) {
+		return;
+	}
+
+	m_line += ' ';
+	m_line += m_timestamp;
+	m_line += '\n';
+	write(m_line);
+}
+
+void InfluxExporter::beginDict() {}
+
+void InfluxExporter::key(std::string_view key)
+{
+	m_key.assign(key);
+}
+
+void InfluxExporter::endDict()
+{
+	m_key.clear();
+}
+
+void InfluxExporter::beginArray()
+{
+	m_inArray = true;
+	m_arrayIndex = 0;
+}
+
+void InfluxExporter::endArray()
+{
+	m_inArray = false;
+}
+
+void InfluxExporter::unit(std::string_view) {}
+
+void InfluxExporter::value(std::monostate)
+{
+	m_arrayIndex++;
+}
+
+void InfluxExporter::value(bool value)
+{
+	beginField();
+	m_line += value ? "true" : "false";
+}
+
+void InfluxExporter::value(uint64_t value)
+{
+	beginField();
+	appendNumber(m_line, value);
+	m_line += 'u';
+}
+
+void InfluxExporter::value(int64_t value)
+{
+	beginField();
+	appendNumber(m_line, value);
+	m_line += 'i';
+}
+
+void InfluxExporter::value(double value)
+{
+	if (!std::isfinite(value)) {
+		m_arrayIndex++;
+		return;
+	}
+
+	beginField();
+
+	// Enough for the shortest representation of any double
+	constexpr size_t bufferSize = 32;
+	std::array<char, bufferSize> buffer;
+
+	const auto result = std::to_chars(buffer.data(), buffer.data() + buffer.size(), value);
+	m_line.append(buffer.data(), result.ptr);
+}
+
+void InfluxExporter::value(std::string_view value)
+{
+	beginField();
+	m_line += '"';
+	appendEscaped(m_line, value, STRING_SPECIALS);
+	m_line += '"';
+}
+
+void InfluxExporter::beginField()
+{
+	if (m_line.size() > m_fieldsOffset) {
+		m_line += ',';
+	}
+
+	if (m_key.empty()) {
+		m_line += "value";
+	} else {
+		appendEscaped(m_line, m_key, KEY_SPECIALS);
+	}
+
+	if (m_inArray) {
+		m_line += '_';
+		appendNumber(m_line, m_arrayIndex++);
+	}
+
+	m_line += '=';
+}
+
+void InfluxExporter::write(std::string_view data)
+{
+	// Keep lines in a single chunk if possible
+	if (data.size() > m_buffer.size() - m_bufferUsed) {
+		flush();
+	}
+
+	while (!data.empty()) {
+		const size_t length = std::min(data.size(), m_buffer.size() - m_bufferUsed);
+		std::memcpy(m_buffer.data() + m_bufferUsed, data.data(), length);
+		m_bufferUsed += length;
+		data.remove_prefix(length);
+
+		if (m_bufferUsed == m_buffer.size()) {
+			flush();
+		}
+	}
+}
+
+void InfluxExporter::flush()
+{
+	if (m_bufferUsed == 0) {
+		return;
+	}
+
+	const std::string_view chunk(m_buffer.data(), m_bufferUsed);
+	m_bufferUsed = 0;
+	(*m_sink)(chunk);
+}
+
+} // namespace telemetry
+
+#ifdef TELEMETRY_ENABLE_TESTS
+#include "tests/testInfluxExporter.cpp"
+#endif
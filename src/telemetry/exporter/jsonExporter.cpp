@@ -0,0 +1,405 @@
+/**
+ * @file
+ * @author Pavel Siska <siska@cesnet.cz>
+ * @brief Export of telemetry content and directories to JSON
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "../contentFormat.hpp"
+#include "exporterCommon.hpp"
+
+#include <telemetry/jsonExporter.hpp>
+#include <telemetry/node.hpp>
+
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <exception>
+
+namespace telemetry {
+
+static void appendJsonString(std::string& output, std::string_view str)
+{
+	static constexpr std::string_view HEX_DIGITS = "0123456789abcdef";
+
+	output += '"';
+
+	for (const char chr : str) {
+		switch (chr) {
+		case '"':
+			output += "\\\"";
+			break;
+		case '\\':
+			output += "\\\\";
+			break;
+		case '\b':
+			output += "\\b";
+			break;
+		case '\f':
+			output += "\\f";
+			break;
+		case '\n':
+			output += "\\n";
+			break;
+		case '\r':
+			output += "\\r";
+			break;
+		case '\t':
+			output += "\\t";
+			break;
+		default:
+			if (static_cast<unsigned char>(chr) < 0x20) {
+				const auto code = static_cast<unsigned char>(chr);
+				output += "\\u00";
+				output += HEX_DIGITS[code >> 4U];
+				output += HEX_DIGITS[code & 0x0FU];
+			} else {
+				output += chr;
+			}
+		}
+	}
+
+	output += '"';
+}
+
+static void appendJsonDouble(std::string& output, double value)
+{
+	if (!std::isfinite(value)) {
+		output += "null";
+		return;
+	}
+
+	// Enough for the shortest representation of any double
+	constexpr size_t bufferSize = 32;
+	std::array<char, bufferSize> buffer;
+
+	const auto result = std::to_chars(buffer.data(), buffer.data() + buffer.size(), value);
+	const std::string_view number(buffer.data(), static_cast<size_t>(result.ptr - buffer.data()));
+
+	output += number;
+
+	// Keep the number distinguishable from integers
+	if (number.find_first_of(".e") == std::string_view::npos) {
+		output += ".0";
+	}
+}
+
+void JsonContentWriter::beginDict()
+{
+	beginValue();
+	m_output += '{';
+	m_levels.push_back({false, true});
+}
+
+void JsonContentWriter::key(std::string_view key)
+{
+	if (m_levels.empty() || m_levels.back().isArray) {
+		throw TelemetryException("JsonContentWriter: dictionary key outside of a dictionary");
+	}
+
+	if (!m_levels.back().isEmpty) {
+		m_output += ',';
+	}
+	m_levels.back().isEmpty = false;
+
+	appendJsonString(m_output, key);
+	m_output += ':';
+}
+
+void JsonContentWriter::endDict()
+{
+	if (m_levels.empty() || m_levels.back().isArray) {
+		throw TelemetryException("JsonContentWriter: unexpected end of a dictionary");
+	}
+
+	m_output += '}';
+	m_levels.pop_back();
+}
+
+void JsonContentWriter::beginArray()
+{
+	beginValue();
+	m_output += '[';
+	m_levels.push_back({true, true});
+}
+
+void JsonContentWriter::endArray()
+{
+	if (m_levels.empty() || !m_levels.back().isArray) {
+		throw TelemetryException("JsonContentWriter: unexpected end of an array");
+	}
+
+	m_output += ']';
+	m_levels.pop_back();
+}
+
+void JsonContentWriter::unit(std::string_view unit)
+{
+	m_unit.assign(unit);
+	m_hasUnit = true;
+}
+
+void JsonContentWriter::value(std::monostate)
+{
+	rawValue("null");
+}
+
+void JsonContentWriter::value(bool value)
+{
+	rawValue(value ? "true" : "false");
+}
+
+void JsonContentWriter::value(uint64_t value)
+{
+	beginValue();
+	appendNumber(m_output, value);
+	endValue();
+}
+
+void JsonContentWriter::value(int64_t value)
+{
+	beginValue();
+	appendNumber(m_output, value);
+	endValue();
+}
+
+void JsonContentWriter::value(double value)
+{
+	beginValue();
+	appendJsonDouble(m_output, value);
+	endValue();
+}
+
+void JsonContentWriter::value(std::string_view value)
+{
+	beginValue();
+	appendJsonString(m_output, value);
+	endValue();
+}
+
+void JsonContentWriter::table(const Table& table)
+{
+	beginDict();
+
+	for (const auto& column : table.columns()) {
+		key(column.name);
+
+		if (!column.unit.empty()) {
+			m_output += "{\"value\":";
+		}
+
+		beginArray();
+		std::visit(
+			[this](const auto& values) {
+				for (const auto elem : values) {
+					this->value(elem);
+				}
+			},
+			column.data);
+		endArray();
+
+		if (!column.unit.empty()) {
+			m_output += ",\"unit\":";
+			appendJsonString(m_output, column.unit);
+			m_output += '}';
+		}
+	}
+
+	endDict();
+}
+
+void JsonContentWriter::histogram(const Histogram& histogram)
+{
+	beginDict();
+	key("count");
+	value(histogram.count());
+	key("sum");
+	value(histogram.sum());
+	key("min");
+	value(histogram.min());
+	key("max");
+	value(histogram.max());
+
+	if (!histogram.unit().empty()) {
+		key("unit");
+		value(std::string_view(histogram.unit()));
+	}
+
+	key("buckets");
+	beginArray();
+	for (const auto& bucket : histogram.buckets()) {
+		beginArray();
+		value(Histogram::bucketLowerBound(bucket.index, histogram.precision()));
+		value(Histogram::bucketUpperBound(bucket.index, histogram.precision()));
+		value(bucket.count);
+		endArray();
+	}
+	endArray();
+
+	endDict();
+}
+
+void JsonContentWriter::quantileSketch(const QuantileSketch& sketch)
+{
+	beginDict();
+	key("count");
+	value(sketch.count());
+	key("sum");
+	value(sketch.sum());
+	key("min");
+	value(sketch.min());
+	key("max");
+	value(sketch.max());
+
+	if (!sketch.unit().empty()) {
+		key("unit");
+		value(std::string_view(sketch.unit()));
+	}
+
+	key("relativeAccuracy");
+	value(sketch.relativeAccuracy());
+	key("zeroCount");
+	value(sketch.zeroCount());
+
+	key("buckets");
+	beginArray();
+	for (size_t idx = 0; idx < sketch.counts().size(); idx++) {
+		if (sketch.counts()[idx] == 0) {
+			continue;
+		}
+
+		const auto index = static_cast<int32_t>(sketch.offset() + static_cast<int64_t>(idx));
+		beginArray();
+		value(sketch.bucketLowerBound(index));
+		value(sketch.bucketUpperBound(index));
+		value(sketch.counts()[idx]);
+		endArray();
+	}
+	endArray();
+
+	endDict();
+}
+
+void JsonContentWriter::topK(const TopK& topK)
+{
+	beginDict();
+	key("count");
+	value(topK.count());
+	key("capacity");
+	value(uint64_t {topK.capacity()});
+
+	key("items");
+	beginArray();
+	for (const auto& item : topK.items()) {
+		beginArray();
+		value(std::string_view(item.key));
+		value(item.count);
+		value(item.error);
+		endArray();
+	}
+	endArray();
+
+	endDict();
+}
+
+void JsonContentWriter::rawValue(std::string_view json)
+{
+	beginValue();
+	m_output += json;
+	endValue();
+}
+
+void JsonContentWriter::clear() noexcept
+{
+	m_output.clear();
+	m_levels.clear();
+	m_hasUnit = false;
+}
+
+void JsonContentWriter::beginValue()
+{
+	if (!m_levels.empty() && m_levels.back().isArray) {
+		if (!m_levels.back().isEmpty) {
+			m_output += ',';
+		}
+		m_levels.back().isEmpty = false;
+	}
+
+	if (m_hasUnit) {
+		m_output += "{\"value\":";
+	}
+}
+
+void JsonContentWriter::endValue()
+{
+	if (m_hasUnit) {
+		m_output += ",\"unit\":";
+		appendJsonString(m_output, m_unit);
+		m_output += '}';
+		m_hasUnit = false;
+	}
+}
+
+std::string contentToJson(const Content& content)
+{
+	JsonContentWriter writer;
+	writeContent(writer, content);
+	return writer.str();
+}
+
+class JsonDirectoryVisitor {
+public:
+	explicit JsonDirectoryVisitor(JsonContentWriter& writer)
+		: m_writer(writer)
+	{
+	}
+
+	void enterDirectory(std::string_view name)
+	{
+		m_writer.key(name);
+		m_writer.beginDict();
+	}
+
+	void leaveDirectory() { m_writer.endDict(); }
+
+	void visitFile(std::string_view name, File& file)
+	{
+		// Each file is rendered separately, so a failed read cannot corrupt the output
+		m_fileWriter.clear();
+		m_writer.key(name);
+
+		try {
+			file.readTo(m_fileWriter);
+			m_writer.rawValue(m_fileWriter.str());
+		} catch (const std::exception&) {
+			m_writer.value(std::monostate());
+		}
+	}
+
+private:
+	JsonContentWriter& m_writer;
+	JsonContentWriter m_fileWriter;
+};
+
+void writeDirectoryJson(JsonContentWriter& writer, const std::shared_ptr<Directory>& dir)
+{
+	JsonDirectoryVisitor visitor(writer);
+
+	writer.beginDict();
+	walkDirectory(dir, visitor);
+	writer.endDict();
+}
+
+std::string directoryToJson(const std::shared_ptr<Directory>& dir)
+{
+	JsonContentWriter writer;
+	writeDirectoryJson(writer, dir);
+	return writer.str();
+}
+
+} // namespace telemetry
+
+#ifdef TELEMETRY_ENABLE_TESTS
+#include "tests/testJsonExporter.cpp"
+#endif
@@ -0,0 +1,475 @@
+/**
+ * @file
+ * @author Pavel Siska <siska@cesnet.cz>
+ * @brief Export of telemetry directories in the OpenMetrics text format
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "../contentFormat.hpp"
+#include "exporterCommon.hpp"
+
+#include <telemetry/openMetricsExporter.hpp>
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <exception>
+#include <type_traits>
+
+namespace telemetry {
+
+static bool isNameChar(char chr)
+{
+	return (chr >= 'a' && chr <= 'z') || (chr >= 'A' && chr <= 'Z') || (chr >= '0' && chr <= '9')
+		|| chr == '_';
+}
+
+static bool isDigit(char chr)
+{
+	return chr >= '0' && chr <= '9';
+}
+
+/**
+ * @brief Append a segment of a metric (or label) name starting at @p nameOffset of the output.
+ *
+ * Segments are joined by underscores and invalid characters are replaced by underscores.
+ */
+static void appendNameSegment(std::string& output, size_t nameOffset, std::string_view segment)
+{
+	if (segment.empty()) {
+		return;
+	}
+
+	if (output.size() > nameOffset) {
+		output += '_';
+	} else if (isDigit(segment.front())) {
+		// Names must not start with a digit
+		output += '_';
+	}
+
+	for (const char chr : segment) {
+		output += isNameChar(chr) ? chr : '_';
+	}
+}
+
+static void appendLabelValue(std::string& output, std::string_view value)
+{
+	for (const char chr : value) {
+		switch (chr) {
+		case '\\':
+			output += "\\\\";
+			break;
+		case '"':
+			output += "\\\"";
+			break;
+		case '\n':
+			output += "\\n";
+			break;
+		default:
+			output += chr;
+		}
+	}
+}
+
+static void appendLabel(std::string& output, std::string_view name, std::string_view value)
+{
+	if (!output.empty()) {
+		output += ',';
+	}
+
+	output += name;
+	output += "=\"";
+	appendLabelValue(output, value);
+	output += '"';
+}
+
+static void appendMetricValue(std::string& output, double value)
+{
+	if (std::isnan(value)) {
+		output += "NaN";
+		return;
+	}
+
+	if (std::isinf(value)) {
+		output += value > 0 ? "+Inf" : "-Inf";
+		return;
+	}
+
+	// Enough for the shortest representation of any double
+	constexpr size_t bufferSize = 32;
+	std::array<char, bufferSize> buffer;
+
+	const auto result = std::to_chars(buffer.data(), buffer.data() + buffer.size(), value);
+	output.append(buffer.data(), result.ptr);
+}
+
+/**
+ * @brief Adapter of the exporter to the directory walker.
+ */
+class OpenMetricsVisitor {
+public:
+	explicit OpenMetricsVisitor(OpenMetricsExporter& exporter)
+		: m_exporter(exporter)
+	{
+	}
+
+	void enterDirectory(std::string_view name) { m_exporter.enterEntry(name); }
+
+	void leaveDirectory() { m_exporter.leaveEntry(); }
+
+	void visitFile(std::string_view name, File& file)
+	{
+		m_exporter.enterEntry(name);
+		m_exporter.visitFile(file);
+		m_exporter.leaveEntry();
+	}
+
+private:
+	OpenMetricsExporter& m_exporter;
+};
+
+OpenMetricsExporter::OpenMetricsExporter(std::string_view prefix)
+{
+	appendNameSegment(m_prefix, 0, prefix);
+}
+
+void OpenMetricsExporter::setLabelDirectory(
+	std::string_view directoryName,
+	std::string_view labelName)
+{
+	std::string sanitizedName;
+	appendNameSegment(sanitizedName, 0, labelName);
+	if (sanitizedName.empty()) {
+		throw TelemetryException("OpenMetricsExporter: empty label name");
+	}
+
+	for (auto& [dirName, label] : m_labelDirectories) {
+		if (dirName == directoryName) {
+			label = std::move(sanitizedName);
+			return;
+		}
+	}
+
+	m_labelDirectories.emplace_back(directoryName, std::move(sanitizedName));
+}
+
+const std::string& OpenMetricsExporter::exportDirectory(const std::shared_ptr<Directory>& dir)
+{
+	m_name = m_prefix;
+	m_labels.clear();
+	m_levels.clear();
+	m_levels.push_back({m_name.size(), 0, {}});
+	m_scratch.clear();
+	m_samples.clear();
+
+	OpenMetricsVisitor visitor(*this);
+	walkDirectory(dir, visitor);
+
+	render();
+	return m_output;
+}
+
+void OpenMetricsExporter::enterEntry(std::string_view name)
+{
+	const std::string_view parentLabel = m_levels.back().entryLabel;
+	Level level {m_name.size(), m_labels.size(), {}};
+
+	for (const auto& [dirName, label] : m_labelDirectories) {
+		if (dirName == name) {
+			level.entryLabel = label;
+			break;
+		}
+	}
+
+	if (parentLabel.empty()) {
+		appendNameSegment(m_name, 0, name);
+	} else {
+		appendLabel(m_labels, parentLabel, name);
+	}
+
+	m_levels.push_back(level);
+}
+
+void OpenMetricsExporter::leaveEntry()
+{
+	const Level& level = m_levels.back();
+	m_name.resize(level.nameLength);
+	m_labels.resize(level.labelsLength);
+	m_levels.pop_back();
+}
+
+void OpenMetricsExporter::visitFile(File& file)
+{
+	const size_t sampleCount = m_samples.size();
+	const size_t scratchSize = m_scratch.size();
+
+	m_key.clear();
+	m_unit.clear();
+	m_inArray = false;
+
+	try {
+		file.readTo(*this);
+	} catch (const std::exception&) {
+		// Drop samples of a partially read file
+		m_samples.resize(sampleCount);
+		m_scratch.resize(scratchSize);
+	}
+}
+
+void OpenMetricsExporter::beginDict() {}
+
+void OpenMetricsExporter::key(std::string_view key)
+{
+	m_key.assign(key);
+}
+
+void OpenMetricsExporter::endDict()
+{
+	m_key.clear();
+}
+
+void OpenMetricsExporter::beginArray()
+{
+	m_inArray = true;
+	m_arrayIndex = 0;
+}
+
+void OpenMetricsExporter::endArray()
+{
+	m_inArray = false;
+}
+
+void OpenMetricsExporter::unit(std::string_view unit)
+{
+	m_unit.assign(unit);
+}
+
+void OpenMetricsExporter::value(std::monostate)
+{
+	m_unit.clear();
+	m_arrayIndex++;
+}
+
+void OpenMetricsExporter::value(bool value)
+{
+	addSample(value);
+}
+
+void OpenMetricsExporter::value(uint64_t value)
+{
+	addSample(value);
+}
+
+void OpenMetricsExporter::value(int64_t value)
+{
+	addSample(value);
+}
+
+void OpenMetricsExporter::value(double value)
+{
+	addSample(value);
+}
+
+void OpenMetricsExporter::value(std::string_view)
+{
+	m_unit.clear();
+	m_arrayIndex++;
+}
+
+void OpenMetricsExporter::histogram(const Histogram& histogram)
+{
+	// Enough for any 64-bit integer
+	constexpr size_t bufferSize = 24;
+	std::array<char, bufferSize> buffer;
+
+	auto addHistogramSample = [&](uint64_t value, std::string_view suffix, std::string_view bound) {
+		m_unit.assign(histogram.unit());
+		addSample(value, MetricType::HISTOGRAM, suffix, bound.empty() ? "" : "le", bound);
+	};
+
+	uint64_t cumulative = 0;
+	for (const auto& bucket : histogram.buckets()) {
+		const uint64_t upperBound
+			= Histogram::bucketUpperBound(bucket.index, histogram.precision());
+		const auto result
+			= std::to_chars(buffer.data(), buffer.data() + buffer.size(), upperBound);
+
+		cumulative += bucket.count;
+		addHistogramSample(cumulative, "_bucket", std::string_view(buffer.data(), result.ptr));
+	}
+
+	addHistogramSample(histogram.count(), "_bucket", "+Inf");
+	addHistogramSample(histogram.count(), "_count", {});
+	addHistogramSample(histogram.sum(), "_sum", {});
+}
+
+void OpenMetricsExporter::quantileSketch(const QuantileSketch& sketch)
+{
+	static constexpr std::array<std::pair<std::string_view, double>, 4> QUANTILES {{
+		{"0.5", 0.5},
+		{"0.9", 0.9},
+		{"0.99", 0.99},
+		{"0.999", 0.999},
+	}};
+
+	auto addSummarySample = [&](auto value, std::string_view suffix, std::string_view quantile) {
+		m_unit.assign(sketch.unit());
+		addSample(value, MetricType::SUMMARY, suffix, quantile.empty() ? "" : "quantile", quantile);
+	};
+
+	if (sketch.count() > 0) {
+		for (const auto& [label, quantile] : QUANTILES) {
+			addSummarySample(sketch.valueAtQuantile(quantile), {}, label);
+		}
+	}
+
+	addSummarySample(sketch.count(), "_count", {});
+	addSummarySample(sketch.sum(), "_sum", {});
+}
+
+void OpenMetricsExporter::topK(const TopK& topK)
+{
+	for (const auto& item : topK.items()) {
+		addSample(item.count, MetricType::GAUGE, {}, "key", item.key);
+	}
+}
+
+template <typename T>
+void OpenMetricsExporter::addSample(
+	T value,
+	MetricType type,
+	std::string_view suffix,
+	std::string_view labelName,
+	std::string_view labelValue)
+{
+	Sample sample {};
+	sample.type = type;
+	sample.offset = m_scratch.size();
+
+	m_scratch += m_name;
+	appendNameSegment(m_scratch, sample.offset, m_key);
+	// Each character of the unit is kept or replaced by exactly one character
+	appendNameSegment(m_scratch, sample.offset, m_unit);
+	sample.familyLength = m_scratch.size() - sample.offset;
+	sample.unitLength = m_unit.size();
+	m_scratch += suffix;
+	sample.suffixLength = suffix.size();
+
+	const size_t labelsOffset = m_scratch.size();
+	m_scratch += m_labels;
+	if (m_inArray) {
+		if (!m_labels.empty()) {
+			m_scratch += ',';
+		}
+		m_scratch += "index=\"";
+		appendNumber(m_scratch, m_arrayIndex);
+		m_scratch += '"';
+	}
+	if (!labelName.empty()) {
+		if (m_scratch.size() > labelsOffset) {
+			m_scratch += ',';
+		}
+		m_scratch += labelName;
+		m_scratch += "=\"";
+		appendLabelValue(m_scratch, labelValue);
+		m_scratch += '"';
+	}
+	sample.labelsLength = m_scratch.size() - labelsOffset;
+
+	const size_t valueOffset = m_scratch.size();
+	if constexpr (std::is_same_v<T, bool>) {
+		m_scratch += value ? '1' : '0';
+	} else if constexpr (std::is_same_v<T, double>) {
+		appendMetricValue(m_scratch, value);
+	} else {
+		appendNumber(m_scratch, value);
+	}
+	sample.valueLength = m_scratch.size() - valueOffset;
+
+	m_unit.clear();
+	m_arrayIndex++;
+
+	if (sample.familyLength == 0) {
+		m_scratch.resize(sample.offset);
+		return;
+	}
+
+	m_samples.push_back(sample);
+}
+
+std::string_view OpenMetricsExporter::family(const Sample& sample) const
+{
+	return std::string_view(m_scratch).substr(sample.offset, sample.familyLength);
+}
+
+void OpenMetricsExporter::render()
+{
+	// Samples of a metric family must be together, the original order is kept within families
+	std::sort(m_samples.begin(), m_samples.end(), [this](const Sample& lhs, const Sample& rhs) {
+		const int cmp = family(lhs).compare(family(rhs));
+		return cmp < 0 || (cmp == 0 && lhs.offset < rhs.offset);
+	});
+
+	m_output.clear();
+
+	std::string_view lastFamily;
+	for (const auto& sample : m_samples) {
+		const std::string_view familyName = family(sample);
+		const size_t suffixOffset = sample.offset + sample.familyLength;
+		const std::string_view suffix
+			= std::string_view(m_scratch).substr(suffixOffset, sample.suffixLength);
+		const size_t labelsOffset = suffixOffset + sample.suffixLength;
+		const std::string_view labels
+			= std::string_view(m_scratch).substr(labelsOffset, sample.labelsLength);
+		const size_t valueOffset = labelsOffset + sample.labelsLength;
+		const std::string_view value
+			= std::string_view(m_scratch).substr(valueOffset, sample.valueLength);
+
+		if (familyName != lastFamily) {
+			m_output += "# TYPE ";
+			m_output += familyName;
+			switch (sample.type) {
+			case MetricType::GAUGE:
+				m_output += " gauge\n";
+				break;
+			case MetricType::HISTOGRAM:
+				m_output += " histogram\n";
+				break;
+			case MetricType::SUMMARY:
+				m_output += " summary\n";
+				break;
+			}
+
+			if (sample.unitLength > 0) {
+				m_output += "# UNIT ";
+				m_output += familyName;
+				m_output += ' ';
+				m_output += familyName.substr(familyName.size() - sample.unitLength);
+				m_output += '\n';
+			}
+
+			lastFamily = familyName;
+		}
+
+		m_output += familyName;
+		m_output += suffix;
+		if (!labels.empty()) {
+			m_output += '{';
+			m_output += labels;
+			m_output += '}';
+		}
+		m_output += ' ';
+		m_output += value;
+		m_output += '\n';
+	}
+
+	m_output += "# EOF\n";
+}
+
+} // namespace telemetry
+
+#ifdef TELEMETRY_ENABLE_TESTS
+#include "tests/testOpenMetricsExporter.cpp"
+#endif
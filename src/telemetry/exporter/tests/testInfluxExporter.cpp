@@ -0,0 +1,133 @@
+/**
+ * @file
+ * @author Pavel Siska <siska@cesnet.cz>
+ * @brief Unit tests of the InfluxDB line protocol exporter
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <limits>
+#include <stdexcept>
+
+#include <gtest/gtest.h>
+
+namespace telemetry {
+
+static FileOps makeInfluxReadOps(Content content)
+{
+	FileOps ops;
+	ops.read = [content = std::move(content)]() { return content; };
+	return ops;
+}
+
+static const std::chrono::system_clock::time_point INFLUX_TIMESTAMP {std::chrono::seconds(10)};
+
+/**
+ * @test Test export of fields of different types.
+ */
+TEST(TelemetryInfluxExporter, fields)
+{
+	auto root = Directory::create();
+	auto stats = root->addDir("stats");
+
+	auto packets = stats->addFile("packets", makeInfluxReadOps(Scalar {uint64_t {10}}));
+	auto delay = stats->addFile("delay", makeInfluxReadOps(ScalarWithUnit {Scalar {1.0}, "ms"}));
+	auto flags = stats->addFile("flags", makeInfluxReadOps(Array {Scalar {true}, Scalar {}}));
+	auto na = stats->addFile("na", makeInfluxReadOps(Scalar {}));
+	auto info = root->addFile(
+		"info",
+		makeInfluxReadOps(Dict {
+			{"name", Scalar {std::string("say \"hi\"\\")}},
+			{"offset", Scalar {int64_t {-3}}},
+			{"rate", Scalar {std::numeric_limits<double>::quiet_NaN()}},
+			{"the key", Array {Scalar {0.5}, Scalar {false}}},
+		}));
+
+	InfluxExporter exporter("my app");
+	EXPECT_EQ(
+		"my\\ app/info name=\"say \\\"hi\\\"\\\\\",offset=-3i,the\\ key_0=0.5,the\\ key_1=false "
+		"10000000000\n"
+		"my\\ app/stats/delay value=1 10000000000\n"
+		"my\\ app/stats/flags value_0=true 10000000000\n"
+		"my\\ app/stats/packets value=10u 10000000000\n",
+		exporter.exportDirectory(root, INFLUX_TIMESTAMP));
+}
+
+/**
+ * @test Test that names of entries of tag directories are exported as tags.
+ */
+TEST(TelemetryInfluxExporter, tags)
+{
+	auto root = Directory::create();
+	std::vector<std::shared_ptr<Node>> nodes;
+
+	for (const std::string queue : {"0", "1"}) {
+		auto dir = root->addDirs("queues/" + queue);
+		nodes.push_back(dir);
+		const Dict stats {{"rx", Scalar {uint64_t {1}}}, {"tx", Scalar {uint64_t {2}}}};
+		nodes.push_back(dir->addFile("stats", makeInfluxReadOps(stats)));
+	}
+
+	InfluxExporter exporter;
+	EXPECT_THROW(exporter.setTagDirectory("queues", ""), TelemetryException);
+	exporter.setTagDirectory("queues", "queue id");
+
+	EXPECT_EQ(
+		"queues/stats,queue\\ id=0 rx=1u,tx=2u 10000000000\n"
+		"queues/stats,queue\\ id=1 rx=1u,tx=2u 10000000000\n",
+		exporter.exportDirectory(root, INFLUX_TIMESTAMP));
+}
+
+/**
+ * @test Test that the output is written in chunks of the supplied buffer.
+ */
+TEST(TelemetryInfluxExporter, chunks)
+{
+	auto root = Directory::create();
+	std::vector<std::shared_ptr<File>> files;
+	for (const std::string name : {"a", "b", "c"}) {
+		files.push_back(root->addFile(name, makeInfluxReadOps(Scalar {uint64_t {1}})));
+	}
+
+	FileOps failingOps;
+	failingOps.streamRead = [](ContentWriter& writer) {
+		writer.value(uint64_t {1});
+		throw std::runtime_error("read failed");
+	};
+	files.push_back(root->addFile("failing", failingOps));
+
+	InfluxExporter exporter;
+	std::vector<std::string> chunks;
+	const InfluxExporter::Sink sink = [&chunks](std::string_view chunk) {
+		chunks.emplace_back(chunk);
+	};
+
+	// Each line ("a value=1u 10000000000\n") has 23 characters, two lines fit into the buffer
+	std::array<char, 50> buffer {};
+	exporter.exportDirectory(root, buffer, sink, INFLUX_TIMESTAMP);
+	const std::vector<std::string> expected {
+		"a value=1u 10000000000\nb value=1u 10000000000\n",
+		"c value=1u 10000000000\n",
+	};
+	EXPECT_EQ(expected, chunks);
+
+	// Lines longer than the buffer are split
+	chunks.clear();
+	std::array<char, 20> smallBuffer {};
+	exporter.exportDirectory(root, smallBuffer, sink, INFLUX_TIMESTAMP);
+	ASSERT_EQ(6, chunks.size());
+	EXPECT_EQ("a value=1u 100000000", chunks[0]);
+	EXPECT_EQ("00\n", chunks[1]);
+
+	std::string joined;
+	for (const auto& chunk : chunks) {
+		joined += chunk;
+	}
+	EXPECT_EQ(expected[0] + expected[1], joined);
+
+	EXPECT_THROW(
+		exporter.exportDirectory(root, std::span<char>(), sink, INFLUX_TIMESTAMP),
+		TelemetryException);
+}
+
+} // namespace telemetry
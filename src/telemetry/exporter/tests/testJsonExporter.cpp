@@ -0,0 +1,191 @@
+/**
+ * @file
+ * @author Pavel Siska <siska@cesnet.cz>
+ * @brief Unit tests of the JSON exporter
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <limits>
+#include <stdexcept>
+
+#include <gtest/gtest.h>
+
+namespace telemetry {
+
+/**
+ * @test Test that types of scalars are preserved.
+ */
+TEST(TelemetryJsonExporter, scalar)
+{
+	EXPECT_EQ("null", contentToJson(Scalar {}));
+	EXPECT_EQ("true", contentToJson(Scalar {true}));
+	EXPECT_EQ("false", contentToJson(Scalar {false}));
+	EXPECT_EQ("18446744073709551615", contentToJson(Scalar {std::numeric_limits<uint64_t>::max()}));
+	EXPECT_EQ("-9223372036854775808", contentToJson(Scalar {std::numeric_limits<int64_t>::min()}));
+	EXPECT_EQ("1.25", contentToJson(Scalar {1.25}));
+	EXPECT_EQ("3.0", contentToJson(Scalar {3.0}));
+	EXPECT_EQ("1e+300", contentToJson(Scalar {1e300}));
+	EXPECT_EQ("null", contentToJson(Scalar {std::numeric_limits<double>::quiet_NaN()}));
+	EXPECT_EQ("null", contentToJson(Scalar {std::numeric_limits<double>::infinity()}));
+	EXPECT_EQ(R"("hello")", contentToJson(Scalar {std::string("hello")}));
+}
+
+/**
+ * @test Test escaping of strings.
+ */
+TEST(TelemetryJsonExporter, escape)
+{
+	const std::string str {"quote\" backslash\\ newline\n tab\t bell\x07 utf8 \xC5\xA1"};
+	EXPECT_EQ(
+		"\"quote\\\" backslash\\\\ newline\\n tab\\t bell\\u0007 utf8 \xC5\xA1\"",
+		contentToJson(Scalar {str}));
+}
+
+/**
+ * @test Test that units are written as sibling fields of values.
+ */
+TEST(TelemetryJsonExporter, unit)
+{
+	EXPECT_EQ(
+		R"({"value":42,"unit":"pkts"})",
+		contentToJson(ScalarWithUnit {Scalar {uint64_t {42}}, "pkts"}));
+
+	const Dict dict {
+		{"time", ScalarWithUnit {Scalar {1.5}, "ms"}},
+		{"count", Scalar {int64_t {-1}}},
+	};
+	EXPECT_EQ(R"({"count":-1,"time":{"value":1.5,"unit":"ms"}})", contentToJson(dict));
+}
+
+/**
+ * @test Test arrays, dictionaries, tables, histograms, quantile sketches and top-K summaries.
+ */
+TEST(TelemetryJsonExporter, containers)
+{
+	EXPECT_EQ("[]", contentToJson(Array {}));
+	EXPECT_EQ(
+		R"([1,-2,3.0,null,"x"])",
+		contentToJson(Array {
+			Scalar {uint64_t {1}},
+			Scalar {int64_t {-2}},
+			Scalar {3.0},
+			Scalar {},
+			Scalar {std::string("x")}}));
+
+	EXPECT_EQ("{}", contentToJson(Dict {}));
+
+	const Dict dict {
+		{"array", Array {Scalar {true}, Scalar {false}}},
+		{"empty", Array {}},
+		{"na", std::monostate()},
+	};
+	EXPECT_EQ(R"({"array":[true,false],"empty":[],"na":null})", contentToJson(dict));
+
+	Table table(2);
+	table.addColumn("packets", TableColumn::Values<uint64_t> {10, 20});
+	table.addColumn("delay", TableColumn::Values<double> {0.5, 1.0}, "ms");
+	EXPECT_EQ(
+		R"({"packets":[10,20],"delay":{"value":[0.5,1.0],"unit":"ms"}})",
+		contentToJson(table));
+
+	Histogram histogram("us");
+	histogram.record(5);
+	histogram.record(100, 2);
+	EXPECT_EQ(
+		R"({"count":3,"sum":205,"min":5,"max":100,"unit":"us","buckets":[[5,5,1],[100,103,2]]})",
+		contentToJson(histogram));
+	EXPECT_EQ(
+		R"({"count":0,"sum":0,"min":0,"max":0,"buckets":[]})",
+		contentToJson(Histogram()));
+
+	QuantileSketch sketch("us", 0.5);
+	sketch.record(0);
+	sketch.record(2, 2);
+	EXPECT_EQ(
+		R"({"count":3,"sum":4.0,"min":0.0,"max":2.0,"unit":"us","relativeAccuracy":0.5,)"
+		R"("zeroCount":1,"buckets":[[1.0,3.0,2]]})",
+		contentToJson(sketch));
+
+	TopK topK(2);
+	topK.record("a", 3);
+	topK.record("b");
+	topK.record("c");
+	EXPECT_EQ(
+		R"({"count":5,"capacity":2,"items":[["a",3,0],["c",2,1]]})",
+		contentToJson(topK));
+}
+
+/**
+ * @test Test that misuse of the writer is reported.
+ */
+TEST(TelemetryJsonExporter, writerMisuse)
+{
+	JsonContentWriter writer;
+	EXPECT_THROW(writer.key("key"), TelemetryException);
+	EXPECT_THROW(writer.endDict(), TelemetryException);
+	EXPECT_THROW(writer.endArray(), TelemetryException);
+
+	writer.beginArray();
+	EXPECT_THROW(writer.key("key"), TelemetryException);
+	EXPECT_THROW(writer.endDict(), TelemetryException);
+
+	writer.clear();
+	writer.beginDict();
+	writer.key("nested");
+	writer.beginDict();
+	writer.key("value");
+	writer.value(uint64_t {1});
+	writer.endDict();
+	writer.endDict();
+	EXPECT_EQ(R"({"nested":{"value":1}})", writer.str());
+}
+
+/**
+ * @test Test export of a directory tree.
+ */
+TEST(TelemetryJsonExporter, directory)
+{
+	auto root = Directory::create();
+	auto stats = root->addDir("stats");
+	auto empty = root->addDirs("empty/nested");
+
+	FileOps counterOps;
+	counterOps.read = []() { return ScalarWithUnit {Scalar {uint64_t {10}}, "pkts"}; };
+	auto counter = stats->addFile("counter", counterOps);
+
+	FileOps dictOps;
+	dictOps.streamRead = [](ContentWriter& writer) {
+		writer.beginDict();
+		writer.key("a");
+		writer.value(int64_t {-5});
+		writer.key("b");
+		writer.value("text");
+		writer.endDict();
+	};
+	auto dict = stats->addFile("dict", dictOps);
+
+	FileOps failingOps;
+	failingOps.streamRead = [](ContentWriter& writer) {
+		writer.beginArray();
+		writer.value(uint64_t {1});
+		throw std::runtime_error("read failed");
+	};
+	auto failing = stats->addFile("failing", failingOps);
+
+	FileOps writeOnlyOps;
+	writeOnlyOps.clear = []() {};
+	auto writeOnly = root->addFile("writeOnly", writeOnlyOps);
+
+	auto link = root->addSymlink("link", stats);
+
+	EXPECT_EQ(
+		R"({"empty":{"nested":{}},)"
+		R"("stats":{"counter":{"value":10,"unit":"pkts"},"dict":{"a":-5,"b":"text"},)"
+		R"("failing":null}})",
+		directoryToJson(root));
+
+	EXPECT_EQ(R"({"nested":{}})", directoryToJson(root->addDirs("empty")));
+}
+
+} // namespace telemetry
@@ -0,0 +1,201 @@
+/**
+ * @file
+ * @author Pavel Siska <siska@cesnet.cz>
+ * @brief Unit tests of the OpenMetrics exporter
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <limits>
+#include <stdexcept>
+
+#include <gtest/gtest.h>
+
+namespace telemetry {
+
+static FileOps makeReadOps(Content content)
+{
+	FileOps ops;
+	ops.read = [content = std::move(content)]() { return content; };
+	return ops;
+}
+
+/**
+ * @test Test export of scalars, units, dictionaries and arrays.
+ */
+TEST(TelemetryOpenMetricsExporter, values)
+{
+	auto root = Directory::create();
+	auto stats = root->addDir("stats");
+
+	auto counter = stats->addFile("packets", makeReadOps(Scalar {uint64_t {10}}));
+	auto delay = stats->addFile("delay", makeReadOps(ScalarWithUnit {Scalar {1.5}, "ms"}));
+	auto flags = stats->addFile("flags", makeReadOps(Array {Scalar {true}, Scalar {false}}));
+	auto name = stats->addFile("name", makeReadOps(Scalar {std::string("eth0")}));
+	auto dict = root->addFile(
+		"queue",
+		makeReadOps(Dict {
+			{"drops", Scalar {int64_t {-1}}},
+			{"load", ScalarWithUnit {Scalar {std::numeric_limits<double>::infinity()}, "%"}},
+			{"state", Scalar {std::string("up")}},
+			{"na", std::monostate()},
+		}));
+
+	OpenMetricsExporter exporter("app");
+	EXPECT_EQ(
+		"# TYPE app_queue_drops gauge\n"
+		"app_queue_drops -1\n"
+		"# TYPE app_queue_load__ gauge\n"
+		"# UNIT app_queue_load__ _\n"
+		"app_queue_load__ +Inf\n"
+		"# TYPE app_stats_delay_ms gauge\n"
+		"# UNIT app_stats_delay_ms ms\n"
+		"app_stats_delay_ms 1.5\n"
+		"# TYPE app_stats_flags gauge\n"
+		"app_stats_flags{index=\"0\"} 1\n"
+		"app_stats_flags{index=\"1\"} 0\n"
+		"# TYPE app_stats_packets gauge\n"
+		"app_stats_packets 10\n"
+		"# EOF\n",
+		exporter.exportDirectory(root));
+}
+
+/**
+ * @test Test that names of entries of label directories are exported as labels.
+ */
+TEST(TelemetryOpenMetricsExporter, labels)
+{
+	auto root = Directory::create();
+	std::vector<std::shared_ptr<Node>> nodes;
+
+	for (const std::string queue : {"0", "1"}) {
+		auto dir = root->addDirs("queues/" + queue + "/stats");
+		nodes.push_back(dir);
+		nodes.push_back(dir->addFile("rx", makeReadOps(Scalar {uint64_t {1}})));
+		nodes.push_back(dir->addFile("tx", makeReadOps(Scalar {uint64_t {2}})));
+	}
+	nodes.push_back(root->addFile("up-time", makeReadOps(Scalar {uint64_t {3}})));
+
+	OpenMetricsExporter exporter;
+	exporter.setLabelDirectory("queues", "queue");
+	EXPECT_THROW(exporter.setLabelDirectory("queues", ""), TelemetryException);
+	EXPECT_NO_THROW(exporter.setLabelDirectory("queues", "queue"));
+
+	const std::string expected
+		= "# TYPE queues_stats_rx gauge\n"
+		  "queues_stats_rx{queue=\"0\"} 1\n"
+		  "queues_stats_rx{queue=\"1\"} 1\n"
+		  "# TYPE queues_stats_tx gauge\n"
+		  "queues_stats_tx{queue=\"0\"} 2\n"
+		  "queues_stats_tx{queue=\"1\"} 2\n"
+		  "# TYPE up_time gauge\n"
+		  "up_time 3\n"
+		  "# EOF\n";
+	EXPECT_EQ(expected, exporter.exportDirectory(root));
+
+	// Repeated exports produce the same output
+	EXPECT_EQ(expected, exporter.exportDirectory(root));
+	EXPECT_EQ(expected, exporter.str());
+}
+
+/**
+ * @test Test export of histograms.
+ */
+TEST(TelemetryOpenMetricsExporter, histogram)
+{
+	Histogram histogram("us");
+	histogram.record(5);
+	histogram.record(100, 2);
+
+	auto root = Directory::create();
+	auto latency = root->addFile("latency", makeReadOps(histogram));
+	auto empty = root->addFile("empty", makeReadOps(Histogram()));
+
+	OpenMetricsExporter exporter("app");
+	EXPECT_EQ(
+		"# TYPE app_empty histogram\n"
+		"app_empty_bucket{le=\"+Inf\"} 0\n"
+		"app_empty_count 0\n"
+		"app_empty_sum 0\n"
+		"# TYPE app_latency_us histogram\n"
+		"# UNIT app_latency_us us\n"
+		"app_latency_us_bucket{le=\"5\"} 1\n"
+		"app_latency_us_bucket{le=\"103\"} 3\n"
+		"app_latency_us_bucket{le=\"+Inf\"} 3\n"
+		"app_latency_us_count 3\n"
+		"app_latency_us_sum 205\n"
+		"# EOF\n",
+		exporter.exportDirectory(root));
+}
+
+/**
+ * @test Test export of quantile sketches.
+ */
+TEST(TelemetryOpenMetricsExporter, quantileSketch)
+{
+	QuantileSketch sketch("us");
+	sketch.record(2, 3);
+
+	auto root = Directory::create();
+	auto latency = root->addFile("latency", makeReadOps(sketch));
+	auto empty = root->addFile("empty", makeReadOps(QuantileSketch()));
+
+	OpenMetricsExporter exporter("app");
+	EXPECT_EQ(
+		"# TYPE app_empty summary\n"
+		"app_empty_count 0\n"
+		"app_empty_sum 0\n"
+		"# TYPE app_latency_us summary\n"
+		"# UNIT app_latency_us us\n"
+		"app_latency_us{quantile=\"0.5\"} 2\n"
+		"app_latency_us{quantile=\"0.9\"} 2\n"
+		"app_latency_us{quantile=\"0.99\"} 2\n"
+		"app_latency_us{quantile=\"0.999\"} 2\n"
+		"app_latency_us_count 3\n"
+		"app_latency_us_sum 6\n"
+		"# EOF\n",
+		exporter.exportDirectory(root));
+}
+
+/**
+ * @test Test export of top-K summaries.
+ */
+TEST(TelemetryOpenMetricsExporter, topK)
+{
+	TopK topK;
+	topK.record("10.0.0.1", 500);
+	topK.record("quote\"", 30);
+
+	auto root = Directory::create();
+	auto talkers = root->addFile("talkers", makeReadOps(topK));
+
+	OpenMetricsExporter exporter("app");
+	EXPECT_EQ(
+		"# TYPE app_talkers gauge\n"
+		"app_talkers{key=\"10.0.0.1\"} 500\n"
+		"app_talkers{key=\"quote\\\"\"} 30\n"
+		"# EOF\n",
+		exporter.exportDirectory(root));
+}
+
+/**
+ * @test Test that files whose read fails are skipped.
+ */
+TEST(TelemetryOpenMetricsExporter, readFailure)
+{
+	auto root = Directory::create();
+
+	FileOps failingOps;
+	failingOps.streamRead = [](ContentWriter& writer) {
+		writer.beginArray();
+		writer.value(uint64_t {1});
+		throw std::runtime_error("read failed");
+	};
+	auto failing = root->addFile("failing", failingOps);
+	auto ok = root->addFile("1ok", makeReadOps(Scalar {uint64_t {1}}));
+
+	OpenMetricsExporter exporter;
+	EXPECT_EQ("# TYPE _1ok gauge\n_1ok 1\n# EOF\n", exporter.exportDirectory(root));
+}
+
+} // namespace telemetry
@@ -6,17 +6,214 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#include <telemetry/contentHash.hpp>
 #include <telemetry/file.hpp>
 
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <future>
+#include <memory_resource>
 #include <mutex>
 #include <stdexcept>
 #include <string>
 
 namespace telemetry {
 
+/**
+ * @brief Registration of a call of file I/O operations.
+ *
+ * Operations obtained by the guard stay valid until the guard is destroyed, as disable()
+ * waits until all guards are released before the operations are destroyed. Both counter
+ * and pointer accesses are sequentially consistent, so either disable() sees the registered
+ * call, or the call sees the operations already disabled.
+ */
+class File::CallGuard {
+public:
+	explicit CallGuard(File& file)
+		: m_file(file)
+	{
+		m_file.m_activeCalls.fetch_add(1);
+		m_ops = m_file.m_activeOps.load();
+	}
+
+	~CallGuard()
+	{
+		if (m_file.m_activeCalls.fetch_sub(1) == 1) {
+			m_file.m_activeCalls.notify_all();
+		}
+	}
+
+	CallGuard(const CallGuard& other) = delete;
+	CallGuard& operator=(const CallGuard& other) = delete;
+	CallGuard(CallGuard&& other) = delete;
+	CallGuard& operator=(CallGuard&& other) = delete;
+
+	const FileOps* getOps() const noexcept { return m_ops; }
+
+private:
+	File& m_file;
+	const FileOps* m_ops;
+};
+
+/**
+ * @brief Writer that passes the content to another writer and computes its hash.
+ */
+class HashingContentWriter : public ContentHasher {
+public:
+	using ContentWriter::value;
+
+	explicit HashingContentWriter(ContentWriter& writer)
+		: m_writer(writer)
+	{
+	}
+
+	void beginDict() override
+	{
+		m_writer.beginDict();
+		ContentHasher::beginDict();
+	}
+
+	void key(std::string_view key) override
+	{
+		m_writer.key(key);
+		ContentHasher::key(key);
+	}
+
+	void endDict() override
+	{
+		m_writer.endDict();
+		ContentHasher::endDict();
+	}
+
+	void beginArray() override
+	{
+		m_writer.beginArray();
+		ContentHasher::beginArray();
+	}
+
+	void endArray() override
+	{
+		m_writer.endArray();
+		ContentHasher::endArray();
+	}
+
+	void unit(std::string_view unit) override
+	{
+		m_writer.unit(unit);
+		ContentHasher::unit(unit);
+	}
+
+	void value(std::monostate) override
+	{
+		m_writer.value(std::monostate());
+		ContentHasher::value(std::monostate());
+	}
+
+	void value(bool value) override
+	{
+		m_writer.value(value);
+		ContentHasher::value(value);
+	}
+
+	void value(uint64_t value) override
+	{
+		m_writer.value(value);
+		ContentHasher::value(value);
+	}
+
+	void value(int64_t value) override
+	{
+		m_writer.value(value);
+		ContentHasher::value(value);
+	}
+
+	void value(double value) override
+	{
+		m_writer.value(value);
+		ContentHasher::value(value);
+	}
+
+	void value(std::string_view value) override
+	{
+		m_writer.value(value);
+		ContentHasher::value(value);
+	}
+
+	void table(const Table& table) override
+	{
+		m_writer.table(table);
+		ContentHasher::table(table);
+	}
+
+	void histogram(const Histogram& histogram) override
+	{
+		m_writer.histogram(histogram);
+		ContentHasher::histogram(histogram);
+	}
+
+	void quantileSketch(const QuantileSketch& sketch) override
+	{
+		m_writer.quantileSketch(sketch);
+		ContentHasher::quantileSketch(sketch);
+	}
+
+	void hyperLogLog(const HyperLogLog& hyperLogLog) override
+	{
+		m_writer.hyperLogLog(hyperLogLog);
+		ContentHasher::hyperLogLog(hyperLogLog);
+	}
+
+	void topK(const TopK& topK) override
+	{
+		m_writer.topK(topK);
+		ContentHasher::topK(topK);
+	}
+
+private:
+	ContentWriter& m_writer;
+};
+
+Scalar FileVariable::load() const
+{
+	switch (m_type) {
+	case Type::UINT64:
+		return loadAs<uint64_t>();
+	case Type::INT64:
+		return loadAs<int64_t>();
+	case Type::DOUBLE:
+		return loadAs<double>();
+	case Type::NONE:
+		break;
+	}
+
+	return {};
+}
+
+void FileVariable::writeTo(ContentWriter& writer) const
+{
+	switch (m_type) {
+	case Type::UINT64:
+		writer.value(loadAs<uint64_t>());
+		return;
+	case Type::INT64:
+		writer.value(loadAs<int64_t>());
+		return;
+	case Type::DOUBLE:
+		writer.value(loadAs<double>());
+		return;
+	case Type::NONE:
+		break;
+	}
+
+	writer.value(std::monostate());
+}
+
 File::File(const std::shared_ptr<Node>& parent, std::string_view name, FileOps ops)
 	: Node(parent, name)
 	, m_ops(std::move(ops))
+	, m_activeOps(&m_ops)
 {
 	/*
 	 * Note: The file CANNOT be added to the parent as an entry here, since
@@ -27,44 +224,235 @@ File::File(const std::shared_ptr<Node>& parent, std::string_view name, FileOps o
 
 bool File::hasRead()
 {
-	const std::lock_guard lock(getMutex());
-	return bool {m_ops.read};
+	const CallGuard guard(*this);
+	const FileOps* ops = guard.getOps();
+	return ops != nullptr
+		&& (bool {ops->read} || bool {ops->streamRead} || bool {ops->variable});
 }
 
 bool File::hasClear()
 {
-	const std::lock_guard lock(getMutex());
-	return bool {m_ops.clear};
+	const CallGuard guard(*this);
+	const FileOps* ops = guard.getOps();
+	return ops != nullptr && bool {ops->clear};
 }
 
 Content File::read()
 {
-	const std::lock_guard lock(getMutex());
+	const CallGuard guard(*this);
+	const FileOps* ops = guard.getOps();
 
-	if (!m_ops.read) {
+	if (ops == nullptr || (!ops->read && !ops->streamRead && !ops->variable)) {
 		const std::string err = "File::read('" + getFullPath() + "') operation not supported";
 		throw TelemetryException(err);
 	}
 
-	return m_ops.read();
+	// Only read operations that opted in can allocate from the arena of the caller
+	const ContentResourceScope resourceScope(ops->readArena ? getContentResource() : nullptr);
+
+	const bool useCache = ops->cacheDuration > std::chrono::milliseconds::zero();
+	if (useCache) {
+		if (auto cachedContent = getCachedContent(*ops)) {
+			return std::move(*cachedContent);
+		}
+	}
+
+	const auto readTime = std::chrono::steady_clock::now();
+	Content content = ops->coalesceReads ? readCoalesced(*ops) : readContent(*ops);
+
+	if (useCache) {
+		setCachedContent(content, readTime);
+	}
+	if (ops->trackContentHash) {
+		setContentHash(hashContent(content));
+	}
+
+	return content;
 }
 
-void File::clear()
+void File::readTo(ContentWriter& writer)
+{
+	const CallGuard guard(*this);
+	const FileOps* ops = guard.getOps();
+
+	if (ops == nullptr || (!ops->read && !ops->streamRead && !ops->variable)) {
+		const std::string err = "File::readTo('" + getFullPath() + "') operation not supported";
+		throw TelemetryException(err);
+	}
+
+	const bool useCache = ops->cacheDuration > std::chrono::milliseconds::zero();
+	if ((ops->streamRead || ops->variable) && !useCache && !ops->coalesceReads) {
+		if (!ops->trackContentHash) {
+			streamContent(*ops, writer);
+			return;
+		}
+
+		HashingContentWriter hashingWriter(writer);
+		streamContent(*ops, hashingWriter);
+		setContentHash(hashingWriter.digest());
+		return;
+	}
+
+	if (!ops->readArena) {
+		writeContent(writer, read());
+		return;
+	}
+
+	// Content is only written to the writer, so all its memory can be released at once
+	constexpr size_t arenaInitialSize = 4096;
+	std::array<std::byte, arenaInitialSize> arenaBuffer;
+	std::pmr::monotonic_buffer_resource arena(arenaBuffer.data(), arenaBuffer.size());
+
+	const ContentResourceScope resourceScope(&arena);
+	writeContent(writer, read());
+}
+
+void File::streamContent(const FileOps& ops, ContentWriter& writer)
+{
+	if (ops.variable) {
+		ops.variable.writeTo(writer);
+	} else {
+		ops.streamRead(writer);
+	}
+}
+
+Content File::readContent(const FileOps& ops)
+{
+	if (ops.variable) {
+		return ops.variable.load();
+	}
+
+	if (ops.read) {
+		return ops.read();
+	}
+
+	ContentBuilder builder;
+	ops.streamRead(builder);
+	return builder.takeContent();
+}
+
+std::optional<Content> File::getCachedContent(const FileOps& ops)
+{
+	const std::lock_guard lock(getMutex());
+
+	if (!m_cachedContent.has_value()) {
+		return std::nullopt;
+	}
+
+	if (std::chrono::steady_clock::now() - m_cachedTime >= ops.cacheDuration) {
+		m_cachedContent.reset();
+		return std::nullopt;
+	}
+
+	return m_cachedContent;
+}
+
+void File::setCachedContent(const Content& content, std::chrono::steady_clock::time_point time)
+{
+	const std::lock_guard lock(getMutex());
+
+	// Keep the content of the most recently started read
+	if (m_cachedContent.has_value() && m_cachedTime > time) {
+		return;
+	}
+
+	// The cached copy outlives the read, so it must not use the arena of the reader
+	const ContentResourceScope resourceScope(nullptr);
+	m_cachedContent = content;
+	m_cachedTime = time;
+}
+
+void File::resetCachedContent()
+{
+	const std::lock_guard lock(getMutex());
+	m_cachedContent.reset();
+}
+
+void File::setContentHash(uint64_t hash)
 {
 	const std::lock_guard lock(getMutex());
+	m_contentHash = hash;
+}
+
+std::optional<uint64_t> File::getContentHash()
+{
+	const std::lock_guard lock(getMutex());
+	return m_contentHash;
+}
+
+Content File::readCoalesced(const FileOps& ops)
+{
+	std::promise<Content> promise;
+	std::shared_future<Content> pendingRead;
+
+	{
+		const std::lock_guard lock(getMutex());
+		if (m_pendingRead.valid()) {
+			pendingRead = m_pendingRead;
+		} else {
+			m_pendingRead = promise.get_future().share();
+		}
+	}
 
-	if (!m_ops.clear) {
+	if (pendingRead.valid()) {
+		return pendingRead.get();
+	}
+
+	// Readers that come after the operation is finished must not get its (old) result
+	auto finishPendingRead = [this]() {
+		const std::lock_guard lock(getMutex());
+		m_pendingRead = {};
+	};
+
+	try {
+		Content content = readContent(ops);
+		finishPendingRead();
+		{
+			// Waiting readers get a copy that doesn't depend on the arena of this reader
+			const ContentResourceScope resourceScope(nullptr);
+			promise.set_value(content);
+		}
+		return content;
+	} catch (...) {
+		finishPendingRead();
+		promise.set_exception(std::current_exception());
+		throw;
+	}
+}
+
+void File::clear()
+{
+	const CallGuard guard(*this);
+	const FileOps* ops = guard.getOps();
+
+	if (ops == nullptr || !ops->clear) {
 		const std::string err = "File::clear('" + getFullPath() + "') operation not supported";
 		throw TelemetryException(err);
 	}
 
-	m_ops.clear();
+	ops->clear();
+	resetCachedContent();
 }
 
 void File::disable()
 {
-	const std::lock_guard lock(getMutex());
-	m_ops = {};
+	/*
+	 * The node mutex must not be held while waiting, as running coalesced reads need it to
+	 * finish. Concurrent calls of disable() are resolved by the exchange instead: all of them
+	 * wait for running calls, but only the first one releases the operations.
+	 */
+	const FileOps* ops = m_activeOps.exchange(nullptr);
+
+	// Wait until all calls that might have obtained the operations are finished
+	for (uint32_t calls = m_activeCalls.load(); calls != 0; calls = m_activeCalls.load()) {
+		m_activeCalls.wait(calls);
+	}
+
+	if (ops != nullptr) {
+		m_ops = {};
+	}
+
+	resetCachedContent();
 }
 
 } // namespace telemetry
@@ -0,0 +1,246 @@
+/**
+ * @file
+ * @author Pavel Siska <siska@cesnet.cz>
+ * @brief Mergeable histogram of telemetry values
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <telemetry/histogram.hpp>
+#include <telemetry/node.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <utility>
+
+namespace telemetry {
+
+static void checkPrecision(unsigned precision)
+{
+	if (precision > Histogram::MAX_PRECISION) {
+		throw TelemetryException(
+			"Histogram: precision " + std::to_string(precision) + " is greater than "
+			+ std::to_string(Histogram::MAX_PRECISION));
+	}
+}
+
+Histogram::Histogram(std::string_view unit, unsigned precision)
+	: m_unit(unit)
+	, m_precision(precision)
+{
+	checkPrecision(precision);
+}
+
+Histogram Histogram::fromParts(
+	std::string_view unit,
+	unsigned precision,
+	Buckets buckets,
+	uint64_t sum,
+	uint64_t min,
+	uint64_t max)
+{
+	Histogram histogram(unit, precision);
+
+	const size_t bucketCount = Histogram::bucketCount(precision);
+	for (size_t idx = 0; idx < buckets.size(); idx++) {
+		const Bucket& bucket = buckets[idx];
+		if (bucket.index >= bucketCount || bucket.count == 0
+			|| (idx > 0 && bucket.index <= buckets[idx - 1].index)) {
+			throw TelemetryException("Histogram: invalid bucket");
+		}
+		histogram.m_count += bucket.count;
+	}
+
+	if (!buckets.empty()) {
+		if (min > max || bucketIndex(min, precision) != buckets.front().index
+			|| bucketIndex(max, precision) != buckets.back().index) {
+			throw TelemetryException("Histogram: minimum or maximum doesn't match buckets");
+		}
+		histogram.m_min = min;
+		histogram.m_max = max;
+	}
+
+	histogram.m_buckets = std::move(buckets);
+	histogram.m_sum = sum;
+	return histogram;
+}
+
+void Histogram::record(uint64_t value, uint64_t count)
+{
+	if (count == 0) {
+		return;
+	}
+
+	const uint32_t index = bucketIndex(value, m_precision);
+	auto iter = std::lower_bound(
+		m_buckets.begin(),
+		m_buckets.end(),
+		index,
+		[](const Bucket& bucket, uint32_t index) { return bucket.index < index; });
+
+	if (iter != m_buckets.end() && iter->index == index) {
+		iter->count += count;
+	} else {
+		m_buckets.insert(iter, Bucket {index, count});
+	}
+
+	m_count += count;
+	m_sum += value * count;
+	m_min = std::min(m_min, value);
+	m_max = std::max(m_max, value);
+}
+
+void Histogram::merge(const Histogram& other)
+{
+	if (other.m_precision != m_precision || other.m_unit != m_unit) {
+		throw TelemetryException("Histogram: histograms of different unit or precision");
+	}
+
+	Buckets merged;
+	merged.reserve(m_buckets.size() + other.m_buckets.size());
+
+	auto iter = m_buckets.begin();
+	auto otherIter = other.m_buckets.begin();
+	while (iter != m_buckets.end() || otherIter != other.m_buckets.end()) {
+		if (otherIter == other.m_buckets.end()
+			|| (iter != m_buckets.end() && iter->index < otherIter->index)) {
+			merged.push_back(*iter++);
+		} else if (iter == m_buckets.end() || otherIter->index < iter->index) {
+			merged.push_back(*otherIter++);
+		} else {
+			merged.push_back(Bucket {iter->index, iter->count + otherIter->count});
+			++iter;
+			++otherIter;
+		}
+	}
+
+	m_buckets = std::move(merged);
+	m_count += other.m_count;
+	m_sum += other.m_sum;
+	m_min = std::min(m_min, other.m_min);
+	m_max = std::max(m_max, other.m_max);
+}
+
+double Histogram::mean() const noexcept
+{
+	if (m_count == 0) {
+		return 0;
+	}
+
+	return static_cast<double>(m_sum) / static_cast<double>(m_count);
+}
+
+uint64_t Histogram::valueAtQuantile(double quantile) const noexcept
+{
+	if (m_count == 0) {
+		return 0;
+	}
+
+	// Rank of the value (from 1), the minimum and the maximum are known exactly
+	const double rank = std::ceil(std::clamp(quantile, 0.0, 1.0) * static_cast<double>(m_count));
+	if (rank <= 1) {
+		return m_min;
+	}
+	if (rank >= static_cast<double>(m_count)) {
+		return m_max;
+	}
+
+	const auto target = static_cast<uint64_t>(rank);
+	uint64_t cumulative = 0;
+
+	for (const auto& bucket : m_buckets) {
+		cumulative += bucket.count;
+		if (cumulative >= target) {
+			const uint64_t value = bucketUpperBound(bucket.index, m_precision);
+			return std::clamp(value, m_min, m_max);
+		}
+	}
+
+	return m_max;
+}
+
+HistogramRecorder::HistogramRecorder(std::string_view unit, unsigned precision)
+	: m_unit(unit)
+	, m_precision(precision)
+	, m_bucketCount(0)
+{
+	checkPrecision(precision);
+
+	m_bucketCount = Histogram::bucketCount(precision);
+	m_buckets = std::make_unique<std::atomic<uint64_t>[]>(m_bucketCount);
+}
+
+void HistogramRecorder::record(uint64_t value, uint64_t count) noexcept
+{
+	if (count == 0) {
+		return;
+	}
+
+	m_buckets[Histogram::bucketIndex(value, m_precision)].fetch_add(
+		count,
+		std::memory_order_relaxed);
+	m_sum.fetch_add(value * count, std::memory_order_relaxed);
+
+	uint64_t current = m_min.load(std::memory_order_relaxed);
+	while (value < current
+		   && !m_min.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+
+	current = m_max.load(std::memory_order_relaxed);
+	while (value > current
+		   && !m_max.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+}
+
+Histogram HistogramRecorder::snapshot() const
+{
+	Histogram::Buckets buckets;
+
+	for (size_t idx = 0; idx < m_bucketCount; idx++) {
+		const uint64_t count = m_buckets[idx].load(std::memory_order_relaxed);
+		if (count != 0) {
+			buckets.push_back({static_cast<uint32_t>(idx), count});
+		}
+	}
+
+	if (buckets.empty()) {
+		return Histogram(m_unit, m_precision);
+	}
+
+	// Exact extremes might not be updated yet by concurrent records, so they are limited
+	// by the first and the last bucket to keep the snapshot consistent
+	const uint32_t first = buckets.front().index;
+	const uint32_t last = buckets.back().index;
+	const uint64_t min = std::clamp(
+		m_min.load(std::memory_order_relaxed),
+		Histogram::bucketLowerBound(first, m_precision),
+		Histogram::bucketUpperBound(first, m_precision));
+	const uint64_t max = std::clamp(
+		m_max.load(std::memory_order_relaxed),
+		std::max(min, Histogram::bucketLowerBound(last, m_precision)),
+		Histogram::bucketUpperBound(last, m_precision));
+
+	return Histogram::fromParts(
+		m_unit,
+		m_precision,
+		std::move(buckets),
+		m_sum.load(std::memory_order_relaxed),
+		min,
+		max);
+}
+
+void HistogramRecorder::reset() noexcept
+{
+	for (size_t idx = 0; idx < m_bucketCount; idx++) {
+		m_buckets[idx].store(0, std::memory_order_relaxed);
+	}
+
+	m_sum.store(0, std::memory_order_relaxed);
+	m_min.store(std::numeric_limits<uint64_t>::max(), std::memory_order_relaxed);
+	m_max.store(0, std::memory_order_relaxed);
+}
+
+} // namespace telemetry
+
+#ifdef TELEMETRY_ENABLE_TESTS
+#include "tests/testHistogram.cpp"
+#endif
@@ -0,0 +1,160 @@
+/**
+ * @file
+ * @author Pavel Siska <siska@cesnet.cz>
+ * @brief Mergeable HyperLogLog estimate of the number of distinct values
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <telemetry/hyperLogLog.hpp>
+#include <telemetry/node.hpp>
+
+#include <cmath>
+#include <cstring>
+#include <string>
+#include <utility>
+
+namespace telemetry {
+
+static void checkPrecision(unsigned precision)
+{
+	if (precision < HyperLogLog::MIN_PRECISION || precision > HyperLogLog::MAX_PRECISION) {
+		throw TelemetryException(
+			"HyperLogLog: precision " + std::to_string(precision) + " is out of the range ["
+			+ std::to_string(HyperLogLog::MIN_PRECISION) + ", "
+			+ std::to_string(HyperLogLog::MAX_PRECISION) + "]");
+	}
+}
+
+HyperLogLog::HyperLogLog(unsigned precision)
+	: m_precision(precision)
+{
+	checkPrecision(precision);
+	m_registers.resize(size_t {1} << precision);
+}
+
+HyperLogLog HyperLogLog::fromRegisters(unsigned precision, Registers registers)
+{
+	HyperLogLog hyperLogLog(precision);
+
+	const unsigned maxValue = std::numeric_limits<uint64_t>::digits - precision + 1;
+	if (registers.size() != hyperLogLog.m_registers.size()
+		|| std::any_of(registers.begin(), registers.end(), [&](uint8_t reg) {
+			   return reg > maxValue;
+		   })) {
+		throw TelemetryException("HyperLogLog: invalid registers");
+	}
+
+	hyperLogLog.m_registers = std::move(registers);
+	return hyperLogLog;
+}
+
+void HyperLogLog::merge(const HyperLogLog& other)
+{
+	if (other.m_precision != m_precision) {
+		throw TelemetryException("HyperLogLog: HyperLogLogs of different precision");
+	}
+
+	for (size_t idx = 0; idx < m_registers.size(); idx++) {
+		m_registers[idx] = std::max(m_registers[idx], other.m_registers[idx]);
+	}
+}
+
+uint64_t HyperLogLog::estimate() const noexcept
+{
+	const auto registerCount = static_cast<double>(m_registers.size());
+
+	double sum = 0;
+	size_t zeros = 0;
+	for (const uint8_t reg : m_registers) {
+		sum += std::ldexp(1.0, -reg);
+		zeros += reg == 0 ? 1 : 0;
+	}
+
+	// Constants of the bias correction given by the original HyperLogLog paper
+	double alpha;
+	switch (m_precision) {
+	case 4:
+		alpha = 0.673;
+		break;
+	case 5:
+		alpha = 0.697;
+		break;
+	case 6:
+		alpha = 0.709;
+		break;
+	default:
+		alpha = 0.7213 / (1 + 1.079 / registerCount);
+	}
+
+	double estimate = alpha * registerCount * registerCount / sum;
+	if (estimate <= 2.5 * registerCount && zeros > 0) {
+		estimate = registerCount * std::log(registerCount / static_cast<double>(zeros));
+	}
+
+	return static_cast<uint64_t>(std::llround(estimate));
+}
+
+uint64_t HyperLogLog::hash(std::string_view value) noexcept
+{
+	constexpr uint64_t multiplier = 0x9E3779B97F4A7C15ULL;
+
+	uint64_t result = value.size() * multiplier;
+	while (value.size() >= sizeof(uint64_t)) {
+		uint64_t word;
+		std::memcpy(&word, value.data(), sizeof(word));
+		result = hash(result ^ word) * multiplier;
+		value.remove_prefix(sizeof(uint64_t));
+	}
+
+	uint64_t tail = 0;
+	for (size_t idx = 0; idx < value.size(); idx++) {
+		tail |= static_cast<uint64_t>(static_cast<uint8_t>(value[idx])) << (idx * 8);
+	}
+
+	return hash(result ^ tail);
+}
+
+HyperLogLogRecorder::HyperLogLogRecorder(unsigned precision)
+	: m_precision(precision)
+	, m_registerCount(0)
+{
+	checkPrecision(precision);
+
+	m_registerCount = size_t {1} << precision;
+	m_registers = std::make_unique<std::atomic<uint8_t>[]>(m_registerCount);
+}
+
+void HyperLogLogRecorder::addHash(uint64_t hash) noexcept
+{
+	auto& reg = m_registers[HyperLogLog::registerIndex(hash, m_precision)];
+	const uint8_t value = HyperLogLog::registerValue(hash, m_precision);
+
+	// Registers only grow, so most values of a busy recorder don't write at all
+	uint8_t current = reg.load(std::memory_order_relaxed);
+	while (value > current
+		   && !reg.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+}
+
+HyperLogLog HyperLogLogRecorder::snapshot() const
+{
+	HyperLogLog::Registers registers(m_registerCount);
+	for (size_t idx = 0; idx < m_registerCount; idx++) {
+		registers[idx] = m_registers[idx].load(std::memory_order_relaxed);
+	}
+
+	return HyperLogLog::fromRegisters(m_precision, std::move(registers));
+}
+
+void HyperLogLogRecorder::reset() noexcept
+{
+	for (size_t idx = 0; idx < m_registerCount; idx++) {
+		m_registers[idx].store(0, std::memory_order_relaxed);
+	}
+}
+
+} // namespace telemetry
+
+#ifdef TELEMETRY_ENABLE_TESTS
+#include "tests/testHyperLogLog.cpp"
+#endif
@@ -0,0 +1,220 @@
+/**
+ * @file
+ * @author Pavel Siska <siska@cesnet.cz>
+ * @brief Mergeable quantile sketch of telemetry values
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <telemetry/node.hpp>
+#include <telemetry/quantileSketch.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <utility>
+
+namespace telemetry {
+
+QuantileSketch::QuantileSketch(std::string_view unit, double relativeAccuracy, uint32_t maxBuckets)
+	: m_unit(unit)
+	, m_relativeAccuracy(relativeAccuracy)
+	, m_maxBuckets(maxBuckets)
+	, m_gamma((1 + relativeAccuracy) / (1 - relativeAccuracy))
+	, m_logGamma(std::log(m_gamma))
+{
+	if (!(relativeAccuracy >= MIN_RELATIVE_ACCURACY && relativeAccuracy < 1)) {
+		throw TelemetryException(
+			"QuantileSketch: invalid relative accuracy " + std::to_string(relativeAccuracy));
+	}
+
+	if (maxBuckets == 0) {
+		throw TelemetryException("QuantileSketch: maximal number of buckets must be positive");
+	}
+}
+
+QuantileSketch QuantileSketch::fromParts(
+	std::string_view unit,
+	double relativeAccuracy,
+	uint32_t maxBuckets,
+	int32_t offset,
+	Counts counts,
+	uint64_t zeroCount,
+	double sum,
+	double min,
+	double max)
+{
+	QuantileSketch sketch(unit, relativeAccuracy, maxBuckets);
+
+	if (counts.size() > maxBuckets
+		|| static_cast<int64_t>(offset) + static_cast<int64_t>(counts.size()) - 1
+			> std::numeric_limits<int32_t>::max()
+		|| (!counts.empty() && (counts.front() == 0 || counts.back() == 0))) {
+		throw TelemetryException("QuantileSketch: invalid buckets");
+	}
+
+	sketch.m_count = zeroCount;
+	for (const uint64_t count : counts) {
+		sketch.m_count += count;
+	}
+
+	if (sketch.m_count > 0) {
+		if (!std::isfinite(sum) || sum < 0 || !std::isfinite(max) || !(min >= 0) || min > max
+			|| (zeroCount > 0) != (min == 0) || counts.empty() != (max == 0)) {
+			throw TelemetryException(
+				"QuantileSketch: sum, minimum or maximum doesn't match buckets");
+		}
+		sketch.m_sum = sum;
+		sketch.m_min = min;
+		sketch.m_max = max;
+	}
+
+	sketch.m_offset = counts.empty() ? 0 : offset;
+	sketch.m_counts = std::move(counts);
+	sketch.m_zeroCount = zeroCount;
+	return sketch;
+}
+
+void QuantileSketch::record(double value, uint64_t count)
+{
+	if (!(value >= 0) || !std::isfinite(value)) {
+		throw TelemetryException("QuantileSketch: invalid value " + std::to_string(value));
+	}
+
+	if (count == 0) {
+		return;
+	}
+
+	if (value == 0) {
+		m_zeroCount += count;
+	} else {
+		const int32_t index = bucketIndex(value);
+		if (m_counts.empty()) {
+			m_offset = index;
+			m_counts.push_back(count);
+		} else if (index >= m_offset && index - m_offset < static_cast<int64_t>(m_counts.size())) {
+			m_counts[static_cast<size_t>(index - m_offset)] += count;
+		} else {
+			const int64_t last = std::max<int64_t>(m_offset + std::ssize(m_counts) - 1, index);
+			reshape(std::min<int64_t>(m_offset, index), last);
+			m_counts[static_cast<size_t>(std::max<int64_t>(index, m_offset) - m_offset)] += count;
+		}
+	}
+
+	m_count += count;
+	m_sum += value * static_cast<double>(count);
+	m_min = std::min(m_min, value);
+	m_max = std::max(m_max, value);
+}
+
+void QuantileSketch::merge(const QuantileSketch& other)
+{
+	if (other.m_relativeAccuracy != m_relativeAccuracy || other.m_unit != m_unit) {
+		throw TelemetryException("QuantileSketch: sketches of different unit or accuracy");
+	}
+
+	if (!other.m_counts.empty()) {
+		const int64_t otherLast = other.m_offset + std::ssize(other.m_counts) - 1;
+		if (m_counts.empty()) {
+			reshape(other.m_offset, otherLast);
+		} else {
+			reshape(
+				std::min(m_offset, other.m_offset),
+				std::max(m_offset + std::ssize(m_counts) - 1, otherLast));
+		}
+
+		for (size_t idx = 0; idx < other.m_counts.size(); idx++) {
+			const int64_t index
+				= std::max<int64_t>(other.m_offset + static_cast<int64_t>(idx), m_offset);
+			m_counts[static_cast<size_t>(index - m_offset)] += other.m_counts[idx];
+		}
+	}
+
+	m_zeroCount += other.m_zeroCount;
+	m_count += other.m_count;
+	m_sum += other.m_sum;
+	m_min = std::min(m_min, other.m_min);
+	m_max = std::max(m_max, other.m_max);
+}
+
+void QuantileSketch::reshape(int64_t first, int64_t last)
+{
+	// Lowest buckets are collapsed into one if there would be too many buckets
+	first = std::max(first, last - m_maxBuckets + 1);
+
+	Counts counts(static_cast<size_t>(last - first + 1), 0);
+	for (size_t idx = 0; idx < m_counts.size(); idx++) {
+		const int64_t index = std::max<int64_t>(m_offset + static_cast<int64_t>(idx), first);
+		counts[static_cast<size_t>(index - first)] += m_counts[idx];
+	}
+
+	m_offset = static_cast<int32_t>(first);
+	m_counts = std::move(counts);
+}
+
+double QuantileSketch::mean() const noexcept
+{
+	if (m_count == 0) {
+		return 0;
+	}
+
+	return m_sum / static_cast<double>(m_count);
+}
+
+double QuantileSketch::valueAtQuantile(double quantile) const noexcept
+{
+	if (m_count == 0) {
+		return 0;
+	}
+
+	// Rank of the value (from 0), the minimum and the maximum are known exactly
+	const double rank = std::clamp(quantile, 0.0, 1.0) * static_cast<double>(m_count - 1);
+	if (rank <= 0) {
+		return m_min;
+	}
+	if (rank >= static_cast<double>(m_count - 1)) {
+		return m_max;
+	}
+
+	uint64_t cumulative = m_zeroCount;
+	if (static_cast<double>(cumulative) > rank) {
+		return 0;
+	}
+
+	for (size_t idx = 0; idx < m_counts.size(); idx++) {
+		cumulative += m_counts[idx];
+		if (static_cast<double>(cumulative) > rank) {
+			const double value = bucketValue(m_offset + static_cast<int32_t>(idx));
+			return std::clamp(value, m_min, m_max);
+		}
+	}
+
+	return m_max;
+}
+
+int32_t QuantileSketch::bucketIndex(double value) const noexcept
+{
+	return static_cast<int32_t>(std::ceil(std::log(value) / m_logGamma));
+}
+
+double QuantileSketch::bucketLowerBound(int32_t index) const noexcept
+{
+	return std::pow(m_gamma, index - 1);
+}
+
+double QuantileSketch::bucketUpperBound(int32_t index) const noexcept
+{
+	return std::pow(m_gamma, index);
+}
+
+double QuantileSketch::bucketValue(int32_t index) const noexcept
+{
+	// The value whose relative distance from both bounds is the relative accuracy
+	return 2 * bucketUpperBound(index) / (m_gamma + 1);
+}
+
+} // namespace telemetry
+
+#ifdef TELEMETRY_ENABLE_TESTS
+#include "tests/testQuantileSketch.cpp"
+#endif
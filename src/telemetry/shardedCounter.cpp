@@ -0,0 +1,54 @@
+/**
+ * @file
+ * @author Pavel Siska <siska@cesnet.cz>
+ * @brief Counter sharded across threads
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <telemetry/shardedCounter.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <thread>
+
+namespace telemetry {
+
+ShardedCounter::ShardedCounter(size_t shardCount)
+{
+	if (shardCount == 0) {
+		shardCount = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+	}
+
+	shardCount = std::bit_ceil(shardCount);
+	m_shardMask = shardCount - 1;
+	m_shards = std::make_unique<Shard[]>(shardCount);
+}
+
+uint64_t ShardedCounter::value() const noexcept
+{
+	const std::lock_guard lock(m_mutex);
+
+	uint64_t sum = 0;
+	for (size_t idx = 0; idx <= m_shardMask; idx++) {
+		sum += m_shards[idx].value.load(std::memory_order_relaxed);
+	}
+	return sum;
+}
+
+uint64_t ShardedCounter::reset() noexcept
+{
+	const std::lock_guard lock(m_mutex);
+
+	uint64_t sum = 0;
+	for (size_t idx = 0; idx <= m_shardMask; idx++) {
+		sum += m_shards[idx].value.exchange(0, std::memory_order_relaxed);
+	}
+	return sum;
+}
+
+} // namespace telemetry
+
+#ifdef TELEMETRY_ENABLE_TESTS
+#include "tests/testShardedCounter.cpp"
+#endif
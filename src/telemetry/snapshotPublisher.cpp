@@ -0,0 +1,72 @@
+/**
+ * @file
+ * @author Pavel Siska <siska@cesnet.cz>
+ * @brief Consistent snapshots of a structure published by a producer thread
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <telemetry/snapshotPublisher.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+namespace telemetry {
+
+static constexpr size_t WORD_SIZE = sizeof(uint64_t);
+
+SnapshotBuffer::SnapshotBuffer(size_t size)
+	: m_size(size)
+	, m_words(std::make_unique<std::atomic<uint64_t>[]>((size + WORD_SIZE - 1) / WORD_SIZE))
+{
+}
+
+void SnapshotBuffer::store(const void* data) noexcept
+{
+	const auto* bytes = static_cast<const std::byte*>(data);
+	const uint64_t sequence = m_sequence.load(std::memory_order_relaxed);
+
+	// The odd sequence number must be visible before any word of the new bytes
+	m_sequence.store(sequence + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	for (size_t offset = 0; offset < m_size; offset += WORD_SIZE) {
+		uint64_t word = 0;
+		std::memcpy(&word, bytes + offset, std::min(WORD_SIZE, m_size - offset));
+		m_words[offset / WORD_SIZE].store(word, std::memory_order_relaxed);
+	}
+
+	m_sequence.store(sequence + 2, std::memory_order_release);
+}
+
+void SnapshotBuffer::load(void* data) const noexcept
+{
+	auto* bytes = static_cast<std::byte*>(data);
+
+	while (true) {
+		const uint64_t sequence = m_sequence.load(std::memory_order_acquire);
+		if (sequence % 2 != 0) {
+			// The writer might have been preempted in the middle of a store
+			std::this_thread::yield();
+			continue;
+		}
+
+		for (size_t offset = 0; offset < m_size; offset += WORD_SIZE) {
+			const uint64_t word = m_words[offset / WORD_SIZE].load(std::memory_order_relaxed);
+			std::memcpy(bytes + offset, &word, std::min(WORD_SIZE, m_size - offset));
+		}
+
+		// Words must be loaded before the sequence number is checked again
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (m_sequence.load(std::memory_order_relaxed) == sequence) {
+			return;
+		}
+	}
+}
+
+} // namespace telemetry
+
+#ifdef TELEMETRY_ENABLE_TESTS
+#include "tests/testSnapshotPublisher.cpp"
+#endif
@@ -0,0 +1,74 @@
+/**
+ * @file
+ * @author Pavel Siska <siska@cesnet.cz>
+ * @brief Interned string
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <telemetry/symbol.hpp>
+
+#include <deque>
+#include <mutex>
+#include <ostream>
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace telemetry {
+
+/**
+ * @brief Process-wide table of interned strings.
+ *
+ * Strings are stored in a deque, so their addresses never change.
+ */
+class SymbolTable {
+public:
+	const std::string* intern(std::string_view str)
+	{
+		{
+			const std::shared_lock lock(m_mutex);
+			auto iter = m_index.find(str);
+			if (iter != m_index.end()) {
+				return iter->second;
+			}
+		}
+
+		const std::unique_lock lock(m_mutex);
+		auto iter = m_index.find(str);
+		if (iter != m_index.end()) {
+			return iter->second;
+		}
+
+		const std::string& stored = m_storage.emplace_back(str);
+		m_index.emplace(stored, &stored);
+		return &stored;
+	}
+
+private:
+	std::shared_mutex m_mutex;
+	std::deque<std::string> m_storage;
+	std::unordered_map<std::string_view, const std::string*> m_index;
+};
+
+static SymbolTable& getSymbolTable()
+{
+	// Intentionally never destroyed, symbols might be used by other static objects
+	static auto* table = new SymbolTable();
+	return *table;
+}
+
+Symbol::Symbol(std::string_view str)
+	: m_str(str.empty() ? &emptyString() : getSymbolTable().intern(str))
+{
+}
+
+std::ostream& operator<<(std::ostream& stream, const Symbol& symbol)
+{
+	return stream << symbol.view();
+}
+
+} // namespace telemetry
+
+#ifdef TELEMETRY_ENABLE_TESTS
+#include "tests/testSymbol.cpp"
+#endif
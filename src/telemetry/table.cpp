@@ -0,0 +1,191 @@
+/**
+ * @file
+ * @author Pavel Siska <siska@cesnet.cz>
+ * @brief Table of telemetry values stored by columns
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "contentFormat.hpp"
+
+#include <telemetry/node.hpp>
+#include <telemetry/table.hpp>
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <utility>
+
+namespace telemetry {
+
+void Table::addColumn(std::string_view name, TableColumn::Data data, std::string_view unit)
+{
+	const size_t size = std::visit([](const auto& values) { return values.size(); }, data);
+	if (size != m_rowCount) {
+		throw TelemetryException(
+			"Table: column '" + std::string(name) + "' has " + std::to_string(size)
+			+ " values, expected " + std::to_string(m_rowCount));
+	}
+
+	insertColumn(name, unit, std::move(data));
+}
+
+const TableColumn* Table::findColumn(std::string_view name) const noexcept
+{
+	auto iter = std::find_if(m_columns.begin(), m_columns.end(), [&](const TableColumn& column) {
+		return column.name == name;
+	});
+
+	return iter != m_columns.end() ? &*iter : nullptr;
+}
+
+TableColumn&
+Table::insertColumn(std::string_view name, std::string_view unit, TableColumn::Data data)
+{
+	if (name.empty()) {
+		throw TelemetryException("Table: empty column name");
+	}
+
+	if (findColumn(name) != nullptr) {
+		throw TelemetryException("Table: duplicate column '" + std::string(name) + "'");
+	}
+
+	return m_columns.emplace_back(TableColumn {Symbol(name), Symbol(unit), std::move(data)});
+}
+
+static void appendColumnHeader(std::string& output, const TableColumn& column)
+{
+	output += column.name;
+
+	if (!column.unit.empty()) {
+		output += " (";
+		output += column.unit;
+		output += ')';
+	}
+}
+
+static void appendCell(std::string& output, const TableColumn& column, size_t row)
+{
+	std::visit([&](const auto& values) { appendNumber(output, values[row]); }, column.data);
+}
+
+void appendTableToString(std::string& output, const Table& table)
+{
+	const auto& columns = table.columns();
+	constexpr size_t columnGap = 2;
+
+	if (columns.empty()) {
+		return;
+	}
+
+	// Columns are aligned by their widest cell, so cells are rendered twice
+	std::string cell;
+	std::vector<size_t> widths;
+	widths.reserve(columns.size());
+
+	for (const auto& column : columns) {
+		cell.clear();
+		appendColumnHeader(cell, column);
+		size_t width = cell.size();
+
+		for (size_t row = 0; row < table.rowCount(); row++) {
+			cell.clear();
+			appendCell(cell, column, row);
+			width = std::max(width, cell.size());
+		}
+
+		widths.push_back(width);
+	}
+
+	for (size_t row = 0; row <= table.rowCount(); row++) {
+		if (row > 0) {
+			output += '\n';
+		}
+
+		for (size_t idx = 0; idx < columns.size(); idx++) {
+			const size_t cellBegin = output.size();
+
+			if (row == 0) {
+				appendColumnHeader(output, columns[idx]);
+			} else {
+				appendCell(output, columns[idx], row - 1);
+			}
+
+			if (idx + 1 < columns.size()) {
+				output.append(widths[idx] - (output.size() - cellBegin) + columnGap, ' ');
+			}
+		}
+	}
+}
+
+static void appendCsvField(std::string& output, std::string_view field)
+{
+	if (field.find_first_of(",\"\r\n") == std::string_view::npos) {
+		output += field;
+		return;
+	}
+
+	output += '"';
+	for (const char chr : field) {
+		if (chr == '"') {
+			output += '"';
+		}
+		output += chr;
+	}
+	output += '"';
+}
+
+static void appendCsvCell(std::string& output, const TableColumn& column, size_t row)
+{
+	// Enough for the shortest representation of any double and any 64-bit integer
+	constexpr size_t bufferSize = 32;
+	std::array<char, bufferSize> buffer;
+
+	const auto result = std::visit(
+		[&](const auto& values) {
+			return std::to_chars(buffer.data(), buffer.data() + buffer.size(), values[row]);
+		},
+		column.data);
+
+	output.append(buffer.data(), result.ptr);
+}
+
+void appendTableToCsv(std::string& output, const Table& table)
+{
+	const auto& columns = table.columns();
+	std::string header;
+
+	for (size_t idx = 0; idx < columns.size(); idx++) {
+		if (idx > 0) {
+			output += ',';
+		}
+
+		header.clear();
+		appendColumnHeader(header, columns[idx]);
+		appendCsvField(output, header);
+	}
+	output += '\n';
+
+	for (size_t row = 0; row < table.rowCount(); row++) {
+		for (size_t idx = 0; idx < columns.size(); idx++) {
+			if (idx > 0) {
+				output += ',';
+			}
+			appendCsvCell(output, columns[idx], row);
+		}
+		output += '\n';
+	}
+}
+
+std::string tableToCsv(const Table& table)
+{
+	std::string result;
+	appendTableToCsv(result, table);
+	return result;
+}
+
+} // namespace telemetry
+
+#ifdef TELEMETRY_ENABLE_TESTS
+#include "tests/testTable.cpp"
+#endif
@@ -8,10 +8,45 @@
 
 #include "strUtils.hpp"
 
+#include <array>
+#include <cstdio>
+#include <limits>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
 #include <gtest/gtest.h>
 
 namespace telemetry {
 
+static std::string scalarToString(const Scalar& scalar)
+{
+	std::string result;
+	appendScalar(result, scalar);
+	return result;
+}
+
+static std::string scalarWithUnitToString(const ScalarWithUnit& scalar)
+{
+	std::string result;
+	appendScalarWithUnit(result, scalar);
+	return result;
+}
+
+static std::string arrayToString(const Array& array)
+{
+	std::string result;
+	appendArray(result, array);
+	return result;
+}
+
+static std::string dictToString(const Dict& dict)
+{
+	std::string result;
+	appendDict(result, dict);
+	return result;
+}
+
 /**
  * @test Test conversion of a scalar to string.
  */
@@ -223,4 +258,88 @@ TEST(TelemetryContent, contentToString)
 	EXPECT_EQ("key: value", contentToString(dictSimple));
 }
 
+/**
+ * @test Test appending of content to an existing string.
+ */
+TEST(TelemetryContent, appendContentToString)
+{
+	std::string output = "prefix ";
+	appendContentToString(output, Array {Scalar {1.005}, Scalar {-0.001}, Scalar {1e20}});
+	EXPECT_EQ("prefix [1.00, -0.00, 100000000000000000000.00]", output);
+
+	output.clear();
+	appendContentToString(output, ScalarWithUnit {Scalar {std::numeric_limits<int64_t>::min()}, "B"});
+	EXPECT_EQ("-9223372036854775808 (B)", output);
+
+	// The longest fixed notation of a double (309 integer digits)
+	const double doubleMax = std::numeric_limits<double>::max();
+	std::array<char, 512> expected {};
+	std::snprintf(expected.data(), expected.size(), "%.2f", doubleMax);
+
+	output.clear();
+	appendContentToString(output, Scalar {doubleMax});
+	EXPECT_EQ(expected.data(), output);
+}
+
+/**
+ * @test Test that the dictionary keeps its elements sorted by keys.
+ */
+TEST(TelemetryContent, dictOrder)
+{
+	Dict dict;
+	dict["c"] = Scalar {uint64_t {3}};
+	dict["a"] = Scalar {uint64_t {1}};
+	dict["b"] = Scalar {uint64_t {2}};
+	dict["a"] = Scalar {uint64_t {4}};
+
+	std::vector<std::string> keys;
+	for (const auto& [key, _] : dict) {
+		keys.push_back(key);
+	}
+
+	EXPECT_EQ((std::vector<std::string> {"a", "b", "c"}), keys);
+	EXPECT_EQ(DictValue {Scalar {uint64_t {4}}}, dict.at("a"));
+	EXPECT_EQ("a: 4\nb: 2\nc: 3", dictToString(dict));
+
+	EXPECT_TRUE(dict.contains(std::string_view("b")));
+	EXPECT_EQ(dict.end(), dict.find("d"));
+	EXPECT_THROW(dict.at("d"), std::out_of_range);
+
+	EXPECT_EQ(1, dict.erase("b"));
+	EXPECT_EQ(0, dict.erase("b"));
+	EXPECT_EQ(2, dict.size());
+}
+
+/**
+ * @test Test that insertion into the dictionary doesn't overwrite existing keys.
+ */
+TEST(TelemetryContent, dictInsert)
+{
+	Dict dict {{"b", Scalar {uint64_t {1}}}, {"a", Scalar {uint64_t {2}}}, {"b", Scalar {}}};
+	EXPECT_EQ(2, dict.size());
+	EXPECT_EQ(DictValue {Scalar {uint64_t {1}}}, dict.at("b"));
+
+	EXPECT_FALSE(dict.insert({"a", Scalar {uint64_t {3}}}).second);
+	EXPECT_TRUE(dict.emplace("c", Scalar {uint64_t {3}}).second);
+
+	const Dict other {
+		{"a", Scalar {uint64_t {10}}},
+		{"d", Scalar {uint64_t {4}}},
+		{"0", Scalar {uint64_t {0}}},
+	};
+	dict.insert(other.begin(), other.end());
+
+	const Dict expected {
+		{"0", Scalar {uint64_t {0}}},
+		{"a", Scalar {uint64_t {2}}},
+		{"b", Scalar {uint64_t {1}}},
+		{"c", Scalar {uint64_t {3}}},
+		{"d", Scalar {uint64_t {4}}},
+	};
+	EXPECT_EQ(expected, dict);
+
+	EXPECT_FALSE(dict.insert_or_assign("a", Scalar {uint64_t {5}}).second);
+	EXPECT_EQ(DictValue {Scalar {uint64_t {5}}}, dict.at("a"));
+}
+
 } // namespace telemetry
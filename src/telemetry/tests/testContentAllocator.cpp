@@ -0,0 +1,112 @@
+/**
+ * @file
+ * @author Pavel Siska <siska@cesnet.cz>
+ * @brief Unit tests of Telemetry::ContentAllocator
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <telemetry/content.hpp>
+
+#include <array>
+#include <cstddef>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+namespace telemetry {
+
+/**
+ * @brief Memory resource that counts allocations.
+ */
+class CountingResource : public std::pmr::memory_resource {
+public:
+	size_t allocations = 0;
+
+private:
+	void* do_allocate(size_t bytes, size_t alignment) override
+	{
+		allocations++;
+		return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+	}
+
+	void do_deallocate(void* ptr, size_t bytes, size_t alignment) override
+	{
+		std::pmr::new_delete_resource()->deallocate(ptr, bytes, alignment);
+	}
+
+	bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+	{
+		return this == &other;
+	}
+};
+
+/**
+ * @test Test that scopes select and restore the resource of the calling thread.
+ */
+TEST(TelemetryContentAllocator, scope)
+{
+	CountingResource outer;
+	CountingResource inner;
+
+	EXPECT_EQ(std::pmr::get_default_resource(), getContentResource());
+	{
+		const ContentResourceScope outerScope(&outer);
+		EXPECT_EQ(&outer, getContentResource());
+		{
+			const ContentResourceScope innerScope(&inner);
+			EXPECT_EQ(&inner, getContentResource());
+
+			std::thread([]() {
+				EXPECT_EQ(std::pmr::get_default_resource(), getContentResource());
+			}).join();
+		}
+		EXPECT_EQ(&outer, getContentResource());
+
+		const ContentResourceScope defaultScope(nullptr);
+		EXPECT_EQ(std::pmr::get_default_resource(), getContentResource());
+	}
+	EXPECT_EQ(std::pmr::get_default_resource(), getContentResource());
+}
+
+/**
+ * @test Test that containers allocate from the resource of the scope they are created in.
+ */
+TEST(TelemetryContentAllocator, containers)
+{
+	CountingResource resource;
+	Content copy;
+
+	{
+		const ContentResourceScope scope(&resource);
+
+		Dict dict;
+		dict["array"] = Array {Scalar {uint64_t {1}}, Scalar {uint64_t {2}}};
+		dict["value"] = Scalar {uint64_t {3}};
+		EXPECT_GT(resource.allocations, 0);
+		EXPECT_EQ(&resource, std::get<Array>(dict["array"]).get_allocator().resource());
+
+		const Content content = dict;
+		{
+			const ContentResourceScope defaultScope(nullptr);
+			copy = content;
+		}
+	}
+
+	// Copy created outside of the scope is independent of the resource
+	const auto& array = std::get<Array>(std::get<Dict>(copy).at("array"));
+	EXPECT_EQ(std::pmr::get_default_resource(), array.get_allocator().resource());
+	EXPECT_EQ(2, array.size());
+
+	// Assignment doesn't propagate the resource to an existing container
+	Array target;
+	{
+		const ContentResourceScope scope(&resource);
+		Array source {Scalar {uint64_t {1}}};
+		target = std::move(source);
+	}
+	EXPECT_EQ(std::pmr::get_default_resource(), target.get_allocator().resource());
+	EXPECT_EQ(1, target.size());
+}
+
+} // namespace telemetry
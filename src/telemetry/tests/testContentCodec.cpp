@@ -0,0 +1,221 @@
+/**
+ * @file
+ * @author Pavel Siska <siska@cesnet.cz>
+ * @brief Unit tests of the binary content codec
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <limits>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace telemetry {
+
+static Table createTable()
+{
+	Table table(3);
+	auto packets = table.addColumn<uint64_t>("packets");
+	packets[1] = 300;
+	packets[2] = std::numeric_limits<uint64_t>::max();
+	table.addColumn("delay", TableColumn::Values<double> {0.5, -1.0, 1e300}, "ms");
+	auto diff = table.addColumn<int64_t>("diff");
+	diff[0] = -1;
+	diff[2] = std::numeric_limits<int64_t>::min();
+	return table;
+}
+
+static Histogram createHistogram()
+{
+	Histogram histogram("us", 6);
+	histogram.record(0);
+	histogram.record(1000, 5);
+	histogram.record(std::numeric_limits<uint64_t>::max());
+	return histogram;
+}
+
+static QuantileSketch createQuantileSketch()
+{
+	QuantileSketch sketch("us", 0.02, 100);
+	sketch.record(0, 3);
+	sketch.record(1e-3);
+	sketch.record(1.5, 5);
+	sketch.record(1e12);
+	return sketch;
+}
+
+static TopK createTopK()
+{
+	TopK topK(3);
+	topK.record("10.0.0.1", 1000);
+	topK.record(std::string(200, 'x'));
+	topK.record("");
+	topK.record("10.0.0.2", 5);
+	return topK;
+}
+
+static HyperLogLog createHyperLogLog()
+{
+	HyperLogLog hyperLogLog(6);
+	for (uint64_t value = 0; value < 20; value++) {
+		hyperLogLog.add(value);
+	}
+	return hyperLogLog;
+}
+
+/**
+ * @test Test that encoded content is decoded to the same content.
+ */
+TEST(TelemetryContentCodec, roundTrip)
+{
+	const std::vector<Content> contents {
+		Scalar {},
+		Scalar {true},
+		Scalar {false},
+		Scalar {uint64_t {0}},
+		Scalar {std::numeric_limits<uint64_t>::max()},
+		Scalar {std::numeric_limits<int64_t>::min()},
+		Scalar {std::numeric_limits<int64_t>::max()},
+		Scalar {int64_t {-1}},
+		Scalar {-123.456},
+		Scalar {std::numeric_limits<double>::infinity()},
+		Scalar {std::string()},
+		Scalar {std::string("hello world!")},
+		ScalarWithUnit {Scalar {uint64_t {42}}, "pkts"},
+		ScalarWithUnit {Scalar {}, ""},
+		Array {},
+		Array {Scalar {uint64_t {1}}, Scalar {int64_t {-2}}, Scalar {3.0}, Scalar {}},
+		Dict {},
+		Dict {
+			{"string", Scalar {std::string(300, 'x')}},
+			{"unit", ScalarWithUnit {Scalar {1.5}, "ms"}},
+			{"array", Array {Scalar {true}, Scalar {std::string("a")}}},
+			{"emptyArray", Array {}},
+		},
+		Table(),
+		Table(10),
+		createTable(),
+		Histogram(),
+		createHistogram(),
+		QuantileSketch(),
+		createQuantileSketch(),
+		HyperLogLog(),
+		createHyperLogLog(),
+		TopK(),
+		createTopK(),
+	};
+
+	for (const auto& content : contents) {
+		const auto data = encodeContent(content);
+		EXPECT_EQ(content, decodeContent(data));
+	}
+}
+
+/**
+ * @test Test that the encoding is compact and starts with the versioned header.
+ */
+TEST(TelemetryContentCodec, format)
+{
+	const std::vector<uint8_t> expected {'T', 'C', CONTENT_CODEC_VERSION, 0x03, 0xAC, 0x02};
+	EXPECT_EQ(expected, encodeContent(Scalar {uint64_t {300}}));
+
+	const std::vector<uint8_t> negative {'T', 'C', CONTENT_CODEC_VERSION, 0x04, 0x01};
+	EXPECT_EQ(negative, encodeContent(Scalar {int64_t {-1}}));
+}
+
+/**
+ * @test Test walking of the encoded content without materializing it.
+ */
+TEST(TelemetryContentCodec, walk)
+{
+	const Content content = Dict {
+		{"packets", Scalar {uint64_t {10}}},
+		{"time", ScalarWithUnit {1.5, "ms"}},
+		{"flags", Array {Scalar {true}, Scalar {std::string("x")}}},
+	};
+	const auto data = encodeContent(content);
+
+	TextContentWriter writer;
+	decodeContent(data, writer);
+	EXPECT_EQ(contentToString(content), writer.str());
+
+	writer.clear();
+	decodeContent(encodeContent(createTable()), writer);
+	EXPECT_EQ(contentToString(createTable()), writer.str());
+
+	writer.clear();
+	decodeContent(encodeContent(createHistogram()), writer);
+	EXPECT_EQ(contentToString(createHistogram()), writer.str());
+
+	writer.clear();
+	decodeContent(encodeContent(createQuantileSketch()), writer);
+	EXPECT_EQ(contentToString(createQuantileSketch()), writer.str());
+
+	// Streamed encoding is the same as encoding of the content object
+	BinaryContentWriter binaryWriter;
+	decodeContent(data, binaryWriter);
+	EXPECT_EQ(data, binaryWriter.data());
+
+	binaryWriter.clear();
+	writeContent(binaryWriter, Scalar {});
+	EXPECT_EQ(encodeContent(Scalar {}), binaryWriter.data());
+}
+
+/**
+ * @test Test that invalid encodings are rejected.
+ */
+TEST(TelemetryContentCodec, invalidData)
+{
+	const std::vector<std::vector<uint8_t>> invalid {
+		{},
+		{'T', 'C'},
+		{'X', 'C', CONTENT_CODEC_VERSION, 0x00},
+		{'T', 'C', 0xFF, 0x00},
+		// Missing content
+		{'T', 'C', CONTENT_CODEC_VERSION},
+		// Unknown tag
+		{'T', 'C', CONTENT_CODEC_VERSION, 0xFF},
+		// Truncated integer and string
+		{'T', 'C', CONTENT_CODEC_VERSION, 0x03, 0x80},
+		{'T', 'C', CONTENT_CODEC_VERSION, 0x06, 0x05, 'a'},
+		// Trailing data
+		{'T', 'C', CONTENT_CODEC_VERSION, 0x00, 0x00},
+		// Nested array
+		{'T', 'C', CONTENT_CODEC_VERSION, 0x08, 0x08, 0x09, 0x09},
+		// Dictionary value without a key and nested dictionary
+		{'T', 'C', CONTENT_CODEC_VERSION, 0x0A, 0x00, 0x0B},
+		{'T', 'C', CONTENT_CODEC_VERSION, 0x0A, 0x0C, 0x01, 'a', 0x0A, 0x0B, 0x0B},
+		// Unit of an array
+		{'T', 'C', CONTENT_CODEC_VERSION, 0x07, 0x01, 'a', 0x08, 0x09},
+		// Unterminated dictionary
+		{'T', 'C', CONTENT_CODEC_VERSION, 0x0A, 0x0C, 0x01, 'a', 0x00},
+		// Variable length integer longer than 64 bits
+		{'T', 'C', CONTENT_CODEC_VERSION, 0x03, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+		 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x01},
+		// Histogram with too high precision and with the minimum outside of the first bucket
+		{'T', 'C', CONTENT_CODEC_VERSION, 0x0E, 0x0B, 0x00, 0x00, 0x00, 0x00},
+		{'T', 'C', CONTENT_CODEC_VERSION, 0x0E, 0x04, 0x05, 0x00, 0x05, 0x01, 0x05, 0x01},
+		// Quantile sketch with zero relative accuracy and with a truncated bucket
+		{'T', 'C', CONTENT_CODEC_VERSION, 0x0F, 0, 0, 0, 0, 0, 0, 0, 0, 0x01, 0x00,
+		 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x00, 0x00},
+		{'T', 'C', CONTENT_CODEC_VERSION, 0x0F, 0x7B, 0x14, 0xAE, 0x47, 0xE1, 0x7A, 0x84, 0x3F,
+		 0x01, 0x00, 0, 0, 0, 0, 0, 0, 0xF0, 0x3F, 0, 0, 0, 0, 0, 0, 0xF0, 0x3F,
+		 0, 0, 0, 0, 0, 0, 0xF0, 0x3F, 0x00, 0x01},
+		// HyperLogLog with too low precision, with a register out of the range and with too
+		// high value of a register
+		{'T', 'C', CONTENT_CODEC_VERSION, 0x10, 0x03, 0x00},
+		{'T', 'C', CONTENT_CODEC_VERSION, 0x10, 0x04, 0x01, 0x10, 0x01},
+		{'T', 'C', CONTENT_CODEC_VERSION, 0x10, 0x04, 0x01, 0x00, 0x3E},
+		// Top-K summary with zero capacity and with more items than the capacity
+		{'T', 'C', CONTENT_CODEC_VERSION, 0x11, 0x00, 0x00, 0x00},
+		{'T', 'C', CONTENT_CODEC_VERSION, 0x11, 0x01, 0x02, 0x02, 0x01, 'a', 0x01, 0x00,
+		 0x01, 'b', 0x01, 0x00},
+	};
+
+	for (const auto& data : invalid) {
+		EXPECT_THROW(decodeContent(data), TelemetryException);
+	}
+}
+
+} // namespace telemetry
@@ -0,0 +1,175 @@
+/**
+ * @file
+ * @author Pavel Siska <siska@cesnet.cz>
+ * @brief Unit tests of the delta encoding of content
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace telemetry {
+
+static Table createTable(uint64_t packets, double delay, std::string_view delayUnit = "ms")
+{
+	Table table(2);
+	table.addColumn("packets", TableColumn::Values<uint64_t> {packets, packets * 2});
+	table.addColumn("delay", TableColumn::Values<double> {delay, -delay}, delayUnit);
+	table.addColumn("diff", TableColumn::Values<int64_t> {-1, int64_t {1} << 40U});
+	return table;
+}
+
+/**
+ * @test Test that the current content is rebuilt from any previous content and the delta.
+ */
+TEST(TelemetryContentDelta, roundTrip)
+{
+	const std::vector<Content> contents {
+		Scalar {},
+		Scalar {true},
+		Scalar {uint64_t {0}},
+		Scalar {std::numeric_limits<uint64_t>::max()},
+		Scalar {std::numeric_limits<int64_t>::min()},
+		Scalar {std::numeric_limits<int64_t>::max()},
+		Scalar {1.5},
+		Scalar {-1e300},
+		Scalar {std::string("text")},
+		ScalarWithUnit {Scalar {uint64_t {42}}, "pkts"},
+		ScalarWithUnit {Scalar {uint64_t {43}}, "pkts"},
+		ScalarWithUnit {Scalar {uint64_t {43}}, "B"},
+		ScalarWithUnit {Scalar {std::string("x")}, "pkts"},
+		Array {},
+		Array {Scalar {uint64_t {1}}, Scalar {int64_t {-2}}, Scalar {3.0}},
+		Array {Scalar {uint64_t {2}}, Scalar {int64_t {-2}}, Scalar {3.5}, Scalar {}},
+		Array {Scalar {std::string("a")}},
+		Dict {},
+		Dict {
+			{"counter", Scalar {uint64_t {100}}},
+			{"delay", ScalarWithUnit {Scalar {1.25}, "ms"}},
+			{"flags", Array {Scalar {true}, Scalar {false}}},
+			{"na", std::monostate()},
+		},
+		Dict {
+			{"counter", Scalar {uint64_t {90}}},
+			{"delay", ScalarWithUnit {Scalar {1.5}, "ms"}},
+			{"flags", Array {Scalar {true}}},
+			{"new", Scalar {int64_t {-1}}},
+		},
+		Dict {
+			{"counter", ScalarWithUnit {Scalar {uint64_t {90}}, "pkts"}},
+			{"delay", Array {}},
+			{"na", Scalar {}},
+		},
+		Table(),
+		createTable(1000, 1.5),
+		createTable(900, 1.75),
+		createTable(900, 1.75, "s"),
+	};
+
+	for (const auto& previous : contents) {
+		for (const auto& current : contents) {
+			const auto delta = encodeContentDelta(previous, current);
+			EXPECT_EQ(current, applyContentDelta(previous, delta));
+
+			const auto encodedPrevious = encodeContent(previous);
+			if (decodeContent(encodedPrevious) == previous) {
+				EXPECT_EQ(delta, encodeContentDelta(encodedPrevious, current));
+			}
+		}
+	}
+}
+
+/**
+ * @test Test that only changes are encoded.
+ */
+TEST(TelemetryContentDelta, compact)
+{
+	Dict previous;
+	for (uint64_t idx = 0; idx < 100; idx++) {
+		previous["counter_" + std::to_string(idx)] = Scalar {1'000'000'000 + idx};
+	}
+
+	Dict current = previous;
+	current["counter_5"] = Scalar {uint64_t {1'000'000'010}};
+	current["counter_50"] = Scalar {uint64_t {1'000'000'049}};
+
+	const auto delta = encodeContentDelta(previous, current);
+	// Header, patch tag, count and two keys with one byte deltas
+	EXPECT_EQ(3 + 1 + 1 + (1 + 9 + 2) + (1 + 10 + 2), delta.size());
+	EXPECT_LT(delta.size() * 20, encodeContent(current).size());
+	EXPECT_EQ(Content {current}, applyContentDelta(previous, delta));
+
+	const std::vector<uint8_t> same {'T', 'D', CONTENT_DELTA_VERSION, 0x20};
+	EXPECT_EQ(same, encodeContentDelta(current, current));
+
+	// Small change of a double doesn't need all 8 bytes
+	const auto doubleDelta = encodeContentDelta(Scalar {1000.0}, Scalar {1000.5});
+	EXPECT_LT(doubleDelta.size(), 3 + 1 + 8);
+	EXPECT_EQ(Content {Scalar {1000.5}}, applyContentDelta(Scalar {1000.0}, doubleDelta));
+
+	// Table with the same columns stores only differences of values
+	Table previousTable(256);
+	Table currentTable(256);
+	for (int column = 0; column < 20; column++) {
+		const std::string name = "counter_" + std::to_string(column);
+		auto previousValues = previousTable.addColumn<uint64_t>(name);
+		auto currentValues = currentTable.addColumn<uint64_t>(name);
+		for (size_t row = 0; row < previousValues.size(); row++) {
+			previousValues[row] = 1'000'000'000 + row;
+			currentValues[row] = previousValues[row] + row % 3;
+		}
+	}
+
+	const auto tableDelta = encodeContentDelta(previousTable, currentTable);
+	EXPECT_EQ(3 + 1 + 20 * 256, tableDelta.size());
+	EXPECT_EQ(Content {currentTable}, applyContentDelta(previousTable, tableDelta));
+}
+
+/**
+ * @test Test that invalid deltas and deltas of a different content are rejected.
+ */
+TEST(TelemetryContentDelta, invalidDelta)
+{
+	const Content previous = Scalar {uint64_t {1}};
+	const std::vector<std::vector<uint8_t>> invalid {
+		{},
+		{'T', 'C', CONTENT_DELTA_VERSION, 0x20},
+		{'T', 'D', 0xFF, 0x20},
+		{'T', 'D', CONTENT_DELTA_VERSION},
+		// Trailing data
+		{'T', 'D', CONTENT_DELTA_VERSION, 0x20, 0x20},
+		// Delta of a different type and patches of a scalar
+		{'T', 'D', CONTENT_DELTA_VERSION, 0x22, 0x02},
+		{'T', 'D', CONTENT_DELTA_VERSION, 0x24, 0x01, 0x01, 0x00, 0x00},
+		{'T', 'D', CONTENT_DELTA_VERSION, 0x25, 0x00},
+		// Unknown value is not a content
+		{'T', 'D', CONTENT_DELTA_VERSION, 0x27},
+	};
+
+	for (const auto& delta : invalid) {
+		EXPECT_THROW(applyContentDelta(previous, delta), TelemetryException);
+	}
+
+	const Content array = Array {Scalar {uint64_t {1}}};
+	const std::vector<std::vector<uint8_t>> invalidArray {
+		// Index out of range
+		{'T', 'D', CONTENT_DELTA_VERSION, 0x24, 0x01, 0x01, 0x01, 0x00},
+		// Too many new elements
+		{'T', 'D', CONTENT_DELTA_VERSION, 0x24, 0xFF, 0xFF, 0xFF, 0xFF, 0x0F, 0x00},
+	};
+	for (const auto& delta : invalidArray) {
+		EXPECT_THROW(applyContentDelta(array, delta), TelemetryException);
+	}
+
+	// Removal of a missing key
+	const std::vector<uint8_t> removal
+		= {'T', 'D', CONTENT_DELTA_VERSION, 0x25, 0x01, 0x01, 'x', 0x26};
+	EXPECT_THROW(applyContentDelta(Dict {}, removal), TelemetryException);
+}
+
+} // namespace telemetry
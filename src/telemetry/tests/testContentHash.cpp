@@ -0,0 +1,94 @@
+/**
+ * @file
+ * @author Pavel Siska <siska@cesnet.cz>
+ * @brief Unit tests of the hashing of content
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace telemetry {
+
+/**
+ * @test Test that equal contents have equal hashes and different contents different ones.
+ */
+TEST(TelemetryContentHash, hashContent)
+{
+	const std::vector<Content> contents {
+		Scalar {},
+		Scalar {false},
+		Scalar {true},
+		Scalar {uint64_t {1}},
+		Scalar {int64_t {1}},
+		Scalar {1.0},
+		Scalar {"1"},
+		ScalarWithUnit {uint64_t {1}, "ms"},
+		ScalarWithUnit {uint64_t {1}, "s"},
+		Array {},
+		Array {Scalar {uint64_t {1}}},
+		Array {Scalar {uint64_t {1}}, Scalar {uint64_t {2}}},
+		Array {Scalar {uint64_t {2}}, Scalar {uint64_t {1}}},
+		Dict {},
+		Dict {{"a", Scalar {uint64_t {1}}}},
+		Dict {{"b", Scalar {uint64_t {1}}}},
+		Dict {{"a", Scalar {uint64_t {1}}}, {"b", ScalarWithUnit {2.5, "ms"}}},
+		Dict {{"a", Array {Scalar {"x"}, Scalar {"y"}}}},
+		Dict {{"a", Scalar {std::string(100, 'x')}}},
+		Dict {{"a", Scalar {std::string(101, 'x')}}},
+	};
+
+	std::set<uint64_t> hashes;
+	for (const auto& content : contents) {
+		const uint64_t hash = hashContent(content);
+		EXPECT_EQ(hash, hashContent(Content(content)));
+		hashes.insert(hash);
+	}
+
+	EXPECT_EQ(hashes.size(), contents.size());
+}
+
+/**
+ * @test Test that the hash is the XXH64 hash of the binary encoding of the content.
+ */
+TEST(TelemetryContentHash, stable)
+{
+	EXPECT_EQ(hashContent(Scalar {}), 0xb932ef433c46615aULL);
+	EXPECT_EQ(
+		hashContent(Dict {
+			{"packets", Scalar {uint64_t {123456}}},
+			{"time", ScalarWithUnit {1.5, "ms"}},
+			{"queues", Array {Scalar {int64_t {-1}}, Scalar {"eth0"}}},
+		}),
+		0x7a868ce1fce05a4cULL);
+}
+
+/**
+ * @test Test that the hasher can be reused and matches hashContent().
+ */
+TEST(TelemetryContentHash, hasher)
+{
+	const Content content = Dict {
+		{"packets", Scalar {uint64_t {10}}},
+		{"name", Scalar {std::string(200, 'n')}},
+	};
+
+	ContentHasher hasher;
+	const uint64_t emptyHash = hasher.digest();
+
+	writeContent(hasher, content);
+	EXPECT_EQ(hasher.digest(), hashContent(content));
+	EXPECT_EQ(hasher.digest(), hasher.digest());
+
+	hasher.reset();
+	EXPECT_EQ(hasher.digest(), emptyHash);
+
+	writeContent(hasher, content);
+	EXPECT_EQ(hasher.digest(), hashContent(content));
+}
+
+} // namespace telemetry
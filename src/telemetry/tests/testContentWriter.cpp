@@ -0,0 +1,120 @@
+/**
+ * @file
+ * @author Pavel Siska <siska@cesnet.cz>
+ * @brief Unit tests of Telemetry::ContentWriter
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <gtest/gtest.h>
+
+namespace telemetry {
+
+static std::string renderText(const Content& content)
+{
+	TextContentWriter writer;
+	writeContent(writer, content);
+	return writer.str();
+}
+
+/**
+ * @test Test that the text writer renders the same output as contentToString().
+ */
+TEST(TelemetryContentWriter, textMatchesContentToString)
+{
+	const std::vector<Content> contents {
+		Scalar {},
+		Scalar {true},
+		Scalar {uint64_t {123456789}},
+		Scalar {int64_t {-123456789}},
+		Scalar {-123456789.123},
+		Scalar {std::string("hello world!")},
+		ScalarWithUnit {123.456, "ms"},
+		Array {},
+		Array {Scalar {uint64_t {1}}, Scalar {2.5}, Scalar {std::string("x")}, Scalar {}},
+		Dict {},
+		Dict {
+			{"a", Scalar {uint64_t {1}}},
+			{"longKey", ScalarWithUnit {2.0, "s"}},
+			{"array", Array {Scalar {true}, Scalar {false}}},
+			{"emptyArray", Array {}},
+			{"unknown", std::monostate {}},
+		},
+	};
+
+	for (const auto& content : contents) {
+		EXPECT_EQ(contentToString(content), renderText(content));
+	}
+}
+
+/**
+ * @test Test that a reused text writer renders each content from scratch.
+ */
+TEST(TelemetryContentWriter, textReuse)
+{
+	TextContentWriter writer;
+
+	writeContent(writer, Dict {{"key", Scalar {uint64_t {1}}}});
+	EXPECT_EQ("key: 1", writer.str());
+
+	writer.clear();
+	writer.unit("B");
+	writer.value(uint64_t {10});
+	EXPECT_EQ("10 (B)", writer.str());
+
+	writer.clear();
+	writer.beginDict();
+	writer.key("k");
+	writer.value("v");
+	writer.endDict();
+	EXPECT_EQ("k: v", writer.str());
+}
+
+/**
+ * @test Test that the builder reconstructs written content.
+ */
+TEST(TelemetryContentWriter, builder)
+{
+	const std::vector<Content> contents {
+		Scalar {},
+		Scalar {int64_t {-1}},
+		Scalar {std::string("hello")},
+		ScalarWithUnit {Scalar {uint64_t {42}}, "pkts"},
+		Array {Scalar {uint64_t {1}}, Scalar {2.5}},
+		Dict {
+			{"a", Scalar {uint64_t {1}}},
+			{"b", ScalarWithUnit {2.0, "s"}},
+			{"c", Array {Scalar {true}}},
+		},
+	};
+
+	ContentBuilder builder;
+	for (const auto& content : contents) {
+		writeContent(builder, content);
+		EXPECT_EQ(content, builder.takeContent());
+	}
+
+	EXPECT_EQ(Content {Scalar {}}, builder.takeContent());
+}
+
+/**
+ * @test Test that the builder rejects content in a wrong shape.
+ */
+TEST(TelemetryContentWriter, builderInvalidShape)
+{
+	ContentBuilder builder;
+	EXPECT_THROW(builder.key("key"), TelemetryException);
+	EXPECT_THROW(builder.endDict(), TelemetryException);
+	EXPECT_THROW(builder.endArray(), TelemetryException);
+
+	builder.beginDict();
+	EXPECT_THROW(builder.value(uint64_t {1}), TelemetryException);
+	EXPECT_THROW(builder.takeContent(), TelemetryException);
+	builder.endDict();
+
+	builder.beginArray();
+	EXPECT_THROW(builder.beginArray(), TelemetryException);
+	EXPECT_THROW(builder.beginDict(), TelemetryException);
+}
+
+} // namespace telemetry
@@ -128,6 +128,55 @@ TEST(TelemetryDirectory, addFile)
 	EXPECT_EQ("/cache/info", cacheInfo->getFullPath());
 }
 
+/**
+ * @test Test creating telemetry files of sharded counters.
+ */
+TEST(TelemetryDirectory, addCounterFile)
+{
+	auto root = Directory::create();
+	auto counter = std::make_shared<ShardedCounter>();
+
+	auto packets = root->addCounterFile("packets", counter);
+	EXPECT_EQ("/packets", packets->getFullPath());
+	EXPECT_TRUE(packets->hasRead());
+	EXPECT_TRUE(packets->hasClear());
+
+	counter->add(42);
+	EXPECT_EQ(Content {Scalar {uint64_t {42}}}, packets->read());
+
+	TextContentWriter writer;
+	packets->readTo(writer);
+	EXPECT_EQ("42", writer.str());
+
+	packets->clear();
+	EXPECT_EQ(0, counter->value());
+
+	EXPECT_THROW((void) root->addCounterFile("packets", counter), TelemetryException);
+}
+
+/**
+ * @test Test creating telemetry files of variables.
+ */
+TEST(TelemetryDirectory, addVariableFiles)
+{
+	auto root = Directory::create();
+
+	const std::atomic<uint64_t> packets = 42;
+	const std::atomic<int64_t> balance = -1;
+	const std::atomic<double> load = 0.5;
+
+	auto packetsFile = root->addCounterFile("packets", packets);
+	auto balanceFile = root->addGaugeFile("balance", balance);
+	auto loadFile = root->addGaugeFile("load", load);
+
+	EXPECT_EQ(Content {Scalar {uint64_t {42}}}, packetsFile->read());
+	EXPECT_EQ(Content {Scalar {int64_t {-1}}}, balanceFile->read());
+	EXPECT_EQ(Content {Scalar {0.5}}, loadFile->read());
+	EXPECT_FALSE(packetsFile->hasClear());
+
+	EXPECT_THROW((void) root->addGaugeFile("load", load), TelemetryException);
+}
+
 /**
  * @test Test creating invalid telemetry files.
  */
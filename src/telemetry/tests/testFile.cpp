@@ -8,6 +8,13 @@
 
 #include <telemetry/directory.hpp>
 
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory_resource>
+#include <thread>
+#include <vector>
+
 #include <gtest/gtest.h>
 
 namespace telemetry {
@@ -108,4 +115,439 @@ TEST(TelemetryFile, disable)
 	EXPECT_THROW(file->clear(), TelemetryException);
 }
 
+/**
+ * @test Test that concurrent reads of the same file are not serialized.
+ */
+TEST(TelemetryFile, concurrentRead)
+{
+	using namespace std::chrono_literals;
+
+	std::atomic<int> running = 0;
+	std::atomic<int> maxRunning = 0;
+
+	FileOps ops {};
+	ops.read = [&]() {
+		const int current = ++running;
+		int expected = maxRunning.load();
+		while (expected < current && !maxRunning.compare_exchange_weak(expected, current)) {}
+
+		// Wait for the other reader (bounded, so a serialized read just fails the test)
+		for (int idx = 0; idx < 1000 && maxRunning < 2; idx++) {
+			std::this_thread::sleep_for(1ms);
+		}
+
+		running--;
+		return Scalar {uint64_t {1}};
+	};
+
+	auto root = Directory::create();
+	auto file = root->addFile("file", ops);
+
+	auto reader1 = std::async(std::launch::async, [&]() { return file->read(); });
+	auto reader2 = std::async(std::launch::async, [&]() { return file->read(); });
+
+	EXPECT_EQ(Content {Scalar {uint64_t {1}}}, reader1.get());
+	EXPECT_EQ(Content {Scalar {uint64_t {1}}}, reader2.get());
+	EXPECT_EQ(2, maxRunning);
+}
+
+/**
+ * @test Test that availability checks are not blocked by a running callback.
+ */
+TEST(TelemetryFile, hasReadDuringRead)
+{
+	using namespace std::chrono_literals;
+
+	std::atomic<bool> entered = false;
+	std::atomic<bool> release = false;
+
+	FileOps ops {};
+	ops.read = [&]() {
+		entered = true;
+		while (!release) {
+			std::this_thread::sleep_for(1ms);
+		}
+		return Scalar {};
+	};
+	ops.clear = []() {};
+
+	auto root = Directory::create();
+	auto file = root->addFile("file", ops);
+
+	auto reader = std::async(std::launch::async, [&]() { return file->read(); });
+	while (!entered) {
+		std::this_thread::sleep_for(1ms);
+	}
+
+	EXPECT_TRUE(file->hasRead());
+	EXPECT_TRUE(file->hasClear());
+	EXPECT_NO_THROW(file->clear());
+
+	release = true;
+	reader.get();
+}
+
+/**
+ * @test Test that disable() waits for callbacks that are already running.
+ */
+TEST(TelemetryFile, disableWaitsForRunningCallback)
+{
+	using namespace std::chrono_literals;
+
+	std::atomic<bool> entered = false;
+	std::atomic<bool> finished = false;
+
+	FileOps ops {};
+	ops.read = [&]() {
+		entered = true;
+		std::this_thread::sleep_for(100ms);
+		finished = true;
+		return Scalar {};
+	};
+
+	auto root = Directory::create();
+	auto file = root->addFile("file", ops);
+
+	auto reader = std::async(std::launch::async, [&]() { return file->read(); });
+	while (!entered) {
+		std::this_thread::sleep_for(1ms);
+	}
+
+	file->disable();
+	EXPECT_TRUE(finished);
+	EXPECT_FALSE(file->hasRead());
+	EXPECT_THROW(file->read(), TelemetryException);
+
+	reader.get();
+}
+
+/**
+ * @test Test that concurrent coalesced reads share a single read operation.
+ */
+TEST(TelemetryFile, coalesceReads)
+{
+	using namespace std::chrono_literals;
+
+	const size_t followersCount = 4;
+	std::atomic<bool> entered = false;
+	std::atomic<int> readCount = 0;
+
+	FileOps ops {};
+	ops.read = [&]() {
+		const int count = ++readCount;
+		entered = true;
+		std::this_thread::sleep_for(200ms);
+		return Scalar {int64_t {count}};
+	};
+	ops.coalesceReads = true;
+
+	auto root = Directory::create();
+	auto file = root->addFile("file", ops);
+
+	auto leader = std::async(std::launch::async, [&]() { return file->read(); });
+	while (!entered) {
+		std::this_thread::sleep_for(1ms);
+	}
+
+	std::vector<std::future<Content>> followers;
+	for (size_t idx = 0; idx < followersCount; idx++) {
+		followers.emplace_back(std::async(std::launch::async, [&]() { return file->read(); }));
+	}
+
+	EXPECT_EQ(Content {Scalar {int64_t {1}}}, leader.get());
+	for (auto& follower : followers) {
+		EXPECT_EQ(Content {Scalar {int64_t {1}}}, follower.get());
+	}
+
+	EXPECT_EQ(1, readCount);
+
+	// A read that starts after the previous one is finished calls the operation again
+	EXPECT_EQ(Content {Scalar {int64_t {2}}}, file->read());
+}
+
+/**
+ * @test Test that an exception of a coalesced read is propagated to all readers.
+ */
+TEST(TelemetryFile, coalesceReadsException)
+{
+	using namespace std::chrono_literals;
+
+	std::atomic<bool> entered = false;
+
+	FileOps ops {};
+	ops.read = [&]() -> Content {
+		entered = true;
+		std::this_thread::sleep_for(100ms);
+		throw TelemetryException("read failed");
+	};
+	ops.coalesceReads = true;
+
+	auto root = Directory::create();
+	auto file = root->addFile("file", ops);
+
+	auto leader = std::async(std::launch::async, [&]() { return file->read(); });
+	while (!entered) {
+		std::this_thread::sleep_for(1ms);
+	}
+
+	auto follower = std::async(std::launch::async, [&]() { return file->read(); });
+
+	EXPECT_THROW(leader.get(), TelemetryException);
+	EXPECT_THROW(follower.get(), TelemetryException);
+	EXPECT_THROW(file->read(), TelemetryException);
+}
+
+/**
+ * @test Test that disable() waits for a running coalesced read.
+ */
+TEST(TelemetryFile, disableDuringCoalescedRead)
+{
+	using namespace std::chrono_literals;
+
+	std::atomic<bool> entered = false;
+
+	FileOps ops {};
+	ops.read = [&]() {
+		entered = true;
+		std::this_thread::sleep_for(100ms);
+		return Scalar {uint64_t {1}};
+	};
+	ops.coalesceReads = true;
+
+	auto root = Directory::create();
+	auto file = root->addFile("file", ops);
+
+	auto reader = std::async(std::launch::async, [&]() { return file->read(); });
+	while (!entered) {
+		std::this_thread::sleep_for(1ms);
+	}
+
+	file->disable();
+	EXPECT_EQ(Content {Scalar {uint64_t {1}}}, reader.get());
+	EXPECT_THROW(file->read(), TelemetryException);
+}
+
+/**
+ * @test Test that reads within the cache duration reuse the last read content.
+ */
+TEST(TelemetryFile, cacheDuration)
+{
+	using namespace std::chrono_literals;
+
+	int64_t counter = 0;
+	FileOps ops {};
+	ops.read = [&]() { return Scalar {counter++}; };
+	ops.clear = [&]() { counter = 0; };
+	ops.cacheDuration = 100ms;
+
+	auto root = Directory::create();
+	auto file = root->addFile("file", ops);
+
+	EXPECT_EQ(Content {Scalar {int64_t {0}}}, file->read());
+	EXPECT_EQ(Content {Scalar {int64_t {0}}}, file->read());
+	EXPECT_EQ(1, counter);
+
+	std::this_thread::sleep_for(150ms);
+	EXPECT_EQ(Content {Scalar {int64_t {1}}}, file->read());
+	EXPECT_EQ(Content {Scalar {int64_t {1}}}, file->read());
+	EXPECT_EQ(2, counter);
+
+	// Clear operation invalidates the cached content
+	file->clear();
+	EXPECT_EQ(Content {Scalar {int64_t {0}}}, file->read());
+
+	// Disabled file doesn't return the cached content
+	file->disable();
+	EXPECT_THROW(file->read(), TelemetryException);
+}
+
+/**
+ * @test Test file with the streaming read operation.
+ */
+TEST(TelemetryFile, streamRead)
+{
+	auto root = Directory::create();
+
+	FileOps ops;
+	ops.streamRead = [](ContentWriter& writer) {
+		writer.beginDict();
+		writer.key("packets");
+		writer.value(uint64_t {10});
+		writer.key("time");
+		writer.unit("ms");
+		writer.value(1.5);
+		writer.endDict();
+	};
+	auto file = root->addFile("file", ops);
+
+	const Content expected = Dict {
+		{"packets", Scalar {uint64_t {10}}},
+		{"time", ScalarWithUnit {1.5, "ms"}},
+	};
+
+	EXPECT_TRUE(file->hasRead());
+	EXPECT_EQ(expected, file->read());
+
+	TextContentWriter writer;
+	file->readTo(writer);
+	EXPECT_EQ(contentToString(expected), writer.str());
+
+	// Files with the object read operation support the streaming read too
+	FileOps objectOps;
+	objectOps.read = [&]() { return expected; };
+	auto objectFile = root->addFile("objectFile", objectOps);
+
+	writer.clear();
+	objectFile->readTo(writer);
+	EXPECT_EQ(contentToString(expected), writer.str());
+
+	file->disable();
+	EXPECT_FALSE(file->hasRead());
+	EXPECT_THROW(file->readTo(writer), TelemetryException);
+}
+
+/**
+ * @test Test files that expose a variable.
+ */
+TEST(TelemetryFile, variable)
+{
+	auto root = Directory::create();
+
+	std::atomic<uint64_t> packets = 10;
+	std::atomic<int64_t> balance = -5;
+	std::atomic<double> load = 0.25;
+
+	FileOps ops;
+	ops.variable = FileVariable(packets);
+	ops.trackContentHash = true;
+	auto packetsFile = root->addFile("packets", ops);
+	auto balanceFile = root->addFile("balance", {.variable = FileVariable(balance)});
+	auto loadFile = root->addFile("load", {.variable = FileVariable(load)});
+
+	EXPECT_TRUE(packetsFile->hasRead());
+	EXPECT_FALSE(packetsFile->hasClear());
+	EXPECT_EQ(Content {Scalar {uint64_t {10}}}, packetsFile->read());
+	EXPECT_EQ(Content {Scalar {int64_t {-5}}}, balanceFile->read());
+	EXPECT_EQ(Content {Scalar {0.25}}, loadFile->read());
+
+	packets = 20;
+	TextContentWriter writer;
+	packetsFile->readTo(writer);
+	EXPECT_EQ("20", writer.str());
+	EXPECT_EQ(hashContent(Scalar {uint64_t {20}}), packetsFile->getContentHash());
+
+	// The variable is used instead of read operations
+	FileOps bothOps;
+	bothOps.read = []() { return Content {Scalar {std::string("read")}}; };
+	bothOps.variable = FileVariable(packets);
+	auto bothFile = root->addFile("both", bothOps);
+	EXPECT_EQ(Content {Scalar {uint64_t {20}}}, bothFile->read());
+
+	EXPECT_EQ(Scalar {}, FileVariable().load());
+	EXPECT_FALSE(FileVariable());
+
+	packetsFile->disable();
+	EXPECT_FALSE(packetsFile->hasRead());
+	EXPECT_THROW(packetsFile->readTo(writer), TelemetryException);
+}
+
+/**
+ * @test Test that content kept by the file doesn't refer to the arena of a streaming read.
+ */
+TEST(TelemetryFile, readArena)
+{
+	auto root = Directory::create();
+
+	std::atomic<size_t> readCount = 0;
+	std::pmr::memory_resource* readResource = nullptr;
+
+	FileOps ops;
+	ops.readArena = true;
+	ops.cacheDuration = std::chrono::hours(1);
+	ops.read = [&]() {
+		readCount++;
+		readResource = getContentResource();
+		Dict dict;
+		dict["array"] = Array {Scalar {uint64_t {1}}, Scalar {std::string(64, 'x')}};
+		return dict;
+	};
+	auto file = root->addFile("file", ops);
+
+	TextContentWriter writer;
+	file->readTo(writer);
+	EXPECT_NE(std::pmr::get_default_resource(), readResource);
+
+	// The cached copy is used after the arena of the first read has been released
+	const std::string expected = writer.str();
+	writer.clear();
+	file->readTo(writer);
+	EXPECT_EQ(expected, writer.str());
+	EXPECT_EQ(contentToString(file->read()), expected);
+	EXPECT_EQ(1, readCount);
+
+	// Files that didn't opt in never allocate from the arena of the caller
+	FileOps plainOps;
+	plainOps.read = [&]() {
+		readResource = getContentResource();
+		return Scalar {};
+	};
+	auto plainFile = root->addFile("plainFile", plainOps);
+
+	std::pmr::monotonic_buffer_resource arena;
+	const ContentResourceScope scope(&arena);
+	plainFile->read();
+	EXPECT_EQ(std::pmr::get_default_resource(), readResource);
+}
+
+/**
+ * @test Test that the file keeps the hash of the last read content.
+ */
+TEST(TelemetryFile, trackContentHash)
+{
+	auto root = Directory::create();
+	uint64_t counter = 0;
+
+	FileOps ops;
+	ops.read = [&]() { return Scalar {counter}; };
+	ops.trackContentHash = true;
+	auto file = root->addFile("file", ops);
+
+	EXPECT_FALSE(file->getContentHash().has_value());
+
+	file->read();
+	EXPECT_EQ(file->getContentHash(), hashContent(Scalar {uint64_t {0}}));
+
+	counter++;
+	TextContentWriter writer;
+	file->readTo(writer);
+	EXPECT_EQ(file->getContentHash(), hashContent(Scalar {uint64_t {1}}));
+
+	// Streaming read computes the same hash as the object read
+	FileOps streamOps;
+	streamOps.streamRead = [](ContentWriter& writer) {
+		writer.beginDict();
+		writer.key("time");
+		writer.unit("ms");
+		writer.value(1.5);
+		writer.endDict();
+	};
+	streamOps.trackContentHash = true;
+	auto streamFile = root->addFile("streamFile", streamOps);
+
+	writer.clear();
+	streamFile->readTo(writer);
+	EXPECT_EQ(writer.str(), contentToString(streamFile->read()));
+	EXPECT_EQ(
+		streamFile->getContentHash(),
+		hashContent(Dict {{"time", ScalarWithUnit {1.5, "ms"}}}));
+
+	// Hash is not tracked by default
+	FileOps untrackedOps;
+	untrackedOps.read = [&]() { return Scalar {counter}; };
+	auto untrackedFile = root->addFile("untrackedFile", untrackedOps);
+
+	untrackedFile->read();
+	EXPECT_FALSE(untrackedFile->getContentHash().has_value());
+}
+
 } // namespace telemetry
@@ -0,0 +1,235 @@
+/**
+ * @file
+ * @author Pavel Siska <siska@cesnet.cz>
+ * @brief Unit tests of the histogram content
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <telemetry/content.hpp>
+#include <telemetry/contentWriter.hpp>
+
+#include <limits>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace telemetry {
+
+/**
+ * @test Test that buckets cover all 64-bit values without gaps and overlaps.
+ */
+TEST(TelemetryHistogram, buckets)
+{
+	for (const unsigned precision : {0U, 1U, Histogram::DEFAULT_PRECISION, Histogram::MAX_PRECISION}) {
+		const size_t bucketCount = Histogram::bucketCount(precision);
+		EXPECT_EQ(0, Histogram::bucketLowerBound(0, precision));
+		EXPECT_EQ(
+			std::numeric_limits<uint64_t>::max(),
+			Histogram::bucketUpperBound(static_cast<uint32_t>(bucketCount - 1), precision));
+
+		for (uint32_t index = 0; index + 1 < bucketCount; index++) {
+			const uint64_t lower = Histogram::bucketLowerBound(index, precision);
+			const uint64_t upper = Histogram::bucketUpperBound(index, precision);
+			ASSERT_LE(lower, upper);
+			ASSERT_EQ(upper + 1, Histogram::bucketLowerBound(index + 1, precision));
+			ASSERT_EQ(index, Histogram::bucketIndex(lower, precision));
+			ASSERT_EQ(index, Histogram::bucketIndex(upper, precision));
+		}
+	}
+
+	// Relative width of buckets is limited by the precision
+	EXPECT_EQ(57, Histogram::bucketIndex(100, 4));
+	EXPECT_EQ(100, Histogram::bucketLowerBound(57, 4));
+	EXPECT_EQ(103, Histogram::bucketUpperBound(57, 4));
+	EXPECT_EQ(976, Histogram::bucketCount(Histogram::DEFAULT_PRECISION));
+
+	EXPECT_THROW(Histogram("us", Histogram::MAX_PRECISION + 1), TelemetryException);
+	EXPECT_THROW(HistogramRecorder("us", Histogram::MAX_PRECISION + 1), TelemetryException);
+}
+
+/**
+ * @test Test recording of values.
+ */
+TEST(TelemetryHistogram, record)
+{
+	Histogram histogram("us");
+	EXPECT_EQ(0, histogram.count());
+	EXPECT_EQ(0, histogram.min());
+	EXPECT_EQ(0, histogram.max());
+	EXPECT_EQ(0, histogram.mean());
+
+	histogram.record(5);
+	histogram.record(100, 2);
+	histogram.record(0);
+	histogram.record(7, 0);
+
+	const Histogram::Buckets expected {{0, 1}, {5, 1}, {57, 2}};
+	EXPECT_EQ(expected, histogram.buckets());
+	EXPECT_EQ("us", histogram.unit());
+	EXPECT_EQ(4, histogram.count());
+	EXPECT_EQ(205, histogram.sum());
+	EXPECT_EQ(0, histogram.min());
+	EXPECT_EQ(100, histogram.max());
+	EXPECT_DOUBLE_EQ(51.25, histogram.mean());
+}
+
+/**
+ * @test Test that values at quantiles are within the precision of the histogram.
+ */
+TEST(TelemetryHistogram, valueAtQuantile)
+{
+	Histogram histogram;
+	EXPECT_EQ(0, histogram.valueAtQuantile(0.5));
+
+	for (uint64_t value = 1; value <= 1000; value++) {
+		histogram.record(value);
+	}
+
+	EXPECT_EQ(1, histogram.valueAtQuantile(0));
+	EXPECT_EQ(1000, histogram.valueAtQuantile(1));
+	EXPECT_EQ(1000, histogram.valueAtQuantile(2));
+	EXPECT_EQ(511, histogram.valueAtQuantile(0.5));
+
+	for (const double quantile : {0.1, 0.25, 0.5, 0.9, 0.99, 0.999}) {
+		const auto exact = static_cast<double>(quantile * 1000);
+		const auto value = static_cast<double>(histogram.valueAtQuantile(quantile));
+		EXPECT_GE(value, exact);
+		EXPECT_LE(value, exact * (1 + 1.0 / 16));
+	}
+}
+
+/**
+ * @test Test that merged histograms are the same as a histogram of all values.
+ */
+TEST(TelemetryHistogram, merge)
+{
+	Histogram first("us");
+	Histogram second("us");
+	Histogram all("us");
+
+	for (uint64_t value = 0; value < 5000; value += 7) {
+		first.record(value);
+		all.record(value);
+	}
+	for (uint64_t value = 3; value < 100000; value += 13) {
+		second.record(value, 2);
+		all.record(value, 2);
+	}
+
+	first.merge(second);
+	EXPECT_EQ(all, first);
+
+	first.merge(Histogram("us"));
+	EXPECT_EQ(all, first);
+
+	Histogram empty("us");
+	empty.merge(all);
+	EXPECT_EQ(all, empty);
+
+	EXPECT_THROW(first.merge(Histogram("ms")), TelemetryException);
+	EXPECT_THROW(first.merge(Histogram("us", 5)), TelemetryException);
+}
+
+/**
+ * @test Test creation of a histogram from its parts and validation of the parts.
+ */
+TEST(TelemetryHistogram, fromParts)
+{
+	Histogram histogram("us");
+	histogram.record(5);
+	histogram.record(100, 2);
+
+	EXPECT_EQ(
+		histogram,
+		Histogram::fromParts("us", 4, histogram.buckets(), histogram.sum(), 5, 100));
+	EXPECT_EQ(Histogram("us", 2), Histogram::fromParts("us", 2, {}, 0, 0, 0));
+
+	EXPECT_THROW(Histogram::fromParts("us", 11, {}, 0, 0, 0), TelemetryException);
+	// Unsorted, empty and out of range buckets
+	EXPECT_THROW(Histogram::fromParts("us", 4, {{57, 2}, {5, 1}}, 205, 5, 100), TelemetryException);
+	EXPECT_THROW(Histogram::fromParts("us", 4, {{5, 0}}, 0, 5, 5), TelemetryException);
+	EXPECT_THROW(Histogram::fromParts("us", 0, {{65, 1}}, 0, 0, 0), TelemetryException);
+	// Extremes outside of the first and the last bucket
+	EXPECT_THROW(Histogram::fromParts("us", 4, {{5, 1}, {57, 2}}, 205, 4, 100), TelemetryException);
+	EXPECT_THROW(Histogram::fromParts("us", 4, {{5, 1}, {57, 2}}, 205, 5, 104), TelemetryException);
+}
+
+/**
+ * @test Test recording of values from several threads.
+ */
+TEST(TelemetryHistogram, recorder)
+{
+	constexpr unsigned threadCount = 4;
+	constexpr uint64_t valueCount = 10000;
+
+	HistogramRecorder recorder("us");
+	EXPECT_EQ(Histogram("us"), recorder.snapshot());
+
+	std::vector<std::thread> threads;
+	for (unsigned idx = 0; idx < threadCount; idx++) {
+		threads.emplace_back([&recorder]() {
+			for (uint64_t value = 1; value <= valueCount; value++) {
+				recorder.record(value);
+			}
+		});
+	}
+	for (auto& thread : threads) {
+		thread.join();
+	}
+
+	Histogram expected("us");
+	for (uint64_t value = 1; value <= valueCount; value++) {
+		expected.record(value, threadCount);
+	}
+	EXPECT_EQ(expected, recorder.snapshot());
+
+	recorder.reset();
+	EXPECT_EQ(Histogram("us"), recorder.snapshot());
+}
+
+/**
+ * @test Test that a histogram is built by the content builder and written by other writers
+ *   as a summary.
+ */
+TEST(TelemetryHistogram, writer)
+{
+	Histogram histogram("us");
+	for (uint64_t value = 1; value <= 100; value++) {
+		histogram.record(value);
+	}
+
+	ContentBuilder builder;
+	writeContent(builder, histogram);
+	EXPECT_EQ(Content {histogram}, builder.takeContent());
+
+	builder.beginArray();
+	EXPECT_THROW(builder.histogram(histogram), TelemetryException);
+
+	EXPECT_EQ(
+		"count: 100\n"
+		"sum:   5050 (us)\n"
+		"min:   1 (us)\n"
+		"max:   100 (us)\n"
+		"mean:  50.50 (us)\n"
+		"p50:   51 (us)\n"
+		"p90:   91 (us)\n"
+		"p99:   99 (us)\n"
+		"p999:  100 (us)",
+		contentToString(histogram));
+
+	EXPECT_EQ(
+		"count: 0\n"
+		"sum:   <N/A> (ms)\n"
+		"min:   <N/A> (ms)\n"
+		"max:   <N/A> (ms)\n"
+		"mean:  <N/A> (ms)\n"
+		"p50:   <N/A> (ms)\n"
+		"p90:   <N/A> (ms)\n"
+		"p99:   <N/A> (ms)\n"
+		"p999:  <N/A> (ms)",
+		contentToString(Histogram("ms")));
+}
+
+} // namespace telemetry
@@ -0,0 +1,173 @@
+/**
+ * @file
+ * @author Pavel Siska <siska@cesnet.cz>
+ * @brief Unit tests of the HyperLogLog content
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <telemetry/content.hpp>
+#include <telemetry/contentWriter.hpp>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace telemetry {
+
+/**
+ * @test Test registers of hashes and the range of the precision.
+ */
+TEST(TelemetryHyperLogLog, registers)
+{
+	EXPECT_EQ(0, HyperLogLog::registerIndex(0x0FFFFFFFFFFFFFFFULL, 4));
+	EXPECT_EQ(15, HyperLogLog::registerIndex(0xF000000000000000ULL, 4));
+	EXPECT_EQ(1, HyperLogLog::registerValue(0x0800000000000000ULL, 4));
+	EXPECT_EQ(2, HyperLogLog::registerValue(0x0400000000000000ULL, 4));
+	// Zero remaining bits are limited by the sentinel
+	EXPECT_EQ(61, HyperLogLog::registerValue(0, 4));
+	EXPECT_EQ(47, HyperLogLog::registerValue(0, 18));
+
+	EXPECT_EQ(4096, HyperLogLog().registers().size());
+	EXPECT_EQ(16, HyperLogLog(HyperLogLog::MIN_PRECISION).registers().size());
+	EXPECT_THROW(HyperLogLog(3), TelemetryException);
+	EXPECT_THROW(HyperLogLog(19), TelemetryException);
+	EXPECT_THROW(HyperLogLogRecorder(19), TelemetryException);
+}
+
+/**
+ * @test Test that estimates are within a few standard errors of the exact counts.
+ */
+TEST(TelemetryHyperLogLog, estimate)
+{
+	HyperLogLog hyperLogLog;
+	EXPECT_EQ(0, hyperLogLog.estimate());
+
+	// Repeated values don't change the estimate
+	for (int repeat = 0; repeat < 3; repeat++) {
+		for (uint64_t value = 0; value < 10; value++) {
+			hyperLogLog.add(value);
+		}
+	}
+	EXPECT_EQ(10, hyperLogLog.estimate());
+
+	for (uint64_t value = 0; value < 100000; value++) {
+		hyperLogLog.add(value);
+	}
+	EXPECT_NEAR(100000, static_cast<double>(hyperLogLog.estimate()), 5000);
+
+	HyperLogLog strings(14);
+	for (int value = 0; value < 50000; value++) {
+		strings.add("10.0." + std::to_string(value));
+	}
+	EXPECT_NEAR(50000, static_cast<double>(strings.estimate()), 2000);
+}
+
+/**
+ * @test Test that merged HyperLogLogs estimate the number of distinct values of the union.
+ */
+TEST(TelemetryHyperLogLog, merge)
+{
+	HyperLogLog first;
+	HyperLogLog second;
+	HyperLogLog all;
+
+	for (uint64_t value = 0; value < 30000; value++) {
+		first.add(value);
+		all.add(value);
+	}
+	for (uint64_t value = 20000; value < 50000; value++) {
+		second.add(value);
+		all.add(value);
+	}
+
+	first.merge(second);
+	EXPECT_EQ(all, first);
+	EXPECT_NEAR(50000, static_cast<double>(first.estimate()), 2500);
+
+	first.merge(HyperLogLog());
+	EXPECT_EQ(all, first);
+
+	EXPECT_THROW(first.merge(HyperLogLog(10)), TelemetryException);
+}
+
+/**
+ * @test Test creation of a HyperLogLog from its registers and validation of the registers.
+ */
+TEST(TelemetryHyperLogLog, fromRegisters)
+{
+	HyperLogLog hyperLogLog(4);
+	hyperLogLog.add(uint64_t {1});
+	hyperLogLog.add(std::string_view("flow"));
+
+	EXPECT_EQ(hyperLogLog, HyperLogLog::fromRegisters(4, hyperLogLog.registers()));
+
+	EXPECT_THROW(HyperLogLog::fromRegisters(4, HyperLogLog::Registers(8)), TelemetryException);
+	EXPECT_THROW(HyperLogLog::fromRegisters(2, HyperLogLog::Registers(4)), TelemetryException);
+
+	HyperLogLog::Registers registers(16);
+	registers[3] = 61;
+	EXPECT_NO_THROW(HyperLogLog::fromRegisters(4, registers));
+	registers[3] = 62;
+	EXPECT_THROW(HyperLogLog::fromRegisters(4, registers), TelemetryException);
+}
+
+/**
+ * @test Test that a recorder updated by several threads is the same as a single HyperLogLog.
+ */
+TEST(TelemetryHyperLogLog, recorder)
+{
+	constexpr unsigned threadCount = 4;
+	constexpr uint64_t valueCount = 20000;
+
+	HyperLogLogRecorder recorder;
+	HyperLogLog expected;
+
+	std::vector<std::thread> threads;
+	for (unsigned thread = 0; thread < threadCount; thread++) {
+		threads.emplace_back([&recorder, thread]() {
+			// Threads share half of their values
+			for (uint64_t value = 0; value < valueCount; value++) {
+				recorder.add(value + thread * valueCount / 2);
+			}
+		});
+	}
+	for (auto& thread : threads) {
+		thread.join();
+	}
+
+	for (uint64_t value = 0; value < valueCount * (threadCount + 1) / 2; value++) {
+		expected.add(value);
+	}
+
+	EXPECT_EQ(expected, recorder.snapshot());
+
+	recorder.reset();
+	EXPECT_EQ(HyperLogLog(), recorder.snapshot());
+}
+
+/**
+ * @test Test that a HyperLogLog is built by the content builder and written by other writers
+ *   as the estimate.
+ */
+TEST(TelemetryHyperLogLog, writer)
+{
+	HyperLogLog hyperLogLog;
+	for (uint64_t value = 0; value < 5; value++) {
+		hyperLogLog.add(value);
+	}
+
+	ContentBuilder builder;
+	writeContent(builder, hyperLogLog);
+	EXPECT_EQ(Content {hyperLogLog}, builder.takeContent());
+
+	builder.beginDict();
+	EXPECT_THROW(builder.hyperLogLog(hyperLogLog), TelemetryException);
+
+	EXPECT_EQ("5", contentToString(hyperLogLog));
+	EXPECT_EQ("0", contentToString(HyperLogLog()));
+}
+
+} // namespace telemetry
@@ -0,0 +1,268 @@
+/**
+ * @file
+ * @author Pavel Siska <siska@cesnet.cz>
+ * @brief Unit tests of the quantile sketch content
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <telemetry/content.hpp>
+#include <telemetry/contentWriter.hpp>
+
+#include <cmath>
+#include <limits>
+
+#include <gtest/gtest.h>
+
+namespace telemetry {
+
+/**
+ * @test Test that values belong to buckets whose bounds are within the relative accuracy.
+ */
+TEST(TelemetryQuantileSketch, buckets)
+{
+	const QuantileSketch sketch;
+
+	for (const double value : {1e-300, 1e-9, 0.5, 1.0, 1.01, 100.0, 12345.678, 1e300}) {
+		const int32_t index = sketch.bucketIndex(value);
+		EXPECT_LT(sketch.bucketLowerBound(index), value * (1 + 1e-12));
+		EXPECT_GE(sketch.bucketUpperBound(index), value * (1 - 1e-12));
+		EXPECT_LE(sketch.bucketUpperBound(index), sketch.bucketLowerBound(index) * 1.0203);
+	}
+
+	EXPECT_EQ(0, sketch.bucketIndex(1.0));
+	EXPECT_EQ(1, sketch.bucketIndex(1.01));
+
+	EXPECT_THROW(QuantileSketch("us", 0), TelemetryException);
+	EXPECT_THROW(QuantileSketch("us", 1), TelemetryException);
+	EXPECT_THROW(QuantileSketch("us", std::nan("")), TelemetryException);
+	EXPECT_THROW(QuantileSketch("us", 0.01, 0), TelemetryException);
+}
+
+/**
+ * @test Test recording of values.
+ */
+TEST(TelemetryQuantileSketch, record)
+{
+	QuantileSketch sketch("us");
+	EXPECT_EQ(0, sketch.count());
+	EXPECT_EQ(0, sketch.min());
+	EXPECT_EQ(0, sketch.max());
+	EXPECT_EQ(0, sketch.mean());
+
+	sketch.record(5);
+	sketch.record(100, 2);
+	sketch.record(0);
+	sketch.record(7, 0);
+
+	EXPECT_EQ("us", sketch.unit());
+	EXPECT_EQ(4, sketch.count());
+	EXPECT_EQ(1, sketch.zeroCount());
+	EXPECT_EQ(sketch.bucketIndex(5), sketch.offset());
+	EXPECT_EQ(sketch.bucketIndex(100) - sketch.bucketIndex(5) + 1, sketch.counts().size());
+	EXPECT_EQ(1, sketch.counts().front());
+	EXPECT_EQ(2, sketch.counts().back());
+	EXPECT_DOUBLE_EQ(205, sketch.sum());
+	EXPECT_EQ(0, sketch.min());
+	EXPECT_EQ(100, sketch.max());
+	EXPECT_DOUBLE_EQ(51.25, sketch.mean());
+
+	EXPECT_THROW(sketch.record(-1), TelemetryException);
+	EXPECT_THROW(sketch.record(std::numeric_limits<double>::infinity()), TelemetryException);
+	EXPECT_THROW(sketch.record(std::nan("")), TelemetryException);
+}
+
+/**
+ * @test Test that values at quantiles are within the relative accuracy of the sketch.
+ */
+TEST(TelemetryQuantileSketch, valueAtQuantile)
+{
+	QuantileSketch sketch;
+	EXPECT_EQ(0, sketch.valueAtQuantile(0.5));
+
+	for (int value = 1; value <= 10000; value++) {
+		sketch.record(value);
+	}
+
+	EXPECT_EQ(1, sketch.valueAtQuantile(0));
+	EXPECT_EQ(10000, sketch.valueAtQuantile(1));
+	EXPECT_EQ(10000, sketch.valueAtQuantile(2));
+
+	for (const double quantile : {0.1, 0.25, 0.5, 0.9, 0.99, 0.999}) {
+		const double exact = 1 + quantile * 9999;
+		EXPECT_NEAR(exact, sketch.valueAtQuantile(quantile), exact * 0.01 + 1);
+	}
+
+	QuantileSketch zeros;
+	zeros.record(0, 10);
+	zeros.record(3);
+	EXPECT_EQ(0, zeros.valueAtQuantile(0.5));
+	EXPECT_EQ(3, zeros.valueAtQuantile(1));
+}
+
+/**
+ * @test Test that the lowest buckets are collapsed when there are too many of them.
+ */
+TEST(TelemetryQuantileSketch, collapse)
+{
+	// Buckets cover a bit more than two orders of magnitude
+	QuantileSketch sketch("", 0.05, 50);
+
+	for (int value = 1; value <= 1000000; value *= 10) {
+		sketch.record(value);
+	}
+
+	EXPECT_EQ(50, sketch.counts().size());
+	EXPECT_EQ(7, sketch.count());
+	EXPECT_EQ(sketch.bucketIndex(1000000) - 49, sketch.offset());
+	// Values 1, 10, 100 and 1000 are collapsed into the first bucket
+	EXPECT_EQ(4, sketch.counts().front());
+	EXPECT_EQ(1, sketch.valueAtQuantile(0));
+	EXPECT_NEAR(10000, sketch.valueAtQuantile(0.75), 500);
+
+	// A value far below existing buckets doesn't create more buckets
+	sketch.record(1e-100);
+	EXPECT_EQ(50, sketch.counts().size());
+	EXPECT_EQ(5, sketch.counts().front());
+
+	// A value far above existing buckets collapses all of them
+	sketch.record(1e100);
+	EXPECT_EQ(50, sketch.counts().size());
+	EXPECT_EQ(8, sketch.counts().front());
+	EXPECT_EQ(1, sketch.counts().back());
+
+	QuantileSketch other("", 0.05, 50);
+	other.record(1);
+	other.record(1e200);
+	sketch.merge(other);
+	EXPECT_EQ(50, sketch.counts().size());
+	EXPECT_EQ(10, sketch.counts().front());
+	EXPECT_EQ(1, sketch.counts().back());
+	EXPECT_EQ(11, sketch.count());
+}
+
+/**
+ * @test Test that merged sketches are the same as a sketch of all values.
+ */
+TEST(TelemetryQuantileSketch, merge)
+{
+	QuantileSketch first("us");
+	QuantileSketch second("us");
+	QuantileSketch all("us");
+
+	for (int value = 0; value < 5000; value += 7) {
+		first.record(value);
+		all.record(value);
+	}
+	for (int value = 3; value < 100000; value += 13) {
+		second.record(value, 2);
+		all.record(value, 2);
+	}
+
+	first.merge(second);
+	EXPECT_EQ(all, first);
+
+	first.merge(QuantileSketch("us"));
+	EXPECT_EQ(all, first);
+
+	QuantileSketch empty("us");
+	empty.merge(all);
+	EXPECT_EQ(all, empty);
+
+	EXPECT_THROW(first.merge(QuantileSketch("ms")), TelemetryException);
+	EXPECT_THROW(first.merge(QuantileSketch("us", 0.02)), TelemetryException);
+}
+
+/**
+ * @test Test creation of a sketch from its parts and validation of the parts.
+ */
+TEST(TelemetryQuantileSketch, fromParts)
+{
+	QuantileSketch sketch("us");
+	sketch.record(0);
+	sketch.record(5);
+	sketch.record(100, 2);
+
+	EXPECT_EQ(
+		sketch,
+		QuantileSketch::fromParts(
+			"us",
+			0.01,
+			QuantileSketch::DEFAULT_MAX_BUCKETS,
+			sketch.offset(),
+			sketch.counts(),
+			1,
+			205,
+			0,
+			100));
+	EXPECT_EQ(
+		QuantileSketch("us", 0.05, 10),
+		QuantileSketch::fromParts("us", 0.05, 10, 7, {}, 0, 0, 0, 0));
+
+	EXPECT_THROW(QuantileSketch::fromParts("us", 2, 10, 0, {}, 0, 0, 0, 0), TelemetryException);
+	// Too many buckets and empty first or last bucket
+	EXPECT_THROW(
+		QuantileSketch::fromParts("us", 0.01, 2, 0, {1, 1, 1}, 0, 3, 1, 1),
+		TelemetryException);
+	EXPECT_THROW(
+		QuantileSketch::fromParts("us", 0.01, 10, 0, {0, 1}, 0, 1, 1, 1),
+		TelemetryException);
+	EXPECT_THROW(
+		QuantileSketch::fromParts("us", 0.01, 10, 0, {1, 0}, 0, 1, 1, 1),
+		TelemetryException);
+	// Extremes that don't match zeros and buckets
+	EXPECT_THROW(
+		QuantileSketch::fromParts("us", 0.01, 10, 0, {1}, 1, 1, 1, 1),
+		TelemetryException);
+	EXPECT_THROW(
+		QuantileSketch::fromParts("us", 0.01, 10, 0, {1}, 0, 1, 2, 1),
+		TelemetryException);
+	EXPECT_THROW(
+		QuantileSketch::fromParts("us", 0.01, 10, 0, {}, 1, 0, 0, 1),
+		TelemetryException);
+}
+
+/**
+ * @test Test that a sketch is built by the content builder and written by other writers
+ *   as a summary.
+ */
+TEST(TelemetryQuantileSketch, writer)
+{
+	QuantileSketch sketch("us");
+	for (int value = 1; value <= 100; value++) {
+		sketch.record(value);
+	}
+
+	ContentBuilder builder;
+	writeContent(builder, sketch);
+	EXPECT_EQ(Content {sketch}, builder.takeContent());
+
+	builder.beginArray();
+	EXPECT_THROW(builder.quantileSketch(sketch), TelemetryException);
+
+	EXPECT_EQ(
+		"count: 100\n"
+		"sum:   5050.00 (us)\n"
+		"min:   1.00 (us)\n"
+		"max:   100.00 (us)\n"
+		"mean:  50.50 (us)\n"
+		"p50:   49.90 (us)\n"
+		"p90:   89.13 (us)\n"
+		"p99:   98.50 (us)\n"
+		"p999:  98.50 (us)",
+		contentToString(sketch));
+
+	EXPECT_EQ(
+		"count: 0\n"
+		"sum:   <N/A>\n"
+		"min:   <N/A>\n"
+		"max:   <N/A>\n"
+		"mean:  <N/A>\n"
+		"p50:   <N/A>\n"
+		"p90:   <N/A>\n"
+		"p99:   <N/A>\n"
+		"p999:  <N/A>",
+		contentToString(QuantileSketch()));
+}
+
+} // namespace telemetry
@@ -0,0 +1,89 @@
+/**
+ * @file
+ * @author Pavel Siska <siska@cesnet.cz>
+ * @brief Unit tests of the sharded counter
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace telemetry {
+
+/**
+ * @test Test that the number of shards is rounded up to a power of two.
+ */
+TEST(TelemetryShardedCounter, shardCount)
+{
+	EXPECT_EQ(1, ShardedCounter(1).shardCount());
+	EXPECT_EQ(4, ShardedCounter(3).shardCount());
+	EXPECT_EQ(16, ShardedCounter(16).shardCount());
+	EXPECT_GE(ShardedCounter().shardCount(), std::thread::hardware_concurrency());
+}
+
+/**
+ * @test Test that additions of all threads are summed and reset.
+ */
+TEST(TelemetryShardedCounter, add)
+{
+	constexpr unsigned threadCount = 8;
+	constexpr uint64_t additions = 100000;
+
+	// Fewer shards than threads, so some threads share a shard
+	ShardedCounter counter(4);
+	EXPECT_EQ(0, counter.value());
+
+	counter.add();
+	counter.add(9);
+	EXPECT_EQ(10, counter.value());
+
+	std::vector<std::thread> threads;
+	for (unsigned thread = 0; thread < threadCount; thread++) {
+		threads.emplace_back([&counter]() {
+			for (uint64_t idx = 0; idx < additions; idx++) {
+				counter.add();
+			}
+		});
+	}
+	for (auto& thread : threads) {
+		thread.join();
+	}
+
+	EXPECT_EQ(10 + threadCount * additions, counter.value());
+	EXPECT_EQ(10 + threadCount * additions, counter.reset());
+	EXPECT_EQ(0, counter.value());
+}
+
+/**
+ * @test Test that additions concurrent with resets are either reset or kept.
+ */
+TEST(TelemetryShardedCounter, concurrentReset)
+{
+	constexpr unsigned threadCount = 4;
+	constexpr uint64_t additions = 100000;
+
+	ShardedCounter counter;
+	uint64_t resetSum = 0;
+
+	std::vector<std::thread> threads;
+	for (unsigned thread = 0; thread < threadCount; thread++) {
+		threads.emplace_back([&counter]() {
+			for (uint64_t idx = 0; idx < additions; idx++) {
+				counter.add(2);
+			}
+		});
+	}
+	for (int reset = 0; reset < 100; reset++) {
+		resetSum += counter.reset();
+	}
+	for (auto& thread : threads) {
+		thread.join();
+	}
+
+	EXPECT_EQ(threadCount * additions * 2, resetSum + counter.value());
+}
+
+} // namespace telemetry
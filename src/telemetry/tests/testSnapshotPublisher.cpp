@@ -0,0 +1,138 @@
+/**
+ * @file
+ * @author Pavel Siska <siska@cesnet.cz>
+ * @brief Unit tests of the snapshot publisher
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <telemetry/directory.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace telemetry {
+
+/**
+ * @test Test that stored bytes are loaded, including a size that isn't a multiple of words.
+ */
+TEST(TelemetrySnapshotPublisher, buffer)
+{
+	SnapshotBuffer buffer(13);
+	EXPECT_EQ(13, buffer.size());
+	EXPECT_EQ(0, buffer.version());
+
+	std::array<char, 13> loaded {};
+	loaded.fill('x');
+	buffer.load(loaded.data());
+	EXPECT_EQ((std::array<char, 13> {}), loaded);
+
+	const std::array<char, 13> stored {"abcdefghijkl"};
+	buffer.store(stored.data());
+	buffer.load(loaded.data());
+	EXPECT_EQ(stored, loaded);
+	EXPECT_EQ(1, buffer.version());
+}
+
+namespace {
+
+struct Stats {
+	uint64_t packets;
+	uint64_t bytes;
+	double bytesPerPacket;
+};
+
+} // namespace
+
+/**
+ * @test Test that a snapshot is a copy of the last published structure.
+ */
+TEST(TelemetrySnapshotPublisher, publish)
+{
+	SnapshotPublisher<Stats> publisher;
+	EXPECT_EQ(1, publisher.version());
+	EXPECT_EQ(0, publisher.snapshot().packets);
+
+	publisher.publish({10, 1500, 150.0});
+	const Stats stats = publisher.snapshot();
+	EXPECT_EQ(10, stats.packets);
+	EXPECT_EQ(1500, stats.bytes);
+	EXPECT_EQ(150.0, stats.bytesPerPacket);
+	EXPECT_EQ(2, publisher.version());
+
+	EXPECT_EQ(7, SnapshotPublisher<int>(7).snapshot());
+}
+
+/**
+ * @test Test that snapshots taken concurrently with publications are never torn.
+ */
+TEST(TelemetrySnapshotPublisher, concurrentSnapshots)
+{
+	constexpr unsigned readerCount = 4;
+	constexpr uint64_t publications = 100000;
+
+	SnapshotPublisher<Stats> publisher;
+	std::atomic<bool> done = false;
+	std::atomic<uint64_t> tornSnapshots = 0;
+
+	std::vector<std::thread> readers;
+	for (unsigned reader = 0; reader < readerCount; reader++) {
+		readers.emplace_back([&]() {
+			uint64_t lastPackets = 0;
+			while (!done.load()) {
+				const Stats stats = publisher.snapshot();
+				if (stats.bytes != stats.packets * 100 || stats.packets < lastPackets) {
+					tornSnapshots++;
+				}
+				lastPackets = stats.packets;
+			}
+		});
+	}
+
+	for (uint64_t packets = 1; packets <= publications; packets++) {
+		publisher.publish({packets, packets * 100, 100.0});
+	}
+	done = true;
+
+	for (auto& reader : readers) {
+		reader.join();
+	}
+
+	EXPECT_EQ(0, tornSnapshots.load());
+	EXPECT_EQ(publications, publisher.snapshot().packets);
+}
+
+/**
+ * @test Test that a file reads snapshots converted by the mapping.
+ */
+TEST(TelemetrySnapshotPublisher, file)
+{
+	auto root = Directory::create();
+	auto publisher = std::make_shared<SnapshotPublisher<Stats>>(Stats {2, 300, 150.0});
+
+	auto file = root->addFile("stats", snapshotFileOps(publisher, [](const Stats& stats) {
+		return Dict {
+			{"packets", Scalar {stats.packets}},
+			{"bytes", Scalar {stats.bytes}},
+		};
+	}));
+
+	const Dict expected {{"packets", Scalar {uint64_t {2}}}, {"bytes", Scalar {uint64_t {300}}}};
+	EXPECT_EQ(Content {expected}, file->read());
+
+	publisher->publish({3, 400, 133.0});
+	const Dict updated {{"packets", Scalar {uint64_t {3}}}, {"bytes", Scalar {uint64_t {400}}}};
+	EXPECT_EQ(Content {updated}, file->read());
+	EXPECT_FALSE(file->hasClear());
+
+	// The file keeps the publisher alive
+	publisher.reset();
+	EXPECT_EQ(Content {updated}, file->read());
+}
+
+} // namespace telemetry
@@ -0,0 +1,103 @@
+/**
+ * @file
+ * @author Pavel Siska <siska@cesnet.cz>
+ * @brief Unit tests of Telemetry::Symbol
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <sstream>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace telemetry {
+
+/**
+ * @test Test that symbols with the same text share the same string.
+ */
+TEST(TelemetrySymbol, interning)
+{
+	const std::string text = "cpu_usage";
+	const Symbol first(text);
+	const Symbol second("cpu_usage");
+	const Symbol third(std::string_view("cpu_usage_").substr(0, text.size()));
+
+	EXPECT_EQ(first, second);
+	EXPECT_EQ(first, third);
+	EXPECT_EQ(first.data(), second.data());
+	EXPECT_EQ(first.data(), third.data());
+	EXPECT_EQ(text, first.str());
+
+	const Symbol other("latency");
+	EXPECT_NE(first, other);
+	EXPECT_NE(first.data(), other.data());
+
+	EXPECT_TRUE(Symbol().empty());
+	EXPECT_EQ(Symbol(), Symbol(""));
+}
+
+/**
+ * @test Test that symbols are ordered and compared as strings.
+ */
+TEST(TelemetrySymbol, comparison)
+{
+	const Symbol symbolA("a");
+	const Symbol symbolB("b");
+
+	EXPECT_LT(symbolA, symbolB);
+	EXPECT_GT(symbolB, symbolA);
+	EXPECT_LT(Symbol(), symbolA);
+
+	EXPECT_EQ(symbolA, "a");
+	EXPECT_EQ("a", symbolA);
+	EXPECT_EQ(symbolA, std::string("a"));
+	EXPECT_EQ(std::string_view("a"), symbolA);
+	EXPECT_NE(symbolA, "b");
+	EXPECT_LT(symbolA, "b");
+	EXPECT_GT("b", symbolA);
+
+	const std::string text = symbolB;
+	EXPECT_EQ("b", text);
+
+	std::ostringstream stream;
+	stream << symbolA << symbolB;
+	EXPECT_EQ("ab", stream.str());
+
+	const std::unordered_set<Symbol> symbols {symbolA, Symbol("a"), symbolB};
+	EXPECT_EQ(2, symbols.size());
+}
+
+/**
+ * @test Test concurrent interning of the same strings.
+ */
+TEST(TelemetrySymbol, concurrentInterning)
+{
+	const size_t threadCount = 4;
+	const size_t symbolCount = 1000;
+	std::vector<std::vector<Symbol>> results(threadCount);
+	std::vector<std::thread> threads;
+
+	for (size_t idx = 0; idx < threadCount; idx++) {
+		threads.emplace_back([&result = results[idx]]() {
+			for (size_t symbolIdx = 0; symbolIdx < symbolCount; symbolIdx++) {
+				result.emplace_back("concurrent_" + std::to_string(symbolIdx));
+			}
+		});
+	}
+
+	for (auto& thread : threads) {
+		thread.join();
+	}
+
+	for (size_t idx = 1; idx < threadCount; idx++) {
+		EXPECT_EQ(results[0], results[idx]);
+		for (size_t symbolIdx = 0; symbolIdx < symbolCount; symbolIdx++) {
+			EXPECT_EQ(results[0][symbolIdx].data(), results[idx][symbolIdx].data());
+		}
+	}
+}
+
+} // namespace telemetry
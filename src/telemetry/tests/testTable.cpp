@@ -0,0 +1,136 @@
+/**
+ * @file
+ * @author Pavel Siska <siska@cesnet.cz>
+ * @brief Unit tests of the table content
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <telemetry/content.hpp>
+#include <telemetry/contentWriter.hpp>
+
+#include <string>
+
+#include <gtest/gtest.h>
+
+namespace telemetry {
+
+/**
+ * @test Test adding of columns and their validation.
+ */
+TEST(TelemetryTable, addColumn)
+{
+	Table table(3);
+
+	auto packets = table.addColumn<uint64_t>("packets");
+	EXPECT_EQ(3, packets.size());
+	packets[2] = 30;
+
+	table.addColumn("delay", TableColumn::Values<double> {0.5, 1.0, 1.5}, "ms");
+
+	EXPECT_THROW(table.addColumn<int64_t>("packets"), TelemetryException);
+	EXPECT_THROW(table.addColumn<int64_t>(""), TelemetryException);
+	EXPECT_THROW(table.addColumn("short", TableColumn::Values<int64_t> {1}), TelemetryException);
+
+	ASSERT_EQ(2, table.columns().size());
+	EXPECT_EQ(3, table.rowCount());
+
+	const TableColumn* column = table.findColumn("packets");
+	ASSERT_NE(nullptr, column);
+	EXPECT_EQ((TableColumn::Values<uint64_t> {0, 0, 30}), std::get<0>(column->data));
+	EXPECT_TRUE(column->unit.empty());
+
+	column = table.findColumn("delay");
+	ASSERT_NE(nullptr, column);
+	EXPECT_EQ("ms", column->unit);
+	EXPECT_EQ(nullptr, table.findColumn("missing"));
+
+	Table other(3);
+	other.addColumn("packets", TableColumn::Values<uint64_t> {0, 0, 30});
+	other.addColumn("delay", TableColumn::Values<double> {0.5, 1.0, 1.5}, "ms");
+	EXPECT_EQ(table, other);
+}
+
+/**
+ * @test Test the human readable representation of a table.
+ */
+TEST(TelemetryTable, toString)
+{
+	Table table(2);
+	table.addColumn("queue", TableColumn::Values<uint64_t> {0, 1});
+	table.addColumn("packets", TableColumn::Values<uint64_t> {10, 1234567890});
+	table.addColumn("delay", TableColumn::Values<double> {0.5, 12.25}, "ms");
+	table.addColumn("diff", TableColumn::Values<int64_t> {-1, 2});
+
+	const std::string expected
+		= "queue  packets     delay (ms)  diff\n"
+		  "0      10          0.50        -1\n"
+		  "1      1234567890  12.25       2";
+
+	EXPECT_EQ(expected, contentToString(table));
+
+	TextContentWriter writer;
+	writeContent(writer, table);
+	EXPECT_EQ(expected, writer.str());
+
+	EXPECT_EQ("", contentToString(Table(5)));
+	EXPECT_EQ("queue", contentToString([] {
+		Table empty;
+		empty.addColumn<uint64_t>("queue");
+		return empty;
+	}()));
+}
+
+/**
+ * @test Test the CSV representation of a table.
+ */
+TEST(TelemetryTable, toCsv)
+{
+	Table table(2);
+	table.addColumn("packets", TableColumn::Values<uint64_t> {10, 20});
+	table.addColumn("delay", TableColumn::Values<double> {0.1, 2.0}, "ms");
+	table.addColumn("a,b", TableColumn::Values<int64_t> {-1, 2});
+
+	EXPECT_EQ(
+		"packets,delay (ms),\"a,b\"\n"
+		"10,0.1,-1\n"
+		"20,2,2\n",
+		tableToCsv(table));
+
+	EXPECT_EQ("\n", tableToCsv(Table()));
+}
+
+/**
+ * @test Test that a table is built by the content builder and written by other writers
+ *   as a dictionary of columns.
+ */
+TEST(TelemetryTable, writer)
+{
+	Table table(2);
+	table.addColumn("packets", TableColumn::Values<uint64_t> {10, 20});
+	table.addColumn("delay", TableColumn::Values<double> {0.5, 1.0}, "ms");
+
+	ContentBuilder builder;
+	writeContent(builder, table);
+	EXPECT_EQ(Content {table}, builder.takeContent());
+
+	builder.beginDict();
+	EXPECT_THROW(builder.table(table), TelemetryException);
+
+	// Default implementation for writers without the support of tables
+	class DictBuilder : public ContentBuilder {
+	public:
+		void table(const Table& table) override { ContentWriter::table(table); }
+	};
+
+	DictBuilder dictBuilder;
+	writeContent(dictBuilder, table);
+
+	const Content expected = Dict {
+		{"packets", Array {Scalar {uint64_t {10}}, Scalar {uint64_t {20}}}},
+		{"delay", Array {Scalar {0.5}, Scalar {1.0}}},
+	};
+	EXPECT_EQ(expected, dictBuilder.takeContent());
+}
+
+} // namespace telemetry
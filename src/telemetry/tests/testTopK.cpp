@@ -0,0 +1,207 @@
+/**
+ * @file
+ * @author Pavel Siska <siska@cesnet.cz>
+ * @brief Unit tests of the top-K summary content
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <telemetry/content.hpp>
+#include <telemetry/contentWriter.hpp>
+
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace telemetry {
+
+/**
+ * @test Test recording of keys and replacement of the key with the lowest count.
+ */
+TEST(TelemetryTopK, record)
+{
+	TopK topK(3);
+	EXPECT_EQ(0, topK.minCount());
+	EXPECT_THROW(TopK(0), TelemetryException);
+
+	topK.record("a", 5);
+	topK.record("b");
+	topK.record("c", 2);
+	topK.record("b", 2);
+	topK.record("x", 0);
+
+	const TopK::Items expected {{"a", 5, 0}, {"b", 3, 0}, {"c", 2, 0}};
+	EXPECT_EQ(expected, topK.items());
+	EXPECT_EQ(10, topK.count());
+	EXPECT_EQ(2, topK.minCount());
+
+	// "d" replaces "c" and inherits its count as the error
+	topK.record("d");
+	const TopK::Items replaced {{"a", 5, 0}, {"b", 3, 0}, {"d", 3, 2}};
+	EXPECT_EQ(replaced, topK.items());
+	EXPECT_EQ(11, topK.count());
+
+	// Keys with the same count are sorted by the key, the last one is replaced
+	topK.record("e");
+	const TopK::Items sameCounts {{"a", 5, 0}, {"e", 4, 3}, {"b", 3, 0}};
+	EXPECT_EQ(sameCounts, topK.items());
+}
+
+/**
+ * @test Test that heavy hitters of a skewed stream are found with bounded errors.
+ */
+TEST(TelemetryTopK, heavyHitters)
+{
+	TopK topK(20);
+
+	// Keys "0" to "4" occur 1000, 900, ... times, each of 5000 other keys occurs once, so all
+	// of them occur more than count() / capacity() times
+	for (int round = 0; round < 1000; round++) {
+		for (int key = 0; key < 5; key++) {
+			if (round < 1000 - key * 100) {
+				topK.record(std::to_string(key));
+			}
+			topK.record("noise" + std::to_string(round * 5 + key));
+		}
+	}
+
+	ASSERT_EQ(20, topK.items().size());
+	EXPECT_EQ(9000, topK.count());
+
+	for (int key = 0; key < 5; key++) {
+		const auto it = std::find_if(
+			topK.items().begin(),
+			topK.items().end(),
+			[&](const TopK::Item& item) { return item.key == std::to_string(key); });
+		ASSERT_NE(topK.items().end(), it);
+
+		const auto exact = static_cast<uint64_t>(1000 - key * 100);
+		EXPECT_GE(it->count, exact);
+		EXPECT_LE(it->count - it->error, exact);
+		EXPECT_LE(it->error, topK.count() / topK.capacity());
+	}
+}
+
+/**
+ * @test Test merging of summaries.
+ */
+TEST(TelemetryTopK, merge)
+{
+	TopK first(3);
+	first.record("a", 10);
+	first.record("b", 5);
+	first.record("c", 1);
+
+	TopK second(3);
+	second.record("b", 7);
+	second.record("d", 4);
+
+	// Keys not monitored by the full first summary might have occurred once there
+	first.merge(second);
+	const TopK::Items expected {{"b", 12, 0}, {"a", 10, 0}, {"d", 5, 1}};
+	EXPECT_EQ(expected, first.items());
+	EXPECT_EQ(27, first.count());
+
+	TopK empty(3);
+	empty.merge(second);
+	EXPECT_EQ(second, empty);
+
+	EXPECT_THROW(first.merge(TopK(4)), TelemetryException);
+}
+
+/**
+ * @test Test creation of a summary from its parts and validation of the parts.
+ */
+TEST(TelemetryTopK, fromParts)
+{
+	TopK topK(3);
+	topK.record("a", 2);
+	topK.record("b");
+
+	EXPECT_EQ(topK, TopK::fromParts(3, topK.items(), 3));
+	EXPECT_EQ(TopK(5), TopK::fromParts(5, {}, 0));
+
+	EXPECT_THROW(TopK::fromParts(0, {}, 0), TelemetryException);
+	EXPECT_THROW(TopK::fromParts(1, {{"a", 2, 0}, {"b", 1, 0}}, 3), TelemetryException);
+	// Not sorted, duplicate keys and invalid counts
+	EXPECT_THROW(TopK::fromParts(3, {{"b", 1, 0}, {"a", 2, 0}}, 3), TelemetryException);
+	EXPECT_THROW(TopK::fromParts(3, {{"a", 1, 0}, {"a", 1, 0}}, 2), TelemetryException);
+	EXPECT_THROW(TopK::fromParts(3, {{"a", 2, 0}, {"a", 1, 0}}, 3), TelemetryException);
+	EXPECT_THROW(TopK::fromParts(3, {{"a", 0, 0}}, 0), TelemetryException);
+	EXPECT_THROW(TopK::fromParts(3, {{"a", 1, 2}}, 1), TelemetryException);
+	EXPECT_THROW(TopK::fromParts(3, {{"a", 2, 0}}, 1), TelemetryException);
+}
+
+/**
+ * @test Test that a recorder records the same summary as TopK from several threads.
+ */
+TEST(TelemetryTopK, recorder)
+{
+	TopKRecorder recorder(4);
+	TopK expected(4);
+
+	for (const auto& [key, count] : std::vector<std::pair<std::string, uint64_t>> {
+			 {"a", 5},
+			 {"b", 1},
+			 {"c", 2},
+			 {"d", 2},
+			 {"e", 1},
+			 {"b", 3},
+			 {"f", 1},
+		 }) {
+		recorder.record(key, count);
+		expected.record(key, count);
+	}
+	EXPECT_EQ(expected, recorder.snapshot());
+	EXPECT_THROW(TopKRecorder(0), TelemetryException);
+
+	recorder.reset();
+	EXPECT_EQ(TopK(4), recorder.snapshot());
+
+	constexpr unsigned threadCount = 4;
+	std::vector<std::thread> threads;
+	for (unsigned thread = 0; thread < threadCount; thread++) {
+		threads.emplace_back([&recorder]() {
+			for (int value = 0; value < 1000; value++) {
+				recorder.record("heavy", 2);
+				recorder.record(std::to_string(value));
+			}
+		});
+	}
+	for (auto& thread : threads) {
+		thread.join();
+	}
+
+	const TopK snapshot = recorder.snapshot();
+	EXPECT_EQ(threadCount * 3000, snapshot.count());
+	EXPECT_EQ("heavy", snapshot.items().front().key);
+	EXPECT_EQ(threadCount * 2000, snapshot.items().front().count);
+}
+
+/**
+ * @test Test that a summary is built by the content builder and written by other writers
+ *   as a dictionary of counts.
+ */
+TEST(TelemetryTopK, writer)
+{
+	TopK topK;
+	topK.record("10.0.0.1", 500);
+	topK.record("10.0.0.2", 30);
+
+	ContentBuilder builder;
+	writeContent(builder, topK);
+	EXPECT_EQ(Content {topK}, builder.takeContent());
+
+	builder.beginArray();
+	EXPECT_THROW(builder.topK(topK), TelemetryException);
+
+	EXPECT_EQ(
+		"10.0.0.1: 500\n"
+		"10.0.0.2: 30",
+		contentToString(topK));
+}
+
+} // namespace telemetry
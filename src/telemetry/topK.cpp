@@ -0,0 +1,234 @@
+/**
+ * @file
+ * @author Pavel Siska <siska@cesnet.cz>
+ * @brief Mergeable summary of the most frequent keys (heavy hitters)
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <telemetry/node.hpp>
+#include <telemetry/topK.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+namespace telemetry {
+
+// Order of items in the summary, the last item is replaced by a key that isn't monitored
+static bool precedes(const TopK::Item& first, const TopK::Item& second) noexcept
+{
+	if (first.count != second.count) {
+		return first.count > second.count;
+	}
+	return first.key < second.key;
+}
+
+static void checkCapacity(size_t capacity)
+{
+	if (capacity == 0) {
+		throw TelemetryException("TopK: capacity must be greater than zero");
+	}
+}
+
+TopK::TopK(size_t capacity)
+	: m_capacity(capacity)
+{
+	checkCapacity(capacity);
+}
+
+TopK TopK::fromParts(size_t capacity, Items items, uint64_t count)
+{
+	TopK topK(capacity);
+
+	if (items.size() > capacity) {
+		throw TelemetryException("TopK: more items than the capacity");
+	}
+
+	std::unordered_set<std::string_view> keys;
+	uint64_t lowerBoundSum = 0;
+	for (size_t idx = 0; idx < items.size(); idx++) {
+		const Item& item = items[idx];
+		if (item.count == 0 || item.error > item.count) {
+			throw TelemetryException("TopK: invalid count of an item");
+		}
+		if (idx > 0 && !precedes(items[idx - 1], item)) {
+			throw TelemetryException("TopK: items are not sorted");
+		}
+		if (!keys.insert(item.key).second) {
+			throw TelemetryException("TopK: duplicate key");
+		}
+
+		const uint64_t lowerBound = item.count - item.error;
+		if (lowerBoundSum + lowerBound < lowerBoundSum || lowerBoundSum + lowerBound > count) {
+			throw TelemetryException("TopK: counts of items exceed the total count");
+		}
+		lowerBoundSum += lowerBound;
+	}
+
+	topK.m_items = std::move(items);
+	topK.m_count = count;
+	return topK;
+}
+
+void TopK::insert(Item item)
+{
+	const auto pos = std::lower_bound(m_items.begin(), m_items.end(), item, precedes);
+	m_items.insert(pos, std::move(item));
+}
+
+void TopK::record(std::string_view key, uint64_t count)
+{
+	if (count == 0) {
+		return;
+	}
+
+	m_count += count;
+
+	const auto it = std::find_if(m_items.begin(), m_items.end(), [&](const Item& item) {
+		return item.key == key;
+	});
+
+	if (it != m_items.end()) {
+		Item item = std::move(*it);
+		m_items.erase(it);
+		item.count += count;
+		insert(std::move(item));
+	} else if (m_items.size() < m_capacity) {
+		insert({std::string(key), count, 0});
+	} else {
+		Item item = std::move(m_items.back());
+		m_items.pop_back();
+		item.key = key;
+		item.error = item.count;
+		item.count += count;
+		insert(std::move(item));
+	}
+}
+
+void TopK::merge(const TopK& other)
+{
+	if (other.m_capacity != m_capacity) {
+		throw TelemetryException("TopK: summaries of different capacity");
+	}
+
+	const uint64_t minCount = this->minCount();
+	const uint64_t otherMinCount = other.minCount();
+
+	// Monitored keys of the other summary that aren't monitored by this summary
+	std::unordered_map<std::string_view, const Item*> otherItems;
+	for (const Item& item : other.m_items) {
+		otherItems.emplace(item.key, &item);
+	}
+
+	Items items;
+	items.reserve(m_items.size() + other.m_items.size());
+
+	for (const Item& item : m_items) {
+		const auto it = otherItems.find(item.key);
+		if (it != otherItems.end()) {
+			const Item& otherItem = *it->second;
+			items.push_back({item.key, item.count + otherItem.count, item.error + otherItem.error});
+			otherItems.erase(it);
+		} else {
+			items.push_back({item.key, item.count + otherMinCount, item.error + otherMinCount});
+		}
+	}
+
+	for (const Item& item : other.m_items) {
+		if (otherItems.contains(item.key)) {
+			items.push_back({item.key, item.count + minCount, item.error + minCount});
+		}
+	}
+
+	std::sort(items.begin(), items.end(), precedes);
+	if (items.size() > m_capacity) {
+		items.erase(items.begin() + static_cast<std::ptrdiff_t>(m_capacity), items.end());
+	}
+
+	m_items = std::move(items);
+	m_count += other.m_count;
+}
+
+uint64_t TopK::minCount() const noexcept
+{
+	return m_items.size() < m_capacity ? 0 : m_items.back().count;
+}
+
+TopKRecorder::TopKRecorder(size_t capacity)
+	: m_capacity(capacity)
+{
+	checkCapacity(capacity);
+	m_counters.reserve(capacity);
+}
+
+void TopKRecorder::record(std::string_view key, uint64_t count)
+{
+	if (count == 0) {
+		return;
+	}
+
+	const std::lock_guard lock(m_mutex);
+
+	m_count += count;
+
+	if (const auto it = m_counters.find(key); it != m_counters.end()) {
+		it->second.count += count;
+		return;
+	}
+
+	if (m_counters.size() < m_capacity) {
+		m_counters.emplace(key, Counter {count, 0});
+		return;
+	}
+
+	// Replace the key that would be the last item of the summary
+	auto minIt = m_counters.begin();
+	for (auto it = m_counters.begin(); it != m_counters.end(); ++it) {
+		const auto& [itKey, counter] = *it;
+		if (counter.count < minIt->second.count
+			|| (counter.count == minIt->second.count && itKey > minIt->first)) {
+			minIt = it;
+		}
+	}
+
+	// The node of the replaced key is reused to avoid allocations
+	auto node = m_counters.extract(minIt);
+	node.key() = key;
+	node.mapped().error = node.mapped().count;
+	node.mapped().count += count;
+	m_counters.insert(std::move(node));
+}
+
+TopK TopKRecorder::snapshot() const
+{
+	TopK::Items items;
+	uint64_t count;
+
+	{
+		const std::lock_guard lock(m_mutex);
+		items.reserve(m_counters.size());
+		for (const auto& [key, counter] : m_counters) {
+			items.push_back({key, counter.count, counter.error});
+		}
+		count = m_count;
+	}
+
+	std::sort(items.begin(), items.end(), precedes);
+	return TopK::fromParts(m_capacity, std::move(items), count);
+}
+
+void TopKRecorder::reset()
+{
+	const std::lock_guard lock(m_mutex);
+	m_counters.clear();
+	m_count = 0;
+}
+
+} // namespace telemetry
+
+#ifdef TELEMETRY_ENABLE_TESTS
+#include "tests/testTopK.cpp"
+#endif